@@ -3,9 +3,25 @@ TEMPLATE = subdirs
 
 SUBDIRS += \
     src \
-    tests
+    tests \
+    tests_weatherservice \
+    tests_benchmarks \
+    tests_statsbenchmark \
+    tests_chartbenchmark \
+    tests_ui
+
+tests_weatherservice.subdir = tests/weatherservice
+tests_benchmarks.subdir = tests/benchmarks
+tests_statsbenchmark.subdir = tests/statsbenchmark
+tests_chartbenchmark.subdir = tests/chartbenchmark
+tests_ui.subdir = tests/ui
 
 # Les tests dépendent du code source
 tests.depends = src
+tests_weatherservice.depends = src
+tests_benchmarks.depends = src
+tests_statsbenchmark.depends = src
+tests_chartbenchmark.depends = src
+tests_ui.depends = src
 
 CONFIG += ordered
@@ -1,10 +1,25 @@
 #ifndef ICACHEMANAGER_H
 #define ICACHEMANAGER_H
 #include "WeatherData.h"
+#include "citykey.h"
 #include <QObject>
 #include <qstring.h>
 #include <Qlist>
 #include <QMap>
+#include <QHash>
+#include <QRectF>
+
+/**
+ * Conservation de la réponse API brute à côté des structures parsées
+ * - Discard  : seule la structure parsée est gardée
+ * - Original : les octets reçus sont gardés tels quels (aucune copie)
+ * - Compact  : le JSON est recompacté avant stockage
+ */
+enum class RawPayloadMode {
+    Discard,
+    Original,
+    Compact
+};
 
 class ICacheManager
 {
@@ -13,12 +28,58 @@ public:
 
     virtual void signalCacheCleared() = 0;
     virtual int cleanExpiredCache() = 0;
+    // Vide le cache, retourne le nombre d'entrées supprimées
+    virtual int clear() = 0;
     //virtual bool isValid(const QString& cityName, const QString& dataType) const = 0;
 
-    virtual void storeCachedWeather(const QString& cityName, const CurrentWeatherData& data) = 0;
-    virtual void storeCachedForecast(const QString& cityName, const ForecastData& data) = 0;
-    virtual CurrentWeatherData getCityweatherInCache(const QString& cityName) const = 0;
-    virtual bool isValid(const QString& cityName, const QString& dataType) const = 0;
+    // Toutes les entrées sont indexées par clé canonique (hash calculé une fois)
+    // La poignée stockée est celle émise aux abonnés : une seule instance par réponse
+    virtual void storeCachedWeather(const CityKey& key, CurrentWeatherPtr data,
+                                    const QByteArray& rawPayload = QByteArray()) = 0;
+    virtual void storeCachedForecast(const CityKey& key, ForecastPtr data,
+                                     const QByteArray& rawPayload = QByteArray()) = 0;
+    void storeCachedWeather(const CityKey& key, const CurrentWeatherData& data,
+                            const QByteArray& rawPayload = QByteArray())
+    {
+        storeCachedWeather(key, std::make_shared<const CurrentWeatherData>(data), rawPayload);
+    }
+    void storeCachedForecast(const CityKey& key, const ForecastData& data,
+                             const QByteArray& rawPayload = QByteArray())
+    {
+        storeCachedForecast(key, std::make_shared<const ForecastData>(data), rawPayload);
+    }
+    // Une seule recherche : poignée partagée si l'entrée existe et est valide, nullptr sinon
+    virtual CurrentWeatherPtr tryGetWeather(const CityKey& key) const = 0;
+    virtual ForecastPtr tryGetForecast(const CityKey& key) const = 0;
+    // Poignée même expirée (affichage de données anciennes), nullptr si absente
+    virtual CurrentWeatherPtr peekWeather(const CityKey& key) const = 0;
+
+    // Villes présentes (météo ou prévisions, valides ou non), sans doublon
+    virtual QList<CityKey> cachedKeys() const = 0;
+
+    // Index spatial des villes en météo actuelle (valides ou non)
+    // Zone : x = longitude, y = latitude ; plus proches : triées par distance
+    virtual QList<CityKey> citiesInArea(const QRectF& bounds) const = 0;
+    virtual QList<CityKey> nearestCities(double latitude, double longitude, int count,
+                                         double maxDistanceKm = -1.0) const = 0;
+
+    virtual CurrentWeatherData getCityweatherInCache(const CityKey& key) const = 0;
+    // Une seule recherche ; copie les créneaux (préférer tryGetForecast pour partager)
+    virtual ForecastData getCityForecastInCache(const CityKey& key) const = 0;
+    virtual bool isValid(const CityKey& key, WeatherDataType dataType) const = 0;
+
+    // Grandeurs dérivées mémorisées avec l'entrée (nullptr si absente ou expirée)
+    virtual DerivedMetricsPtr derivedMetrics(const CityKey& key) const = 0;
+    virtual ForecastMetricsPtr derivedForecastMetrics(const CityKey& key) const = 0;
+    // Plusieurs villes : les valeurs manquantes sont calculées en un seul passage
+    virtual QHash<CityKey, DerivedMetricsPtr> derivedMetrics(const QList<CityKey>& keys) const = 0;
+
+    // Date de mise en cache et validité (cachedAt invalide si absente)
+    virtual CacheInfo getCacheInfo(const CityKey& key, WeatherDataType dataType) const = 0;
+
+    // Réponse brute pour ré-émission sans re-sérialisation (vide si non conservée)
+    virtual QByteArray getRawWeatherPayload(const CityKey& key) const = 0;
+    virtual QByteArray getRawForecastPayload(const CityKey& key) const = 0;
 
 };
 #endif // ICACHEMANAGER_H
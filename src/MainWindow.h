@@ -9,15 +9,24 @@
 #include <QLabel>
 #include <QTextEdit>
 #include <QTabWidget>
-#include <QListWidget>
+#include <QListView>
 #include <QPushButton>
 #include <QProgressBar>
 #include <QGroupBox>
 #include <QGridLayout>
 #include <QStatusBar>
+#include <QCompleter>
+#include <QStringListModel>
+#include <QTimer>
+#include <QFutureWatcher>
 #include "WeatherService.h"
 #include "WeatherChartWidget.h"
 #include "simplemapwidget.h"
+#include "SearchHistory.h"
+#include "weatherprefetcher.h"
+#include "logpanel.h"
+#include "searchhistorymodel.h"
+#include "dashboardwidget.h"
 
 
 class MainWindow : public QMainWindow
@@ -33,19 +42,25 @@ private slots:
     void onSearchButtonClicked();
     void onClearCacheClicked();
     void onCityInputReturnPressed();
+    void onCityInputEdited(const QString& text);
 
     // Réception des données WeatherService
-    void onCurrentWeatherReady(const QString& cityName, const CurrentWeatherData& data);
-    void onForecastReady(const QString& cityName, const ForecastData& data);
+    void onCurrentWeatherReady(const QString& cityName, CurrentWeatherPtr data);
+    void onForecastReady(const QString& cityName, ForecastPtr data);
     void onLoadingStarted(const QString& cityName, const QString& requestType);
     void onErrorOccurred(const QString& cityName, const QString& errorMessage, const QString& errorType);
     void onCacheUpdated(const QString& cityName, const QString& dataType);
+    void onBackgroundRefreshCompleted(const QString& cityName, const QString& dataType);
+    void onDashboardVisibleCitiesChanged(const QStringList& cityNames);
+    void onGazetteerReady();
+    void publishVisibleHistoryCities();
 
 private:
     // Interface utilisateur
     void setupUI();
     void setupConnections();
     void setupStatusBar();
+    void setupCompleter();
 
     // Affichage des données
     void displayCurrentWeather(const CurrentWeatherData& data);
@@ -53,11 +68,14 @@ private:
     void showLoadingState(const QString& cityName, const QString& requestType);
     void showErrorState(const QString& message);
     void resetDisplay();
+    void setTemperatureBand(const char* band);
 
     // Utilitaires UI
     QString formatTemperature(double temp) const;
     QString formatWindSpeed(double speed) const;
     QString formatTime(const QDateTime& dateTime) const;
+    // "48.85, 2.35" → position ; faux pour un nom de ville
+    static bool parseCoordinates(const QString& text, double* latitude, double* longitude);
 
     // Méthodes de configuration UI
     void setupLeftPanel();
@@ -68,13 +86,16 @@ private:
     void setupChartSection();
     void setupStatusSection();
     void setupHistorySection();
+    void setupHistoryConnections();
     void setupMapSection();
+    void setupDashboard();
 
     // Méthodes utilitaires UI
     void createWeatherLabels();
     void arrangeWeatherLabels();
 
     // Widgets principaux
+    QTabWidget* m_mainTabWidget;
     QWidget* m_centralWidget;
     QVBoxLayout* m_mainLeftLayout;
     QVBoxLayout* m_mainRightLayout;
@@ -84,6 +105,8 @@ private:
     QHBoxLayout* m_searchLayout;
     QLineEdit* m_cityInput;
     QPushButton* m_clearCacheButton, * m_searchButton, *m_clearHistoryButton;
+    QCompleter* m_cityCompleter;
+    QStringListModel* m_suggestionModel;
 
     // Section météo actuelle
     QGroupBox* m_currentWeatherGroup;
@@ -109,7 +132,7 @@ private:
 
     // section Favoris
     QTabWidget* m_historyTabWidget;
-    QListWidget* m_recentSearchList, *m_favoritesSearchList;
+    QListView* m_recentSearchList, *m_favoritesSearchList;
     QPushButton* m_addFavoriteButton, *m_removeFavoriteButton;
     QLabel* m_recentStatsLabel, *m_favoritesStatsLabel;
 
@@ -118,12 +141,22 @@ private:
     QGroupBox* m_statusGroup;
     QVBoxLayout* m_statusLayout;
     QProgressBar* m_loadingBar;
-    QTextEdit* m_logDisplay;
+    LogPanel* m_logDisplay;
 
     // Service météo
     WeatherService* m_weatherService;
+    // Historique et préchargement
+    SearchHistory* m_searchHistory;
+    WeatherPrefetcher* m_prefetcher;
+    SearchHistoryModel* m_recentModel;
+    SearchHistoryModel* m_favoritesModel;
+    QTimer* m_visibleHistoryTimer;        // Villes visibles des listes, une fois par rafale
+    QFutureWatcher<QStringList>* m_gazetteerWatcher; // Génération/lecture du gazetteer en tâche de fond
     // chart
     WeatherChartWidget* m_chartWidget;
+    SimpleMapWidget* m_mapWidget;
+    // Tableau de bord multi-villes
+    DashboardWidget* m_dashboard;
 
     // État
     QString m_currentCity;
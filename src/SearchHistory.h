@@ -13,6 +13,11 @@
 #include <QDir>
 #include <QTimer>
 #include <QMap>
+#include <QList>
+
+class CityTrie;
+class HistoryJournal;
+class QThread;
 
 /**
  * Structure pour une entrée d'historique
@@ -23,6 +28,7 @@ struct SearchHistoryEntry {
     int searchCount;           // Nombre de fois recherchée
     QDateTime lastAccess;      // Dernier accès
     bool isFavorite;          // Marquée comme favorite
+    QList<int> hourlyCounts;   // Recherches par heure locale (24 cases, vide si aucune)
 
     SearchHistoryEntry()
         : searchCount(1), isFavorite(false)
@@ -38,6 +44,18 @@ struct SearchHistoryEntry {
         lastAccess = searchTime;
     }
 
+    // Comptabilise une recherche dans l'histogramme horaire
+    void recordHour(const QDateTime& when) {
+        if (hourlyCounts.size() != 24) {
+            hourlyCounts = QList<int>(24, 0);
+        }
+        hourlyCounts[when.time().hour()]++;
+    }
+
+    int searchesAtHour(int hour) const {
+        return hourlyCounts.size() == 24 ? hourlyCounts[hour] : 0;
+    }
+
     // Pour le tri par fréquence/récence
     bool operator<(const SearchHistoryEntry& other) const {
         // Priorité aux favoris
@@ -53,13 +71,30 @@ struct SearchHistoryEntry {
     }
 };
 
+/**
+ * Modification élémentaire de l'historique (une entrée du journal)
+ */
+struct HistoryMutation {
+    enum Type : quint8 {
+        Search = 1,         // Recherche d'une ville
+        Remove = 2,         // Suppression d'une ville
+        Clear = 3,          // Historique vidé
+        Favorite = 4        // Favori ajouté/retiré
+    };
+
+    Type type = Search;
+    QString cityName;
+    QDateTime time;
+    bool favorite = false;
+};
+
 /**
  * Gestionnaire d'historique des recherches
  *
  * Fonctionnalités :
  * - Sauvegarde automatique des recherches
  * - Tri intelligent (favoris > fréquence > récence)
- * - Persistance sur disque
+ * - Persistance sur disque (journal binaire + snapshot, thread dédié)
  * - Suggestions de villes
  * - Gestion des favoris
  */
@@ -81,6 +116,10 @@ public:
     QStringList getFrequentSearches(int maxCount = 5) const;
     QStringList getFavorites() const;
     QStringList getSuggestions(const QString& prefix, int maxCount = 5) const;
+    QStringList getSearchesForHour(int hour, int maxCount = 5) const;
+
+    // Dictionnaire de suggestions (ex: gazetteer), classé après l'historique
+    void addSuggestionName(const QString& cityName, qint64 weight = 0);
 
     // Gestion des favoris
     void addToFavorites(const QString& cityName);
@@ -92,6 +131,8 @@ public:
     int getTotalSearches() const;
     int getSearchCount(const QString& cityName) const;
     QDateTime getLastSearchTime(const QString& cityName) const;
+    // Entrée complète (une seule recherche), entrée vide si absente
+    SearchHistoryEntry getEntry(const QString& cityName) const;
 
     // Configuration
     void setMaxHistorySize(int maxSize);
@@ -101,6 +142,11 @@ signals:
     void historyChanged();
     void favoriteChanged(const QString& cityName, bool isFavorite);
 
+    // Modifications détaillées (vues incrémentales) ; cityName = nom enregistré de l'entrée
+    void searchRecorded(const QString& cityName);    // Nouvelle entrée ou recherche répétée
+    void searchRemoved(const QString& cityName);     // Suppression ou éviction
+    void historyCleared();
+
 private slots:
     void saveToFile();
 
@@ -108,17 +154,33 @@ private:
 
     QMap<QString, SearchHistoryEntry> m_entries;
     int m_maxHistorySize;
-    QString m_historyFilePath;
+    QString m_historyFilePath;  // Ancien format JSON (migration uniquement)
+    QString m_snapshotPath;
+    QString m_logPath;
     QTimer* m_saveTimer;  // Sauvegarde différée
+    CityTrie* m_trie;     // Index des suggestions (top-k par nœud)
+
+    // Journal : modifications en attente, écrites par lots dans un thread dédié
+    QList<HistoryMutation> m_pendingMutations;
+    int m_logRecordCount;       // Enregistrements depuis le dernier compactage
+    bool m_compactionPending;
+    QThread* m_journalThread;
+    HistoryJournal* m_journal;
+
+    // Modifications
+    void applyMutation(const HistoryMutation& mutation);
+    void recordMutation(const HistoryMutation& mutation);
 
     // Persistance
-    void loadFromFile();
+    quint64 loadFromFile();     // Génération du snapshot lu (reprise par le journal)
+    bool loadLegacyFile();
+    void flushJournal(bool blocking);
     QString getHistoryFilePath() const;
-    QJsonObject serializeEntry(const SearchHistoryEntry& entry) const;
     SearchHistoryEntry deserializeEntry(const QJsonObject& json) const;
 
     // Utilitaires
-    void cleanupOldEntries();
+    // keptKey : recherche qui vient d'être ajoutée, jamais évincée par elle-même
+    void cleanupOldEntries(const QString& keptKey = QString());
     QString normalizeCityName(const QString& cityName) const;
 };
 
@@ -2,10 +2,16 @@
 #define WEATHERDATA_H
 
 #include <QString>
+#include <QByteArray>
 #include <QDateTime>
 #include <QList>
+#include <QVarLengthArray>
 #include <QMetaType>
 #include <Qmap>
+#include <memory>
+#include <algorithm>
+#include "inlinelist.h"
+#include "derivedmetrics.h"
 /**
  * Structure pour les données météorologiques actuelles
  * Correspond à la réponse de l'API /weather
@@ -62,6 +68,13 @@ struct CurrentWeatherData {
     int ageInMinutes() const {
         return QDateTime::currentDateTime().secsTo(timestamp) / 60;
     }
+
+    // Méthode utilitaire - Empreinte mémoire approximative (octets)
+    qint64 memoryFootprint() const {
+        return sizeof(CurrentWeatherData)
+               + (cityName.capacity() + countryCode.capacity() + mainCondition.capacity()
+                  + description.capacity() + iconCode.capacity()) * sizeof(QChar);
+    }
 };
 
 /**
@@ -95,8 +108,26 @@ struct ForecastEntry {
         : temperature(0.0), feelsLike(0.0), humidity(0.0), pressure(0.0)
         , conditionId(0), windSpeed(0.0), windDirection(0), windGust(0.0)
         , cloudiness(0), precipitationProbability(0.0) {}
+
+    // Empreinte mémoire approximative (octets)
+    qint64 memoryFootprint() const {
+        return sizeof(ForecastEntry) + stringFootprint();
+    }
+
+    // Part allouée hors de la structure (chaînes)
+    qint64 stringFootprint() const {
+        return (mainCondition.capacity() + description.capacity() + iconCode.capacity()) * sizeof(QChar);
+    }
 };
 
+/**
+ * Créneaux d'une prévision : l'API 5 jours / 3 h en renvoie au plus 40,
+ * stockés directement dans ForecastData (une seule allocation avec make_shared).
+ * Une réponse plus longue bascule sur un bloc réservé à la bonne taille.
+ */
+constexpr int FORECAST_INLINE_ENTRIES = 40;
+using ForecastEntryList = InlineList<ForecastEntry, FORECAST_INLINE_ENTRIES>;
+
 /**
  * Structure pour les prévisions complètes 5 jours
  * Correspond à la réponse de l'API /forecast
@@ -106,11 +137,26 @@ struct ForecastData {
     double latitude;            // Position pour cohérence
     double longitude;
 
-    QList<ForecastEntry> entries;  // 40 créneaux (8 par jour × 5 jours)
+    // Résumé d'un jour calendaire local de la ville
+    struct DailySummary {
+        QDate date;                 // Jour local de la ville
+        int firstIndex = 0;         // Créneaux du jour : entries[firstIndex, firstIndex + count)
+        int count = 0;
+        double minTemp = 0.0;
+        double maxTemp = 0.0;
+        double meanTemp = 0.0;
+        double maxPrecipitationProbability = 0.0; // Probabilité de pluie la plus haute (0-100%)
+        QString dominantCondition;  // La plus fréquente (la plus proche de midi en cas d'égalité)
+        QString iconCode;
+    };
+
+    ForecastEntryList entries;     // 40 créneaux (8 par jour × 5 jours)
+    int timezoneOffset;            // Décalage UTC de la ville en secondes
+    QList<DailySummary> dailySummaries; // Calculés une fois au parsing (updateDailySummaries)
     QDateTime retrievedAt;         // Moment de récupération
 
     // Constructeur par défaut
-    ForecastData() : latitude(0.0), longitude(0.0) {}
+    ForecastData() : latitude(0.0), longitude(0.0), timezoneOffset(0) {}
 
     // Méthodes utilitaires
     bool isValid() const {
@@ -125,64 +171,174 @@ struct ForecastData {
         return QDateTime::currentDateTime().secsTo(retrievedAt) / 60;
     }
 
-    // Obtenir les prévisions d'un jour spécifique (0-4)
+    // Empreinte mémoire approximative (octets)
+    qint64 memoryFootprint() const {
+        qint64 size = fixedFootprint();
+        forEachDistinctLabel([&size](const QString& label) { size += label.capacity() * sizeof(QChar); });
+        return size;
+    }
+
+    // Empreinte hors libellés des créneaux (propre à cette prévision)
+    qint64 fixedFootprint() const {
+        // Les créneaux intégrés sont déjà comptés dans sizeof(ForecastData)
+        return sizeof(ForecastData) + cityName.capacity() * sizeof(QChar) + entries.heapBytes()
+               + dailySummaries.capacity() * sizeof(DailySummary);
+    }
+
+    /**
+     * Libellés des créneaux, chaque tampon une seule fois : internés au parsing,
+     * ils sont partagés entre créneaux (et entre villes d'un même lot)
+     */
+    template <typename Visitor>
+    void forEachDistinctLabel(Visitor visit) const {
+        QVarLengthArray<const QChar*, 32> seen;
+        auto visitOnce = [&](const QString& label) {
+            if (label.capacity() == 0) return;
+            if (std::find(seen.cbegin(), seen.cend(), label.constData()) != seen.cend()) return;
+            seen.append(label.constData());
+            visit(label);
+        };
+        for (const ForecastEntry& entry : entries) {
+            visitOnce(entry.mainCondition);
+            visitOnce(entry.description);
+            visitOnce(entry.iconCode);
+        }
+    }
+
+    // Créneaux d'un jour local (0 = aujourd'hui, souvent partiel), copiés
     QList<ForecastEntry> getEntriesForDay(int dayIndex) const {
         QList<ForecastEntry> dayEntries;
-        int startIndex = dayIndex * 8;  // 8 créneaux par jour
-        int endIndex = qMin(startIndex + 8, entries.size());
+        const QList<DailySummary> days = getDailySummaries();
+        if (dayIndex < 0 || dayIndex >= days.size()) return dayEntries;
 
-        for (int i = startIndex; i < endIndex; ++i) {
+        const DailySummary& day = days[dayIndex];
+        dayEntries.reserve(day.count);
+        for (int i = day.firstIndex; i < day.firstIndex + day.count; ++i) {
             dayEntries.append(entries[i]);
         }
         return dayEntries;
     }
 
-    // Résumé quotidien (min/max température du jour)
-    struct DailySummary {
-        QDate date;
-        double minTemp;
-        double maxTemp;
-        QString dominantCondition;
-        QString iconCode;
-    };
-
+    // Résumés calculés au parsing, sinon calculés à la demande (sans mise en cache)
     QList<DailySummary> getDailySummaries() const {
-        QList<DailySummary> summaries;
-
-        for (int day = 0; day < 5; ++day) {
-            auto dayEntries = getEntriesForDay(day);
-            if (dayEntries.isEmpty()) continue;
+        if (!dailySummaries.isEmpty() || entries.isEmpty()) {
+            return dailySummaries;
+        }
+        return computeDailySummaries(entries, timezoneOffset);
+    }
 
-            DailySummary summary;
-            summary.date = dayEntries.first().dateTime.date();
+    // À appeler une fois les créneaux remplis (fait par le parseur)
+    void updateDailySummaries() {
+        dailySummaries = computeDailySummaries(entries, timezoneOffset);
+    }
 
-            // Calcul min/max température
-            summary.minTemp = dayEntries.first().temperature;
-            summary.maxTemp = dayEntries.first().temperature;
+    /**
+     * Agrégation en un seul passage, sans copie des créneaux
+     *
+     * Les créneaux (chronologiques) sont regroupés par jour calendaire
+     * local de la ville : heure UTC + décalage du fuseau. Le premier jour
+     * est donc généralement partiel, et un jour peut compter plus ou
+     * moins de 8 créneaux.
+     */
+    static QList<DailySummary> computeDailySummaries(const ForecastEntryList& entries, int timezoneOffset) {
+        constexpr qint64 SECONDS_PER_DAY = 86400;
+        constexpr qint64 UNIX_EPOCH_JULIAN_DAY = 2440588; // 1970-01-01
+
+        // Décompte des conditions du jour en cours (8 créneaux de 3 h au plus en pratique)
+        struct Tally {
+            const ForecastEntry* sample;
+            int count;
+            qint64 noonDistance;
+        };
 
-            for (const auto& entry : dayEntries) {
-                summary.minTemp = qMin(summary.minTemp, entry.temperature);
-                summary.maxTemp = qMax(summary.maxTemp, entry.temperature);
+        QList<DailySummary> summaries;
+        QVarLengthArray<Tally, 8> tallies;
+        DailySummary current;
+        double sum = 0.0;
+        qint64 currentDay = 0;
+
+        auto closeDay = [&]() {
+            current.meanTemp = sum / current.count;
+            const Tally* best = &tallies[0];
+            for (const Tally& tally : tallies) {
+                if (tally.count > best->count
+                    || (tally.count == best->count && tally.noonDistance < best->noonDistance)) {
+                    best = &tally;
+                }
+            }
+            current.dominantCondition = best->sample->mainCondition;
+            current.iconCode = best->sample->iconCode;
+            summaries.append(current);
+        };
+
+        for (int i = 0; i < entries.size(); ++i) {
+            const ForecastEntry& entry = entries[i];
+            const qint64 localSeconds = entry.dateTime.toSecsSinceEpoch() + timezoneOffset;
+            const qint64 day = localSeconds >= 0 ? localSeconds / SECONDS_PER_DAY
+                                                 : (localSeconds - SECONDS_PER_DAY + 1) / SECONDS_PER_DAY;
+            const qint64 noonDistance = qAbs(localSeconds - day * SECONDS_PER_DAY - SECONDS_PER_DAY / 2);
+
+            if (current.count == 0 || day != currentDay) {
+                if (current.count > 0) {
+                    closeDay();
+                }
+                current = DailySummary();
+                current.date = QDate::fromJulianDay(UNIX_EPOCH_JULIAN_DAY + day);
+                current.firstIndex = i;
+                current.minTemp = entry.temperature;
+                current.maxTemp = entry.temperature;
+                currentDay = day;
+                sum = 0.0;
+                tallies.clear();
             }
 
-            // Condition dominante (celle de midi si disponible)
-            int noonIndex = dayEntries.size() > 4 ? 4 : dayEntries.size() / 2;
-            summary.dominantCondition = dayEntries[noonIndex].mainCondition;
-            summary.iconCode = dayEntries[noonIndex].iconCode;
-
-            summaries.append(summary);
+            ++current.count;
+            current.minTemp = qMin(current.minTemp, entry.temperature);
+            current.maxTemp = qMax(current.maxTemp, entry.temperature);
+            current.maxPrecipitationProbability = qMax(current.maxPrecipitationProbability,
+                                                       entry.precipitationProbability);
+            sum += entry.temperature;
+
+            // Libellés internés au parsing : la comparaison s'arrête le plus souvent au pointeur
+            Tally* tally = nullptr;
+            for (Tally& candidate : tallies) {
+                if (candidate.sample->mainCondition == entry.mainCondition) {
+                    tally = &candidate;
+                    break;
+                }
+            }
+            if (tally) {
+                ++tally->count;
+                if (noonDistance < tally->noonDistance) {
+                    tally->sample = &entry;
+                    tally->noonDistance = noonDistance;
+                }
+            } else {
+                tallies.append(Tally{&entry, 1, noonDistance});
+            }
         }
 
+        if (current.count > 0) {
+            closeDay();
+        }
         return summaries;
     }
 };
 
+/**
+ * Poignées partagées et immuables sur les données en cache
+ * (un succès de cache ne copie ni n'alloue rien)
+ */
+using CurrentWeatherPtr = std::shared_ptr<const CurrentWeatherData>;
+using ForecastPtr = std::shared_ptr<const ForecastData>;
+
 /**
  * Structure pour les informations de cache
  */
 struct CacheInfo {
     QDateTime cachedAt;         // Moment de mise en cache
-    int validityMinutes;        // Durée validité (15min weather, 120min forecast)
+    int validityMinutes = 0;    // Durée validité (15min weather, 120min forecast)
+    quint64 sequence = 0;       // Ordre d'insertion (choix des entrées à évincer)
 
     bool isValid() const {
         int ageMinutes = QDateTime::currentDateTime().secsTo(cachedAt) / 60;
@@ -198,29 +354,42 @@ struct CacheInfo {
  * Données météo avec informations de cache
  */
 struct CachedWeatherData {
-    CurrentWeatherData weatherData;
+    CurrentWeatherPtr weatherData;  // Jamais modifié après insertion
+    mutable DerivedMetricsPtr derived; // Calculé au premier accès, remplacé avec l'entrée
     CacheInfo cacheInfo;
+    QByteArray rawPayload;      // Réponse API brute (partagée implicitement, optionnelle)
 
     CachedWeatherData() {
         cacheInfo.validityMinutes = 15;  // 15 minutes par défaut
     }
+
+    // Les deux représentations comptent dans le budget mémoire du cache
+    qint64 memoryFootprint() const {
+        return (weatherData ? weatherData->memoryFootprint() : 0) + rawPayload.size();
+    }
 };
 
 struct CachedForecastData {
-    ForecastData forecastData;
+    ForecastPtr forecastData;       // Jamais modifié après insertion
+    mutable ForecastMetricsPtr derived; // Calculé au premier accès, remplacé avec l'entrée
     CacheInfo cacheInfo;
+    QByteArray rawPayload;      // Réponse API brute (partagée implicitement, optionnelle)
 
     CachedForecastData() {
         cacheInfo.validityMinutes = 120;  // 2 heures par défaut
     }
+
+    qint64 memoryFootprint() const {
+        return (forecastData ? forecastData->memoryFootprint() : 0) + rawPayload.size();
+    }
 };
 
-using WeatherCache = QMap<QString, CachedWeatherData>;  // cityName → données+métadata
-using ForecastCache = QMap<QString, CachedForecastData> ;
 // Déclarations pour utilisation dans signals/slots Qt
 Q_DECLARE_METATYPE(CurrentWeatherData)
 Q_DECLARE_METATYPE(ForecastData)
 Q_DECLARE_METATYPE(ForecastEntry)
+Q_DECLARE_METATYPE(CurrentWeatherPtr)
+Q_DECLARE_METATYPE(ForecastPtr)
 Q_DECLARE_METATYPE(CachedWeatherData)
 Q_DECLARE_METATYPE(CachedForecastData)
 
@@ -4,6 +4,10 @@
 //header
 #include "WeatherData.h"
 #include "weathercachemanager.h"
+#include "refreshscheduler.h"
+#include "citygazetteer.h"
+#include "weatherjsonparser.h"
+#include "parsearena.h"
 
 //std lib
 #include <QObject>
@@ -12,6 +16,8 @@
 #include <QNetworkReply>
 #include <QTimer>
 #include <QMap>
+#include <QSet>
+#include <QHash>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
@@ -51,11 +57,64 @@ public:
     void setApiKey(const QString& apiKey);
     void setRequestTimeout(int timeoutMs);
 
+    // Gestionnaire réseau de remplacement (tests) ; non possédé par le service
+    void setNetworkAccessManager(QNetworkAccessManager* manager);
+
     // État du service
     bool isApiKeyValid() const;
     bool hasValidCache(const QString& cityName) const;
     int getCacheAge(const QString& cityName) const;
     QStringList getCachedCities() const;
+    // Villes en cache les plus proches d'une position (index spatial), de la plus proche à la plus lointaine
+    QStringList nearestCachedCities(double latitude, double longitude, int count = 1,
+                                    double maxDistanceKm = -1.0) const;
+    // Lecture directe du cache (vues multi-villes), sans passer par les signaux
+    const ICacheManager* cacheManager() const { return cacheMgrPtr.get(); }
+    // Réponse API brute conservée par le cache (partagée, vide si non conservée)
+    QByteArray getRawPayload(const QString& cityName, const QString& dataType) const;
+    // Grandeurs dérivées (rosée, indices...) mémorisées avec l'entrée en cache
+    DerivedMetricsPtr derivedMetrics(const QString& cityName) const;
+
+    // Budget de requêtes API (fenêtre glissante d'une minute)
+    void setMaxRequestsPerMinute(int maxRequests);
+    int remainingRequestBudget() const;
+
+    // Rafraîchissement en arrière-plan
+    RefreshScheduler* refreshScheduler() const { return m_refreshScheduler; }
+
+    /**
+     * Villes affichées par une vue (tableau de bord, listes, carte...)
+     *
+     * @param viewId Identifiant de la vue ("dashboard", "history"...) ;
+     *               une liste vide retire la vue
+     * @param cityNames Villes à l'écran
+     *
+     * File des requêtes d'arrière-plan : les villes visibles (toutes vues
+     * confondues) passent en tête et peuvent consommer le budget jusqu'à la
+     * réserve interactive ; les autres attendent que la moitié du budget soit
+     * libre et sont abandonnées (échéance reportée) après BACKGROUND_MAX_WAIT_SECS
+     * d'attente (setBackgroundMaxWait).
+     * Les entrées expirées des villes devenues visibles sont relancées.
+     */
+    void setVisibleCities(const QString& viewId, const QStringList& cityNames);
+    bool isCityVisible(const QString& cityName) const;
+    int queuedRequestCount() const { return int(m_backgroundQueue.size()); }
+
+    static constexpr int BACKGROUND_MAX_WAIT_SECS = 5 * 60;
+    void setBackgroundMaxWait(int seconds);
+
+    // Gazetteer hors ligne (résolution locale des noms → identifiant OpenWeatherMap)
+    bool loadGazetteer(const QString& path);
+    const CityGazetteer* gazetteer() const { return m_gazetteer.get(); }
+
+    /**
+     * Clé de cache d'une saisie utilisateur
+     *
+     * Ville connue du gazetteer → son identifiant ("2988507"), requêtée par id= ;
+     * sinon la saisie normalisée ("paris,fr"), requêtée par q=.
+     * "paris", "Paris " et "Paris,FR" partagent ainsi la même entrée.
+     */
+    CityKey cityKey(const QString& cityName) const;
 
     // Gestion cache
     void clearCache();
@@ -91,7 +150,19 @@ public slots:
      *
      * @param cityName Ville à rafraîchir
      */
-   // void refreshWeatherData(const QString& cityName);
+    void refreshWeatherData(const QString& cityName);
+
+    /**
+     * Préchargement basse priorité (cache à chaud avant la recherche)
+     *
+     * @param cityName Ville à précharger
+     * @return types réellement demandés (vide : rien de lancé) ; un type
+     *         encore valide, déjà en cours ou arrêté par le budget n'y figure pas
+     *
+     * N'émet ni loadingStarted() ni les signaux de données ; ne consomme
+     * que la moitié haute du budget de requêtes.
+     */
+    QList<WeatherDataType> prefetch(const QString& cityName);
 
 signals:
     // === SIGNAUX DONNÉES MÉTÉO ===
@@ -101,17 +172,20 @@ signals:
      * (depuis cache ou API)
      *
      * @param cityName Ville concernée
-     * @param weatherData Données météo complètes et validées
+     * @param weatherData Données météo complètes et validées, partagées et immuables
+     *
+     * La même instance est partagée par le cache et tous les récepteurs :
+     * une connexion (même en file d'attente) ne copie que la poignée.
      */
-    void currentWeatherReady(const QString& cityName, const CurrentWeatherData& weatherData);
+    void currentWeatherReady(const QString& cityName, CurrentWeatherPtr weatherData);
 
     /**
      * Émis quand les prévisions 5 jours sont disponibles
      *
      * @param cityName Ville concernée
-     * @param forecastData Prévisions complètes (40 créneaux)
+     * @param forecastData Prévisions complètes (40 créneaux), partagées et immuables
      */
-    void forecastReady(const QString& cityName, const ForecastData& forecastData);
+    void forecastReady(const QString& cityName, ForecastPtr forecastData);
 
     // === SIGNAUX ÉTAT/PROGRESS ===
 
@@ -149,6 +223,32 @@ signals:
      */
     void cacheCleanedUp(int removedCount);
 
+    /**
+     * Émis quand un rafraîchissement en arrière-plan a mis à jour le cache
+     * (aucun currentWeatherReady/forecastReady n'est émis dans ce cas)
+     *
+     * @param cityName Ville rafraîchie
+     * @param dataType "weather" ou "forecast"
+     */
+    void backgroundRefreshCompleted(const QString& cityName, const QString& dataType);
+
+    /**
+     * Émis quand un rafraîchissement en arrière-plan n'aboutit pas
+     * (erreur réseau, réponse invalide) ; le cache est inchangé
+     *
+     * @param cityName Ville concernée
+     * @param dataType "weather" ou "forecast"
+     */
+    void backgroundRefreshFailed(const QString& cityName, const QString& dataType);
+
+    /**
+     * Émis quand une demande de l'utilisateur est servie par le cache
+     *
+     * @param cityName Ville demandée
+     * @param dataType "weather" ou "forecast"
+     */
+    void cacheHit(const QString& cityName, const QString& dataType);
+
 private slots:
     // Réception réponses réseau
     void onCurrentWeatherReceived();
@@ -159,6 +259,12 @@ private slots:
     // Timer pour nettoyage cache automatique
     void onCacheCleanupTimer();
 
+    // Échéance de rafraîchissement atteinte
+    void onRefreshDue(const CityKey& key, WeatherDataType dataType);
+
+    // Envoi des requêtes en attente, villes visibles d'abord
+    void drainBackgroundQueue();
+
 private:
     // === CONFIGURATION ===
     QString m_apiKey;
@@ -167,39 +273,66 @@ private:
 
     // === RÉSEAU ===
     QNetworkAccessManager* m_networkManager;
-    QMap<QNetworkReply*, QString> m_pendingRequests;  // Reply → cityName
-    QMap<QNetworkReply*, QString> m_requestTypes;     // Reply → "weather"/"forecast"
+    QMap<QNetworkReply*, CityKey> m_pendingRequests;  // Reply → clé de cache
+    QMap<QNetworkReply*, WeatherDataType> m_requestTypes;
+    QSet<QNetworkReply*> m_backgroundRequests;        // Requêtes lancées par le planificateur
+
+    // === BUDGET REQUÊTES ===
+    QList<qint64> m_requestTimestamps;    // Envois de la dernière minute (ms)
+    int m_maxRequestsPerMinute;           // Limite API (défaut: 60/min, plan gratuit)
+    int m_interactiveReserve;             // Part du budget réservée à l'utilisateur
+
+    // === FILE D'ARRIÈRE-PLAN ===
+    struct QueuedRequest {
+        CityKey key;
+        WeatherDataType dataType;
+        qint64 queuedAt;                  // ms depuis epoch
+        bool scheduled;                   // Échéance du planificateur (reportée si abandonnée)
+    };
+    QList<QueuedRequest> m_backgroundQueue;
+    QHash<QString, QSet<CityKey>> m_visibleByView;    // Vue → villes à l'écran
+    QSet<CityKey> m_visibleKeys;                      // Union de toutes les vues
+    QTimer* m_queueTimer;                             // Réarmé quand le budget se libère
+    int m_backgroundMaxWaitSecs;                      // Attente max d'une ville hors écran
 
     // === CACHE ===
-    QMap<QString, CachedWeatherData> m_weatherCache;  // cityName → données+métadata
-    QMap<QString, CachedForecastData> m_forecastCache;
     QTimer* m_cacheCleanupTimer;                      // Nettoyage automatique toutes les heures
     //Cache manager
     std::unique_ptr<ICacheManager> cacheMgrPtr;
+    RefreshScheduler* m_refreshScheduler;             // Rafraîchissement avant expiration
 
-    // === MÉTHODES PRIVÉES ===
-
-    // Construction URLs API
-    QUrl buildWeatherUrl(const QString& cityName) const;
-    QUrl buildForecastUrl(const QString& cityName) const;
+    // === GAZETTEER ===
+    std::unique_ptr<CityGazetteer> m_gazetteer;
+    QHash<CityKey, QString> m_displayNames;           // Clé de cache → dernière saisie (signaux)
+    ParseArena m_parseArena;                          // Temporaires du lot de réponses en cours
 
-    // Gestion cache
-    bool isCacheValid(const QString& cityName, const QString& dataType) const;
-    void storeCachedWeather(const QString& cityName, const CurrentWeatherData& data);
-    void storeCachedForecast(const QString& cityName, const ForecastData& data);
+    // === MÉTHODES PRIVÉES ===
 
-    // Parsing JSON → structures typées
-    CurrentWeatherData parseCurrentWeatherJson(const QJsonObject& json) const;
-    ForecastData parseForecastJson(const QJsonObject& json) const;
-    ForecastEntry parseForecastEntry(const QJsonObject& entryJson) const;
+    // Construction URLs API (id= pour une clé numérique, q= sinon)
+    QUrl buildWeatherUrl(const CityKey& key) const;
+    QUrl buildForecastUrl(const CityKey& key) const;
+    QUrlQuery locationQuery(const CityKey& key) const;
 
     // Validation et gestion erreurs
     bool validateApiResponse(const QJsonObject& json, const QString& expectedType) const;
     QString getErrorMessage(QNetworkReply::NetworkError error) const;
     QString getApiErrorMessage(const QJsonObject& json) const;
 
+    // Envoi réseau (par clé de cache)
+    QNetworkReply* sendRequest(const CityKey& key, WeatherDataType dataType, bool background);
+    bool isRequestPending(const CityKey& key, WeatherDataType dataType) const;
+    void scheduleRefresh(const CityKey& key, WeatherDataType dataType);
+    void recordRequest();
+    void enqueueBackground(const CityKey& key, WeatherDataType dataType, bool scheduled);
+    bool isQueueEntryObsolete(const QueuedRequest& request) const;
+    int msUntilBudgetFrees() const;
+
     // Utilitaires
+    QString displayName(const CityKey& key) const;
     void cleanupRequest(QNetworkReply* reply);
+    // Échec d'une réponse : erreur affichée pour une requête utilisateur, report silencieux
+    // pour une requête d'arrière-plan (cleanupRequest émet alors backgroundRefreshFailed)
+    void failRequest(QNetworkReply* reply, const QString& message, const QString& type);
     void emitErrorSafely(const QString& cityName, const QString& message, const QString& type = "");
 };
 
@@ -0,0 +1,124 @@
+#include "chartdownsampling.h"
+#include <algorithm>
+#include <cmath>
+
+namespace ChartDownsampling {
+
+QList<QPointF> largestTriangleThreeBuckets(const QPointF* points, qsizetype count, int threshold)
+{
+    if (count <= 0) return {};
+    if (threshold >= count || threshold < 3) {
+        return QList<QPointF>(points, points + count);
+    }
+
+    QList<QPointF> sampled;
+    sampled.reserve(threshold);
+    sampled.append(points[0]);
+
+    // Points intérieurs répartis en (threshold - 2) intervalles
+    const double bucketSize = double(count - 2) / double(threshold - 2);
+    qsizetype selected = 0;
+
+    for (int bucket = 0; bucket < threshold - 2; ++bucket) {
+        // Point moyen de l'intervalle suivant (le dernier point pour le dernier intervalle)
+        const qsizetype nextStart = qsizetype(std::floor((bucket + 1) * bucketSize)) + 1;
+        const qsizetype nextEnd = std::min(qsizetype(std::floor((bucket + 2) * bucketSize)) + 1, count);
+        double averageX = 0.0;
+        double averageY = 0.0;
+        for (qsizetype i = nextStart; i < nextEnd; ++i) {
+            averageX += points[i].x();
+            averageY += points[i].y();
+        }
+        const double nextCount = double(nextEnd - nextStart);
+        averageX /= nextCount;
+        averageY /= nextCount;
+
+        // Point de l'intervalle courant formant le plus grand triangle
+        const qsizetype start = qsizetype(std::floor(bucket * bucketSize)) + 1;
+        const qsizetype end = qsizetype(std::floor((bucket + 1) * bucketSize)) + 1;
+        const QPointF& anchor = points[selected];
+        double largestArea = -1.0;
+        qsizetype best = start;
+        for (qsizetype i = start; i < end; ++i) {
+            const double area = std::abs((anchor.x() - averageX) * (points[i].y() - anchor.y())
+                                         - (anchor.x() - points[i].x()) * (averageY - anchor.y()));
+            if (area > largestArea) {
+                largestArea = area;
+                best = i;
+            }
+        }
+
+        sampled.append(points[best]);
+        selected = best;
+    }
+
+    sampled.append(points[count - 1]);
+    return sampled;
+}
+
+QList<QPointF> minMaxDecimation(const QPointF* points, qsizetype count, int buckets)
+{
+    if (count <= 0) return {};
+    if (buckets < 1 || 2 * qsizetype(buckets) + 2 >= count) {
+        return QList<QPointF>(points, points + count);
+    }
+
+    QList<QPointF> sampled;
+    sampled.reserve(2 * buckets + 2);
+    sampled.append(points[0]);
+
+    const qsizetype inner = count - 2;
+    for (int bucket = 0; bucket < buckets; ++bucket) {
+        const qsizetype start = 1 + inner * bucket / buckets;
+        const qsizetype end = 1 + inner * (bucket + 1) / buckets;
+        if (start >= end) continue;
+
+        qsizetype low = start;
+        qsizetype high = start;
+        for (qsizetype i = start + 1; i < end; ++i) {
+            if (points[i].y() < points[low].y()) low = i;
+            if (points[i].y() > points[high].y()) high = i;
+        }
+
+        // Ordre des x conservé : le tracé reste monotone en x
+        sampled.append(points[std::min(low, high)]);
+        if (low != high) {
+            sampled.append(points[std::max(low, high)]);
+        }
+    }
+
+    sampled.append(points[count - 1]);
+    return sampled;
+}
+
+QList<QPointF> downsample(const QPointF* points, qsizetype count, int targetCount, Method method)
+{
+    switch (method) {
+    case Method::MinMax:
+        return minMaxDecimation(points, count, std::max(1, (targetCount - 2) / 2));
+    case Method::LargestTriangle:
+        break;
+    }
+    return largestTriangleThreeBuckets(points, count, targetCount);
+}
+
+QList<QPointF> downsample(const QList<QPointF>& points, int targetCount, Method method)
+{
+    return downsample(points.constData(), points.size(), targetCount, method);
+}
+
+QPair<qsizetype, qsizetype> visibleRange(const QList<QPointF>& points, qreal xMin, qreal xMax)
+{
+    auto byX = [](const QPointF& point, qreal x) { return point.x() < x; };
+    auto first = std::lower_bound(points.cbegin(), points.cend(), xMin, byX);
+    auto last = std::upper_bound(points.cbegin(), points.cend(), xMax,
+                                 [](qreal x, const QPointF& point) { return x < point.x(); });
+
+    qsizetype begin = first - points.cbegin();
+    qsizetype end = last - points.cbegin();
+    if (begin > 0) --begin;
+    if (end < points.size()) ++end;
+    return {begin, end};
+}
+
+} // namespace ChartDownsampling
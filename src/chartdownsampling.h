@@ -0,0 +1,55 @@
+#ifndef CHARTDOWNSAMPLING_H
+#define CHARTDOWNSAMPLING_H
+
+#include <QList>
+#include <QPair>
+#include <QPointF>
+#include <QtGlobal>
+
+/**
+ * Réduction de séries de points pour l'affichage (niveau de détail)
+ *
+ * Une courbe n'a pas besoin de plus de points que de pixels : au-delà, le
+ * coût de rendu augmente sans rien changer à l'image.
+ *
+ * - LargestTriangle (LTTB) : un point par intervalle, celui qui forme le plus
+ *   grand triangle avec ses voisins retenus ; garde la forme de la courbe
+ * - MinMax : minimum et maximum de chaque intervalle ; garde les extrêmes
+ *
+ * Les points doivent être triés par x croissant. Premier et dernier points
+ * sont toujours conservés.
+ */
+namespace ChartDownsampling {
+
+enum class Method {
+    LargestTriangle,
+    MinMax
+};
+
+/**
+ * Largest-Triangle-Three-Buckets
+ * @param threshold Nombre de points en sortie (copie intégrale si >= count ou < 3)
+ */
+QList<QPointF> largestTriangleThreeBuckets(const QPointF* points, qsizetype count, int threshold);
+
+/**
+ * Minimum et maximum (dans l'ordre des x) de chaque intervalle
+ * @param buckets Nombre d'intervalles (au plus 2 * buckets + 2 points en sortie)
+ */
+QList<QPointF> minMaxDecimation(const QPointF* points, qsizetype count, int buckets);
+
+// Au plus ~targetCount points, selon la méthode
+QList<QPointF> downsample(const QPointF* points, qsizetype count, int targetCount,
+                          Method method = Method::LargestTriangle);
+QList<QPointF> downsample(const QList<QPointF>& points, int targetCount,
+                          Method method = Method::LargestTriangle);
+
+/**
+ * Indices [first, last) des points dont x est dans [xMin, xMax], étendus d'un
+ * voisin de chaque côté pour que le tracé atteigne les bords (recherche binaire)
+ */
+QPair<qsizetype, qsizetype> visibleRange(const QList<QPointF>& points, qreal xMin, qreal xMax);
+
+} // namespace ChartDownsampling
+
+#endif // CHARTDOWNSAMPLING_H
@@ -0,0 +1,335 @@
+#include "citygazetteer.h"
+#include <QCoreApplication>
+#include <QStandardPaths>
+#include <QSaveFile>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QLocale>
+#include <QDir>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace {
+constexpr quint32 GAZETTEER_MAGIC = 0x57475A31; // "WGZ1"
+constexpr quint32 GAZETTEER_VERSION = 1;
+}
+
+// Disposition sur disque (ordre des octets natif, vérifié par le magic)
+struct CityGazetteer::Header {
+    quint32 magic;
+    quint32 version;
+    quint32 count;          // Nombre d'enregistrements
+    quint32 stringsSize;    // Taille de la zone de chaînes
+};
+
+struct CityGazetteer::Record {
+    quint32 cityId;
+    quint32 keyOffset;      // Nom normalisé (clé de tri)
+    quint32 nameOffset;     // Nom affiché
+    quint16 keyLength;
+    quint16 nameLength;
+    float latitude;
+    float longitude;
+    char country[2];
+    quint16 reserved;
+};
+
+CityGazetteer::CityGazetteer()
+    : m_data(nullptr)
+    , m_records(nullptr)
+    , m_strings(nullptr)
+    , m_count(0)
+    , m_stringsSize(0)
+{
+    m_preferredCountry = QLocale::territoryToCode(QLocale::system().territory()).toUpper();
+}
+
+CityGazetteer::~CityGazetteer()
+{
+    close();
+}
+
+// =====================================================
+// OUVERTURE
+// =====================================================
+
+bool CityGazetteer::open(const QString& path)
+{
+    static_assert(sizeof(Header) == 16 && sizeof(Record) == 28, "gazetteer layout changed: bump GAZETTEER_VERSION");
+    close();
+
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    const qint64 fileSize = m_file.size();
+    if (fileSize < qint64(sizeof(Header))) {
+        qWarning() << "CityGazetteer: file too small" << path;
+        m_file.close();
+        return false;
+    }
+
+    m_data = m_file.map(0, fileSize);
+    if (!m_data) {
+        qWarning() << "CityGazetteer: cannot map" << path << m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    Header header;
+    std::memcpy(&header, m_data, sizeof(Header));
+    const qint64 expected = qint64(sizeof(Header)) + qint64(header.count) * qint64(sizeof(Record))
+                            + header.stringsSize;
+    if (header.magic != GAZETTEER_MAGIC || header.version != GAZETTEER_VERSION || expected != fileSize) {
+        qWarning() << "CityGazetteer: invalid or incompatible file" << path;
+        close();
+        return false;
+    }
+
+    m_count = header.count;
+    m_stringsSize = header.stringsSize;
+    m_records = reinterpret_cast<const Record*>(m_data + sizeof(Header));
+    m_strings = reinterpret_cast<const char*>(m_records + m_count);
+
+    // Chaque chaîne référencée doit tenir dans la zone de chaînes : un fichier
+    // tronqué ou altéré ferait sinon lire hors de la projection
+    for (quint32 i = 0; i < m_count; ++i) {
+        const Record& record = m_records[i];
+        if (quint64(record.keyOffset) + record.keyLength > m_stringsSize
+            || quint64(record.nameOffset) + record.nameLength > m_stringsSize) {
+            qWarning() << "CityGazetteer: record" << i << "points outside the string area" << path;
+            close();
+            return false;
+        }
+    }
+
+    qDebug() << "CityGazetteer: mapped" << m_count << "cities from" << path;
+    return true;
+}
+
+void CityGazetteer::close()
+{
+    if (m_data) {
+        m_file.unmap(const_cast<uchar*>(m_data));
+    }
+    if (m_file.isOpen()) {
+        m_file.close();
+    }
+    m_data = nullptr;
+    m_records = nullptr;
+    m_strings = nullptr;
+    m_count = 0;
+    m_stringsSize = 0;
+}
+
+// =====================================================
+// RECHERCHE
+// =====================================================
+
+QList<GazetteerCity> CityGazetteer::lookup(const QString& name, const QString& countryCode) const
+{
+    QList<GazetteerCity> result;
+    if (!isOpen()) return result;
+
+    const QByteArray key = normalizeName(name).toUtf8();
+    if (key.isEmpty()) return result;
+
+    // Dichotomie : premier enregistrement dont la clé n'est pas inférieure
+    quint32 low = 0;
+    quint32 high = m_count;
+    while (low < high) {
+        quint32 mid = low + (high - low) / 2;
+        if (keyAt(mid).compare(key) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    const QString country = countryCode.trimmed().toUpper();
+    for (quint32 i = low; i < m_count && keyAt(i) == QByteArrayView(key); ++i) {
+        GazetteerCity city = cityAt(i);
+        if (country.isEmpty() || city.countryCode == country) {
+            result.append(city);
+        }
+    }
+    return result;
+}
+
+GazetteerCity CityGazetteer::resolve(const QString& input) const
+{
+    // "Paris,FR" → nom + code pays ; une virgule suivie d'autre chose fait partie du nom
+    QString name = input;
+    QString country;
+    int comma = input.lastIndexOf(',');
+    if (comma > 0) {
+        QString suffix = input.mid(comma + 1).trimmed();
+        if (suffix.size() == 2 && suffix.at(0).isLetter() && suffix.at(1).isLetter()) {
+            name = input.left(comma);
+            country = suffix;
+        }
+    }
+
+    const QList<GazetteerCity> matches = lookup(name, country);
+    if (matches.isEmpty()) return GazetteerCity();
+
+    if (country.isEmpty() && !m_preferredCountry.isEmpty()) {
+        for (const GazetteerCity& city : matches) {
+            if (city.countryCode == m_preferredCountry) {
+                return city;
+            }
+        }
+    }
+    return matches.first();
+}
+
+void CityGazetteer::setPreferredCountry(const QString& countryCode)
+{
+    m_preferredCountry = countryCode.trimmed().toUpper();
+}
+
+QStringList CityGazetteer::names() const
+{
+    QStringList result;
+    result.reserve(int(m_count));
+    for (quint32 i = 0; i < m_count; ++i) {
+        const Record& record = m_records[i];
+        result.append(QString::fromUtf8(m_strings + record.nameOffset, record.nameLength));
+    }
+    return result;
+}
+
+GazetteerCity CityGazetteer::cityAt(quint32 index) const
+{
+    const Record& record = m_records[index];
+
+    GazetteerCity city;
+    city.cityId = record.cityId;
+    city.name = QString::fromUtf8(m_strings + record.nameOffset, record.nameLength);
+    city.countryCode = QString::fromLatin1(record.country, int(qstrnlen(record.country, 2)));
+    city.latitude = record.latitude;
+    city.longitude = record.longitude;
+    return city;
+}
+
+QByteArrayView CityGazetteer::keyAt(quint32 index) const
+{
+    const Record& record = m_records[index];
+    return QByteArrayView(m_strings + record.keyOffset, record.keyLength);
+}
+
+// =====================================================
+// GÉNÉRATION
+// =====================================================
+
+bool CityGazetteer::build(const QString& cityListPath, const QString& outputPath, QString* errorMessage)
+{
+    auto fail = [errorMessage](const QString& message) {
+        if (errorMessage) *errorMessage = message;
+        qWarning() << "CityGazetteer:" << message;
+        return false;
+    };
+
+    QFile source(cityListPath);
+    if (!source.open(QIODevice::ReadOnly)) {
+        return fail(QString("cannot read %1: %2").arg(cityListPath, source.errorString()));
+    }
+
+    QJsonParseError parseError;
+    QJsonDocument doc = QJsonDocument::fromJson(source.readAll(), &parseError);
+    if (!doc.isArray()) {
+        return fail(QString("invalid city list: %1").arg(parseError.errorString()));
+    }
+
+    struct Pending {
+        QByteArray key;
+        QByteArray name;
+        Record record;
+    };
+
+    const QJsonArray cities = doc.array();
+    std::vector<Pending> pending;
+    pending.reserve(cities.size());
+    for (const QJsonValue& value : cities) {
+        QJsonObject json = value.toObject();
+        QString name = json["name"].toString();
+        qint64 id = json["id"].toInteger();
+        if (name.isEmpty() || id <= 0 || id > std::numeric_limits<quint32>::max()) continue;
+
+        Pending item;
+        item.key = normalizeName(name).toUtf8().left(std::numeric_limits<quint16>::max());
+        item.name = name.toUtf8().left(std::numeric_limits<quint16>::max());
+        if (item.key.isEmpty()) continue;
+
+        std::memset(&item.record, 0, sizeof(Record));
+        item.record.cityId = quint32(id);
+        QJsonObject coord = json["coord"].toObject();
+        item.record.latitude = float(coord["lat"].toDouble());
+        item.record.longitude = float(coord["lon"].toDouble());
+        QByteArray country = json["country"].toString().toUpper().toLatin1();
+        std::memcpy(item.record.country, country.constData(), qMin(2, int(country.size())));
+        pending.push_back(std::move(item));
+    }
+
+    // Tri par octets UTF-8 : même ordre que la comparaison de lookup()
+    std::sort(pending.begin(), pending.end(), [](const Pending& a, const Pending& b) {
+        int cmp = a.key.compare(b.key);
+        return cmp != 0 ? cmp < 0 : a.record.cityId < b.record.cityId;
+    });
+
+    QByteArray strings;
+    std::vector<Record> records;
+    records.reserve(pending.size());
+    for (Pending& item : pending) {
+        item.record.keyOffset = quint32(strings.size());
+        item.record.keyLength = quint16(item.key.size());
+        strings.append(item.key);
+        item.record.nameOffset = quint32(strings.size());
+        item.record.nameLength = quint16(item.name.size());
+        strings.append(item.name);
+        records.push_back(item.record);
+    }
+
+    Header header;
+    header.magic = GAZETTEER_MAGIC;
+    header.version = GAZETTEER_VERSION;
+    header.count = quint32(records.size());
+    header.stringsSize = quint32(strings.size());
+
+    QSaveFile output(outputPath);
+    if (!output.open(QIODevice::WriteOnly)) {
+        return fail(QString("cannot write %1: %2").arg(outputPath, output.errorString()));
+    }
+    output.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+    output.write(reinterpret_cast<const char*>(records.data()), qint64(records.size() * sizeof(Record)));
+    output.write(strings);
+    if (!output.commit()) {
+        return fail(QString("cannot commit %1: %2").arg(outputPath, output.errorString()));
+    }
+
+    qDebug() << "CityGazetteer: built" << records.size() << "cities into" << outputPath;
+    return true;
+}
+
+QString CityGazetteer::defaultPath()
+{
+    // Fichier livré à côté de l'exécutable, sinon copie générée dans les données de l'application
+    QString bundled = QCoreApplication::applicationDirPath() + "/data/cities.gaz";
+    if (QFile::exists(bundled)) {
+        return bundled;
+    }
+
+    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dataDir);
+    return dataDir + "/cities.gaz";
+}
+
+QString CityGazetteer::normalizeName(const QString& name)
+{
+    return CityKey::normalizeName(name);
+}
@@ -0,0 +1,90 @@
+#ifndef CITYGAZETTEER_H
+#define CITYGAZETTEER_H
+
+#include "citykey.h"
+#include <QString>
+#include <QStringList>
+#include <QByteArrayView>
+#include <QList>
+#include <QFile>
+
+/**
+ * Ville connue du gazetteer
+ */
+struct GazetteerCity {
+    qint64 cityId = 0;          // Identifiant OpenWeatherMap
+    QString name;               // Nom affiché ("Saint-Étienne")
+    QString countryCode;        // Code pays ISO ("FR")
+    double latitude = 0.0;
+    double longitude = 0.0;
+
+    bool isValid() const { return cityId > 0; }
+};
+
+/**
+ * Gazetteer hors ligne : nom de ville → identifiant/coordonnées/pays
+ *
+ * Fichier binaire projeté en mémoire (QFile::map), généré une fois depuis
+ * le city.list.json d'OpenWeatherMap :
+ * - en-tête, puis enregistrements de taille fixe triés par nom normalisé
+ * - zone de chaînes UTF-8 (noms normalisés et noms affichés)
+ *
+ * Une recherche est une dichotomie sur les enregistrements : rien n'est
+ * copié ni parsé au démarrage, seules les pages consultées sont lues.
+ */
+class CityGazetteer
+{
+public:
+    CityGazetteer();
+    ~CityGazetteer();
+
+    CityGazetteer(const CityGazetteer&) = delete;
+    CityGazetteer& operator=(const CityGazetteer&) = delete;
+
+    // Ouverture du fichier binaire
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return m_records != nullptr; }
+    int size() const { return int(m_count); }
+
+    // Recherche exacte sur le nom normalisé, filtrée par pays si fourni
+    QList<GazetteerCity> lookup(const QString& name, const QString& countryCode = QString()) const;
+
+    /**
+     * Résout une saisie utilisateur : "Paris", "paris ", "Paris,FR", "Paris, fr"
+     * Homonymes sans pays : le pays préféré l'emporte, sinon le premier trouvé
+     */
+    GazetteerCity resolve(const QString& input) const;
+
+    // Noms affichés de toutes les villes (dictionnaire de l'autocomplétion)
+    QStringList names() const;
+
+    // Pays privilégié pour départager les homonymes (défaut: pays du système)
+    void setPreferredCountry(const QString& countryCode);
+
+    // Génération du fichier binaire depuis city.list.json
+    static bool build(const QString& cityListPath, const QString& outputPath, QString* errorMessage = nullptr);
+
+    // Emplacement du fichier livré avec l'application
+    static QString defaultPath();
+
+    // "  Saint-Étienne " → "saint-etienne" (même règle que CityKey)
+    static QString normalizeName(const QString& name);
+
+private:
+    struct Header;
+    struct Record;
+
+    QFile m_file;
+    const uchar* m_data;
+    const Record* m_records;
+    const char* m_strings;
+    quint32 m_count;
+    quint32 m_stringsSize;
+    QString m_preferredCountry;
+
+    GazetteerCity cityAt(quint32 index) const;
+    QByteArrayView keyAt(quint32 index) const;
+};
+
+#endif // CITYGAZETTEER_H
@@ -0,0 +1,102 @@
+#ifndef CITYKEY_H
+#define CITYKEY_H
+
+#include <QString>
+#include <QHash>
+#include <QMetaType>
+
+/**
+ * Type de données mises en cache (remplace les chaînes "weather"/"forecast")
+ */
+enum class WeatherDataType : quint8 {
+    Weather,
+    Forecast
+};
+
+// Nom utilisé dans les signaux et les logs
+inline QString dataTypeName(WeatherDataType type)
+{
+    return type == WeatherDataType::Forecast ? QStringLiteral("forecast") : QStringLiteral("weather");
+}
+
+inline WeatherDataType dataTypeFromName(const QString& name)
+{
+    return name == QLatin1String("forecast") ? WeatherDataType::Forecast : WeatherDataType::Weather;
+}
+
+/**
+ * Identité canonique d'une ville dans le cache
+ *
+ * - Identifiant OpenWeatherMap quand la ville est connue (gazetteer),
+ *   uniquement via fromId()
+ * - Sinon nom normalisé : "  Saint-Étienne ", "saint-etienne" et
+ *   "SAINT-ETIENNE" donnent la même clé, "Paris , FR" devient "paris,fr"
+ *
+ * Le hash est calculé une seule fois à la construction.
+ */
+class CityKey
+{
+public:
+    CityKey() = default;
+
+    // Saisie libre : toujours un nom, même purement numérique (code postal...)
+    explicit CityKey(const QString& cityName)
+        : m_name(normalizeName(cityName))
+        , m_hash(qHash(m_name))
+    {
+    }
+
+    static CityKey fromId(qint64 cityId)
+    {
+        CityKey key;
+        key.m_cityId = cityId;
+        key.m_hash = qHash(cityId) ^ 0x9e3779b9u; // séparer les espaces id/nom
+        return key;
+    }
+
+    bool isId() const { return m_cityId > 0; }
+    bool isEmpty() const { return m_cityId <= 0 && m_name.isEmpty(); }
+    qint64 cityId() const { return m_cityId; }
+    const QString& name() const { return m_name; }
+    size_t hash() const { return m_hash; }
+
+    // Représentation texte (logs, URL) : identifiant ou nom normalisé
+    QString toString() const { return isId() ? QString::number(m_cityId) : m_name; }
+
+    bool operator==(const CityKey& other) const
+    {
+        return m_hash == other.m_hash && m_cityId == other.m_cityId && m_name == other.m_name;
+    }
+    bool operator!=(const CityKey& other) const { return !(*this == other); }
+
+    // Casse, accents et espaces ignorés
+    static QString normalizeName(const QString& name)
+    {
+        QString decomposed = name.simplified().normalized(QString::NormalizationForm_D);
+        QString folded;
+        folded.reserve(decomposed.size());
+        for (const QChar& c : decomposed) {
+            if (c.category() != QChar::Mark_NonSpacing) {
+                folded.append(c);
+            }
+        }
+        folded.replace(QStringLiteral(" ,"), QStringLiteral(","));
+        folded.replace(QStringLiteral(", "), QStringLiteral(","));
+        return folded.toCaseFolded();
+    }
+
+private:
+    qint64 m_cityId = 0;
+    QString m_name;
+    size_t m_hash = 0;
+};
+
+inline size_t qHash(const CityKey& key, size_t seed = 0) noexcept
+{
+    return key.hash() ^ seed;
+}
+
+Q_DECLARE_METATYPE(CityKey)
+Q_DECLARE_METATYPE(WeatherDataType)
+
+#endif // CITYKEY_H
@@ -0,0 +1,226 @@
+#include "cityspatialindex.h"
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+const double DEG_TO_RAD = qDegreesToRadians(1.0);
+
+// Retrait sans préserver l'ordre de la case (l'ordre n'y a pas de sens)
+template <typename List, typename Key>
+bool takeFromCell(List& cell, const Key& key)
+{
+    for (qsizetype i = 0; i < cell.size(); ++i) {
+        if (cell[i].key == key) {
+            if (i != cell.size() - 1) {
+                cell[i] = cell.last();
+            }
+            cell.removeLast();
+            return true;
+        }
+    }
+    return false;
+}
+}
+
+CitySpatialIndex::CitySpatialIndex(double cellDegrees)
+{
+    // Taille ajustée pour un nombre entier de colonnes (bouclage en longitude)
+    m_columns = qMax(2, int(std::lround(360.0 / qBound(0.1, cellDegrees, 180.0))));
+    m_cellDegrees = 360.0 / m_columns;
+    m_rows = (m_columns + 1) / 2;
+    m_cells.resize(m_columns * m_rows);
+}
+
+// =====================================================
+// MISE À JOUR
+// =====================================================
+
+void CitySpatialIndex::insert(const CityKey& key, double latitude, double longitude)
+{
+    const int cell = rowOf(latitude) * m_columns + columnOf(longitude);
+
+    auto it = m_cellOf.find(key);
+    if (it != m_cellOf.end()) {
+        takeFromCell(m_cells[it.value()], key);
+        it.value() = cell;
+    } else {
+        m_cellOf.insert(key, cell);
+    }
+    m_cells[cell].append({key, latitude, longitude});
+}
+
+bool CitySpatialIndex::remove(const CityKey& key)
+{
+    auto it = m_cellOf.find(key);
+    if (it == m_cellOf.end()) return false;
+    takeFromCell(m_cells[it.value()], key);
+    m_cellOf.erase(it);
+    return true;
+}
+
+void CitySpatialIndex::clear()
+{
+    // Seules les cases occupées sont vidées
+    for (auto it = m_cellOf.cbegin(); it != m_cellOf.cend(); ++it) {
+        m_cells[it.value()].clear();
+    }
+    m_cellOf.clear();
+}
+
+// =====================================================
+// REQUÊTES
+// =====================================================
+
+QList<CityKey> CitySpatialIndex::within(const QRectF& bounds) const
+{
+    QList<CityKey> result;
+    const double south = qMax(-90.0, bounds.top());
+    const double north = qMin(90.0, bounds.bottom());
+    const double west = bounds.left();
+    const double east = bounds.right();
+    if (m_cellOf.isEmpty() || south > north || west > east) return result;
+
+    // Colonnes non bornées, chaque case au plus une fois
+    const bool wholeWorld = east - west >= 360.0;
+    const int firstColumn = int(std::floor((west + 180.0) / m_cellDegrees));
+    const int lastColumn = qMin(firstColumn + m_columns - 1,
+                                int(std::floor((east + 180.0) / m_cellDegrees)));
+
+    for (int row = rowOf(south); row <= rowOf(north); ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            for (const Entry& entry : m_cells[row * m_columns + wrapColumn(column)]) {
+                if (entry.latitude < south || entry.latitude > north) continue;
+                if (!wholeWorld) {
+                    // Longitude ramenée dans la copie du monde qui commence à west
+                    double offset = std::fmod(entry.longitude - west, 360.0);
+                    if (offset < 0) offset += 360.0;
+                    if (west + offset > east) continue;
+                }
+                result.append(entry.key);
+            }
+        }
+    }
+    return result;
+}
+
+QList<CityKey> CitySpatialIndex::nearest(double latitude, double longitude, int count,
+                                         double maxDistanceKm) const
+{
+    QList<CityKey> result;
+    if (count <= 0 || m_cellOf.isEmpty()) return result;
+
+    // Meilleurs candidats triés par distance (au plus count)
+    struct Candidate {
+        double distance;
+        CityKey key;
+    };
+    QList<Candidate> best;
+    best.reserve(count + 1);
+    auto consider = [&](const Entry& entry) {
+        const double distance = distanceKm(latitude, longitude, entry.latitude, entry.longitude);
+        if (maxDistanceKm >= 0 && distance > maxDistanceKm) return;
+        if (best.size() == count && distance >= best.last().distance) return;
+        auto pos = std::upper_bound(best.begin(), best.end(), distance,
+                                    [](double value, const Candidate& c) { return value < c.distance; });
+        best.insert(pos, {distance, entry.key});
+        if (best.size() > count) best.removeLast();
+    };
+    auto visit = [&](int row, int columnOffset, int column0) {
+        for (const Entry& entry : m_cells[row * m_columns + wrapColumn(column0 + columnOffset)]) {
+            consider(entry);
+        }
+    };
+
+    // Décalages de colonnes du bloc de rayon ring (le tour du monde au plus une fois)
+    const int half = m_columns / 2;
+    auto low = [&](int ring) { return -qMin(ring, m_columns - 1 - half); };
+    auto high = [&](int ring) { return qMin(ring, half); };
+
+    const int row0 = rowOf(latitude);
+    const int column0 = columnOf(longitude);
+    const int maxRing = qMax(m_rows, half);
+    for (int ring = 0; ring <= maxRing; ++ring) {
+        for (int dr = -ring; dr <= ring; ++dr) {
+            const int row = row0 + dr;
+            if (row < 0 || row >= m_rows) continue;
+
+            if (qAbs(dr) == ring) {
+                // Ligne du bord : toutes les colonnes du bloc
+                for (int dc = low(ring); dc <= high(ring); ++dc) {
+                    visit(row, dc, column0);
+                }
+            } else {
+                // Ligne intérieure : seules les deux colonnes ajoutées par cet anneau
+                if (low(ring) < low(ring - 1)) visit(row, low(ring), column0);
+                if (high(ring) > high(ring - 1)) visit(row, high(ring), column0);
+            }
+        }
+
+        const double bound = ringLowerBoundKm(latitude, ring);
+        if (best.size() == count && best.last().distance <= bound) break;
+        if (maxDistanceKm >= 0 && bound > maxDistanceKm) break;
+    }
+
+    result.reserve(best.size());
+    for (const Candidate& candidate : best) {
+        result.append(candidate.key);
+    }
+    return result;
+}
+
+double CitySpatialIndex::distanceKm(double latitude1, double longitude1,
+                                    double latitude2, double longitude2)
+{
+    const double dLat = (latitude2 - latitude1) * DEG_TO_RAD;
+    const double dLon = (longitude2 - longitude1) * DEG_TO_RAD;
+    const double sinLat = std::sin(dLat / 2);
+    const double sinLon = std::sin(dLon / 2);
+    const double a = sinLat * sinLat
+                     + std::cos(latitude1 * DEG_TO_RAD) * std::cos(latitude2 * DEG_TO_RAD) * sinLon * sinLon;
+    return 2.0 * EARTH_RADIUS_KM * std::asin(std::sqrt(qBound(0.0, a, 1.0)));
+}
+
+// =====================================================
+// UTILITAIRES
+// =====================================================
+
+int CitySpatialIndex::columnOf(double longitude) const
+{
+    return wrapColumn(int(std::floor((longitude + 180.0) / m_cellDegrees)));
+}
+
+int CitySpatialIndex::rowOf(double latitude) const
+{
+    return qBound(0, int(std::floor((latitude + 90.0) / m_cellDegrees)), m_rows - 1);
+}
+
+int CitySpatialIndex::wrapColumn(int column) const
+{
+    return ((column % m_columns) + m_columns) % m_columns;
+}
+
+double CitySpatialIndex::ringLowerBoundKm(double latitude, int ring) const
+{
+    // Distance minimale d'un point hors du bloc de rayon ring autour de la case du point
+    constexpr double unreachable = std::numeric_limits<double>::infinity();
+    const double gap = ring * m_cellDegrees * DEG_TO_RAD;
+    const int row0 = rowOf(latitude);
+
+    // Au-delà des lignes du bloc : au moins gap en latitude
+    const bool rowsExhausted = row0 - ring <= 0 && row0 + ring >= m_rows - 1;
+    const double latitudeBound = rowsExhausted ? unreachable : EARTH_RADIUS_KM * gap;
+
+    // Au-delà des colonnes : au moins gap en longitude, à une latitude du bloc
+    const int half = m_columns / 2;
+    const bool columnsExhausted = ring >= half;
+    double longitudeBound = unreachable;
+    if (!columnsExhausted) {
+        const double farthest = qMin(90.0, qAbs(latitude) + (ring + 1) * m_cellDegrees);
+        const double cosProduct = std::cos(latitude * DEG_TO_RAD) * std::cos(farthest * DEG_TO_RAD);
+        const double s = std::sqrt(qMax(0.0, cosProduct)) * std::sin(gap / 2);
+        longitudeBound = 2.0 * EARTH_RADIUS_KM * std::asin(qBound(0.0, s, 1.0));
+    }
+    return qMin(latitudeBound, longitudeBound);
+}
@@ -0,0 +1,74 @@
+#ifndef CITYSPATIALINDEX_H
+#define CITYSPATIALINDEX_H
+
+#include "citykey.h"
+#include <QHash>
+#include <QList>
+#include <QRectF>
+#include <QVector>
+
+/**
+ * Index spatial des villes : grille régulière en (lat, lon)
+ *
+ * - Cases de cellDegrees de côté (cellules type geohash), stockage dense
+ *   ((360 / taille) x (180 / taille) listes, la plupart vides)
+ * - Insertion, déplacement et retrait en O(1) : mis à jour par le cache
+ *   à chaque stockage, éviction ou nettoyage
+ * - within() : seules les cases recouvrant la zone sont parcourues ;
+ *   nearest() : anneaux de cases autour du point, arrêt dès que l'anneau
+ *   suivant ne peut plus contenir de ville plus proche
+ * - Le monde est cyclique en longitude (zones à cheval sur l'antiméridien)
+ */
+class CitySpatialIndex
+{
+public:
+    static constexpr double DEFAULT_CELL_DEGREES = 5.0;
+    static constexpr double EARTH_RADIUS_KM = 6371.0;
+
+    explicit CitySpatialIndex(double cellDegrees = DEFAULT_CELL_DEGREES);
+
+    // Insertion ou déplacement d'une ville déjà indexée
+    void insert(const CityKey& key, double latitude, double longitude);
+    bool remove(const CityKey& key);
+    void clear();
+
+    bool contains(const CityKey& key) const { return m_cellOf.contains(key); }
+    int size() const { return int(m_cellOf.size()); }
+
+    /**
+     * Villes dans une zone (x = longitude, y = latitude)
+     * Longitudes hors [-180, 180] acceptées (vue de carte qui se répète)
+     */
+    QList<CityKey> within(const QRectF& bounds) const;
+
+    /**
+     * Les count villes les plus proches, de la plus proche à la plus lointaine
+     * @param maxDistanceKm Rayon de recherche (négatif : illimité)
+     */
+    QList<CityKey> nearest(double latitude, double longitude, int count,
+                           double maxDistanceKm = -1.0) const;
+
+    // Distance orthodromique (haversine)
+    static double distanceKm(double latitude1, double longitude1,
+                             double latitude2, double longitude2);
+
+private:
+    struct Entry {
+        CityKey key;
+        double latitude;
+        double longitude;
+    };
+
+    double m_cellDegrees;
+    int m_columns;
+    int m_rows;
+    QVector<QList<Entry>> m_cells;      // row * m_columns + column
+    QHash<CityKey, int> m_cellOf;       // Clé → case
+
+    int columnOf(double longitude) const;
+    int rowOf(double latitude) const;
+    int wrapColumn(int column) const;
+    double ringLowerBoundKm(double latitude, int ring) const;
+};
+
+#endif // CITYSPATIALINDEX_H
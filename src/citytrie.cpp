@@ -0,0 +1,304 @@
+#include "citytrie.h"
+#include <QStringView>
+#include <algorithm>
+
+CityTrie::CityTrie(int topK)
+    : m_topK(qMax(1, topK))
+{
+    m_nodes.append(Node()); // racine
+}
+
+// =====================================================
+// HISTORIQUE
+// =====================================================
+
+void CityTrie::upsert(const QString& key, const SearchHistoryEntry& entry)
+{
+    if (key.isEmpty()) return;
+
+    // Une mise à jour qui fait reculer l'élément impose un recalcul
+    int existing = m_itemByKey.value(key, -1);
+    bool degraded = existing >= 0 && m_items[existing].inHistory && m_items[existing].entry < entry;
+
+    int item = itemFor(key);
+    m_items[item].entry = entry;
+    m_items[item].displayName = entry.cityName;
+    m_items[item].inHistory = true;
+
+    QVector<int> path = insertPath(key);
+    m_nodes[path.last()].item = item;
+
+    if (degraded) {
+        recompute(path);
+    } else {
+        promote(path, item);
+    }
+}
+
+void CityTrie::remove(const QString& key)
+{
+    int item = m_itemByKey.value(key, -1);
+    if (item < 0 || !m_items[item].inHistory) return;
+
+    QVector<int> path = findPath(key);
+    m_items[item].inHistory = false;
+    m_items[item].entry = SearchHistoryEntry();
+
+    // Le nom reste suggéré s'il fait partie du dictionnaire
+    if (!m_items[item].inDictionary && !path.isEmpty()) {
+        m_nodes[path.last()].item = -1;
+    }
+    releaseIfUnused(key, item);
+    recompute(path);
+}
+
+void CityTrie::clearHistory()
+{
+    QStringList historyKeys;
+    for (const Item& item : m_items) {
+        if (item.inHistory) historyKeys.append(item.key);
+    }
+    for (const QString& key : historyKeys) {
+        remove(key);
+    }
+}
+
+// =====================================================
+// DICTIONNAIRE
+// =====================================================
+
+void CityTrie::addDictionaryName(const QString& key, const QString& displayName, qint64 weight)
+{
+    if (key.isEmpty()) return;
+
+    int existing = m_itemByKey.value(key, -1);
+    bool degraded = existing >= 0 && !m_items[existing].inHistory
+                    && m_items[existing].inDictionary && weight < m_items[existing].weight;
+
+    int item = itemFor(key);
+    if (!m_items[item].inHistory) {
+        m_items[item].displayName = displayName;
+    }
+    m_items[item].weight = weight;
+    m_items[item].inDictionary = true;
+
+    QVector<int> path = insertPath(key);
+    m_nodes[path.last()].item = item;
+
+    if (degraded) {
+        recompute(path);
+    } else {
+        promote(path, item);
+    }
+}
+
+void CityTrie::clear()
+{
+    m_nodes.clear();
+    m_nodes.append(Node());
+    m_items.clear();
+    m_freeItems.clear();
+    m_itemByKey.clear();
+}
+
+// =====================================================
+// RECHERCHE
+// =====================================================
+
+QStringList CityTrie::suggestions(const QString& prefix, int maxCount) const
+{
+    int node = 0;
+    int pos = 0;
+
+    while (pos < prefix.size()) {
+        int next = -1;
+        for (int child : m_nodes[node].children) {
+            if (m_nodes[child].label.at(0) == prefix.at(pos)) {
+                next = child;
+                break;
+            }
+        }
+        if (next < 0) return QStringList();
+
+        QStringView label(m_nodes[next].label);
+        QStringView rest = QStringView(prefix).mid(pos);
+        if (rest.size() <= label.size()) {
+            // Le préfixe se termine sur cette arête
+            if (!label.startsWith(rest)) return QStringList();
+            node = next;
+            break;
+        }
+        if (!rest.startsWith(label)) return QStringList();
+        node = next;
+        pos += label.size();
+    }
+
+    QStringList result;
+    const QVector<int>& top = m_nodes[node].top;
+    for (int i = 0; i < qMin(maxCount, top.size()); ++i) {
+        result.append(m_items[top[i]].displayName);
+    }
+    return result;
+}
+
+// =====================================================
+// INTERNE
+// =====================================================
+
+bool CityTrie::ranksBefore(int a, int b) const
+{
+    const Item& x = m_items[a];
+    const Item& y = m_items[b];
+
+    // L'historique passe avant le dictionnaire
+    if (x.inHistory != y.inHistory) return x.inHistory;
+
+    if (x.inHistory) {
+        if (x.entry < y.entry) return true;   // favoris > fréquence > récence
+        if (y.entry < x.entry) return false;
+    } else if (x.weight != y.weight) {
+        return x.weight > y.weight;
+    }
+    return x.key < y.key;
+}
+
+QVector<int> CityTrie::insertPath(const QString& key)
+{
+    QVector<int> path;
+    path.append(0);
+
+    int node = 0;
+    int pos = 0;
+    while (pos < key.size()) {
+        int child = -1;
+        for (int c : m_nodes[node].children) {
+            if (m_nodes[c].label.at(0) == key.at(pos)) {
+                child = c;
+                break;
+            }
+        }
+
+        if (child < 0) {
+            // Nouvelle feuille portant le reste de la clé
+            Node leaf;
+            leaf.label = key.mid(pos);
+            m_nodes.append(leaf);
+            int leafIndex = m_nodes.size() - 1;
+            m_nodes[node].children.append(leafIndex);
+            path.append(leafIndex);
+            return path;
+        }
+
+        const QString label = m_nodes[child].label;
+        int common = 0;
+        int maxCommon = qMin(label.size(), key.size() - pos);
+        while (common < maxCommon && label.at(common) == key.at(pos + common)) {
+            ++common;
+        }
+
+        if (common < label.size()) {
+            // Découpage de l'arête : "paris" → "par" + "is"
+            Node middle;
+            middle.label = label.left(common);
+            middle.children.append(child);
+            middle.top = m_nodes[child].top; // même sous-arbre
+            m_nodes[child].label = label.mid(common);
+            m_nodes.append(middle);
+            int middleIndex = m_nodes.size() - 1;
+
+            QVector<int>& siblings = m_nodes[node].children;
+            siblings[siblings.indexOf(child)] = middleIndex;
+            child = middleIndex;
+        }
+
+        path.append(child);
+        node = child;
+        pos += common;
+    }
+    return path;
+}
+
+QVector<int> CityTrie::findPath(const QString& key) const
+{
+    QVector<int> path;
+    path.append(0);
+
+    int node = 0;
+    int pos = 0;
+    while (pos < key.size()) {
+        int child = -1;
+        for (int c : m_nodes[node].children) {
+            if (m_nodes[c].label.at(0) == key.at(pos)) {
+                child = c;
+                break;
+            }
+        }
+        if (child < 0 || !QStringView(key).mid(pos).startsWith(m_nodes[child].label)) {
+            return QVector<int>();
+        }
+        path.append(child);
+        node = child;
+        pos += m_nodes[child].label.size();
+    }
+    return path;
+}
+
+int CityTrie::itemFor(const QString& key)
+{
+    auto it = m_itemByKey.constFind(key);
+    if (it != m_itemByKey.cend()) return it.value();
+
+    int index;
+    if (!m_freeItems.isEmpty()) {
+        index = m_freeItems.takeLast();
+        m_items[index] = Item();
+    } else {
+        m_items.append(Item());
+        index = m_items.size() - 1;
+    }
+    m_items[index].key = key;
+    m_itemByKey.insert(key, index);
+    return index;
+}
+
+void CityTrie::promote(const QVector<int>& path, int item)
+{
+    // L'élément n'a pu que progresser : insertion triée dans chaque top-k
+    for (int node : path) {
+        QVector<int>& top = m_nodes[node].top;
+        top.removeOne(item);
+        auto pos = std::lower_bound(top.begin(), top.end(), item,
+                                    [this](int a, int b) { return ranksBefore(a, b); });
+        if (pos - top.begin() >= m_topK) continue;
+        top.insert(pos, item);
+        if (top.size() > m_topK) top.resize(m_topK);
+    }
+}
+
+void CityTrie::recompute(const QVector<int>& path)
+{
+    // Du bas vers la racine : fusion des top-k des enfants + élément propre
+    for (int i = path.size() - 1; i >= 0; --i) {
+        Node& node = m_nodes[path[i]];
+        QVector<int> candidates;
+        if (node.item >= 0) candidates.append(node.item);
+        for (int child : node.children) {
+            candidates += m_nodes[child].top;
+        }
+
+        auto rank = [this](int a, int b) { return ranksBefore(a, b); };
+        int keep = qMin(m_topK, int(candidates.size()));
+        std::partial_sort(candidates.begin(), candidates.begin() + keep, candidates.end(), rank);
+        candidates.resize(keep);
+        node.top = candidates;
+    }
+}
+
+void CityTrie::releaseIfUnused(const QString& key, int item)
+{
+    if (m_items[item].inHistory || m_items[item].inDictionary) return;
+
+    m_itemByKey.remove(key);
+    m_items[item] = Item();
+    m_freeItems.append(item);
+}
@@ -0,0 +1,72 @@
+#ifndef CITYTRIE_H
+#define CITYTRIE_H
+
+#include "SearchHistory.h"
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+
+/**
+ * Trie compressé (radix) pour l'auto-complétion des villes
+ *
+ * - Clés déjà normalisées (casse et accents repliés par SearchHistory)
+ * - Deux sources : historique (classé par SearchHistoryEntry::operator<)
+ *   et dictionnaire de noms (gazetteer, classé par poids, après l'historique)
+ * - Chaque nœud garde en cache les k meilleurs éléments de son sous-arbre :
+ *   une suggestion coûte O(longueur du préfixe), quel que soit le volume chargé
+ */
+class CityTrie
+{
+public:
+    explicit CityTrie(int topK = 10);
+
+    // Historique : insertion ou mise à jour du classement
+    void upsert(const QString& key, const SearchHistoryEntry& entry);
+    void remove(const QString& key);
+    void clearHistory();
+
+    // Dictionnaire : noms connus hors historique (weight : population, etc.)
+    void addDictionaryName(const QString& key, const QString& displayName, qint64 weight = 0);
+
+    void clear();
+
+    // Meilleures suggestions pour un préfixe normalisé (au plus topK)
+    QStringList suggestions(const QString& prefix, int maxCount) const;
+
+    int size() const { return m_itemByKey.size(); }
+    int topK() const { return m_topK; }
+
+private:
+    struct Item {
+        QString key;
+        QString displayName;
+        SearchHistoryEntry entry;   // Classement historique
+        qint64 weight = 0;          // Classement dictionnaire
+        bool inHistory = false;
+        bool inDictionary = false;
+    };
+
+    struct Node {
+        QString label;              // Fragment de clé porté par l'arête entrante
+        QVector<int> children;
+        int item = -1;              // Élément terminal (-1 si aucun)
+        QVector<int> top;           // k meilleurs éléments du sous-arbre, triés
+    };
+
+    QVector<Node> m_nodes;          // m_nodes[0] = racine
+    QVector<Item> m_items;
+    QVector<int> m_freeItems;
+    QHash<QString, int> m_itemByKey;
+    int m_topK;
+
+    bool ranksBefore(int a, int b) const;
+    QVector<int> insertPath(const QString& key);
+    QVector<int> findPath(const QString& key) const;
+    int itemFor(const QString& key);
+    void promote(const QVector<int>& path, int item);
+    void recompute(const QVector<int>& path);
+    void releaseIfUnused(const QString& key, int item);
+};
+
+#endif // CITYTRIE_H
@@ -6,6 +6,8 @@
 
 ConfigLoader::ConfigLoader()
     : m_isValid(false)
+    , m_rawPayloadMode(RawPayloadMode::Discard)
+    , m_cacheMemoryBudget(0)
 {
 }
 
@@ -15,6 +17,8 @@ bool ConfigLoader::loadConfig()
     m_isValid = false;
     m_apiKey.clear();
     m_errorMessage.clear();
+    m_rawPayloadMode = RawPayloadMode::Discard;
+    m_cacheMemoryBudget = 0;
 
     // Ouvrir le fichier config.json
     QFile configFile("config.json");
@@ -57,6 +61,9 @@ bool ConfigLoader::loadConfig()
     // Extraire la clé API
     QJsonObject config = doc.object();
 
+    // Réglages facultatifs du cache (indépendants de la clé)
+    loadCacheSettings(config["cache"].toObject());
+
     if (!config.contains("api_key")) {
         m_errorMessage = "Clé 'api_key' manquante dans config.json !\n"
                          "Format attendu :\n"
@@ -96,6 +103,32 @@ bool ConfigLoader::isValid() const
     return m_isValid;
 }
 
+RawPayloadMode ConfigLoader::getRawPayloadMode() const
+{
+    return m_rawPayloadMode;
+}
+
+qint64 ConfigLoader::getCacheMemoryBudget() const
+{
+    return m_cacheMemoryBudget;
+}
+
+void ConfigLoader::loadCacheSettings(const QJsonObject& cache)
+{
+    // Valeur inconnue : réglage par défaut, signalé sans bloquer le démarrage
+    const QString rawPayload = cache["raw_payload"].toString("discard").toLower();
+    if (rawPayload == "original") {
+        m_rawPayloadMode = RawPayloadMode::Original;
+    } else if (rawPayload == "compact") {
+        m_rawPayloadMode = RawPayloadMode::Compact;
+    } else if (rawPayload != "discard") {
+        qWarning() << "config.json: cache.raw_payload inconnu" << rawPayload << "- discard utilisé";
+    }
+
+    const int budgetMb = cache["memory_budget_mb"].toInt(0);
+    m_cacheMemoryBudget = qint64(qMax(0, budgetMb)) * 1024 * 1024;
+}
+
 QString ConfigLoader::getErrorMessage() const
 {
     return m_errorMessage;
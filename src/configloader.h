@@ -2,12 +2,16 @@
 #define CONFIGLOADER_H
 
 #include <QString>
+#include <QJsonObject>
+#include "ICacheManager.h"
 
 /**
  * Classe simple pour charger la configuration depuis config.json
  * - Lit le fichier config.json à la racine du projet
  * - Valide la clé API
  * - Gère les erreurs proprement
+ * - Lit les réglages facultatifs du cache :
+ *   "cache": { "raw_payload": "discard|original|compact", "memory_budget_mb": 64 }
  */
 class ConfigLoader
 {
@@ -20,6 +24,8 @@ public:
     // Accès aux données
     QString getApiKey() const;
     bool isValid() const;
+    RawPayloadMode getRawPayloadMode() const;   // Défaut: Discard
+    qint64 getCacheMemoryBudget() const;        // Octets, 0 = illimité (défaut)
 
     // Gestion des erreurs
     QString getErrorMessage() const;
@@ -27,11 +33,14 @@ public:
 private:
     // Validation
     bool isValidApiKey(const QString& key) const;
+    void loadCacheSettings(const QJsonObject& cache);
 
     // Données
     QString m_apiKey;
     QString m_errorMessage;
     bool m_isValid;
+    RawPayloadMode m_rawPayloadMode;
+    qint64 m_cacheMemoryBudget;
 };
 
 #endif // CONFIGLOADER_H
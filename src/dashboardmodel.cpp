@@ -0,0 +1,280 @@
+#include "dashboardmodel.h"
+#include "ICacheManager.h"
+#include <QBrush>
+#include <QColor>
+#include <algorithm>
+#include <climits>
+#include <functional>
+
+namespace {
+// Date de la donnée affichée : météo actuelle, sinon prévisions
+CacheInfo rowCacheInfo(const ICacheManager* cache, const CityKey& key)
+{
+    CacheInfo info = cache->getCacheInfo(key, WeatherDataType::Weather);
+    if (!info.cachedAt.isValid()) {
+        info = cache->getCacheInfo(key, WeatherDataType::Forecast);
+    }
+    return info;
+}
+
+QString formatAge(int minutes)
+{
+    if (minutes < 1) return QStringLiteral("< 1 min");
+    if (minutes < 60) return QString("%1 min").arg(minutes);
+    return QString("%1 h %2").arg(minutes / 60).arg(minutes % 60, 2, 10, QLatin1Char('0'));
+}
+}
+
+DashboardModel::DashboardModel(const ICacheManager* cache, QObject* parent)
+    : QAbstractTableModel(parent)
+    , m_cache(cache)
+    , m_flushTimer(new QTimer(this))
+    , m_ageTimer(new QTimer(this))
+{
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(FLUSH_INTERVAL_MS);
+    connect(m_flushTimer, &QTimer::timeout, this, &DashboardModel::flush);
+
+    // Colonne "âge" seulement : une notification pour toutes les lignes
+    m_ageTimer->setInterval(AGE_REFRESH_MS);
+    connect(m_ageTimer, &QTimer::timeout, this, [this]() {
+        if (!m_rows.isEmpty()) {
+            emit dataChanged(index(0, AgeColumn), index(int(m_rows.size()) - 1, AgeColumn),
+                             {Qt::DisplayRole, SortRole, StaleRole, Qt::ForegroundRole});
+        }
+    });
+    m_ageTimer->start();
+
+    reload();
+}
+
+// =====================================================
+// QAbstractTableModel
+// =====================================================
+
+int DashboardModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : int(m_rows.size());
+}
+
+int DashboardModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant DashboardModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_rows.size()) {
+        return QVariant();
+    }
+    const Row& row = m_rows.at(index.row());
+
+    if (role == CityKeyRole) {
+        return row.key.toString();
+    }
+
+    // Une recherche par cellule visible ; la poignée partage l'entrée du cache
+    const CurrentWeatherPtr weather = m_cache->peekWeather(row.key);
+    const CacheInfo info = rowCacheInfo(m_cache, row.key);
+    const bool stale = !weather || !info.isValid();
+
+    if (role == StaleRole) {
+        return stale;
+    }
+    if (role == Qt::ForegroundRole) {
+        return stale ? QVariant(QBrush(QColor(Qt::gray))) : QVariant();
+    }
+    if (role == Qt::TextAlignmentRole) {
+        return index.column() == CityColumn || index.column() == ConditionsColumn
+                   ? QVariant(int(Qt::AlignLeft | Qt::AlignVCenter))
+                   : QVariant(int(Qt::AlignRight | Qt::AlignVCenter));
+    }
+    if (role != Qt::DisplayRole && role != SortRole) {
+        return QVariant();
+    }
+    const bool sorting = role == SortRole;
+
+    switch (index.column()) {
+    case CityColumn:
+        if (weather && !weather->cityName.isEmpty()) {
+            return weather->countryCode.isEmpty() || sorting
+                       ? weather->cityName
+                       : QString("%1, %2").arg(weather->cityName, weather->countryCode);
+        }
+        return row.name;
+    case TemperatureColumn:
+        if (!weather) return sorting ? QVariant(-1000.0) : QVariant(QStringLiteral("—"));
+        return sorting ? QVariant(weather->temperature)
+                       : QVariant(QString("%1°C").arg(weather->temperature, 0, 'f', 1));
+    case WindColumn:
+        if (!weather) return sorting ? QVariant(-1.0) : QVariant(QStringLiteral("—"));
+        return sorting ? QVariant(weather->windSpeed)
+                       : QVariant(QString("%1 m/s (%2°)").arg(weather->windSpeed, 0, 'f', 1)
+                                      .arg(weather->windDirection));
+    case ConditionsColumn:
+        if (!weather) return sorting ? QString() : QStringLiteral("—");
+        return weather->description.isEmpty() ? weather->mainCondition : weather->description;
+    case AgeColumn: {
+        if (!info.cachedAt.isValid()) return sorting ? QVariant(INT_MAX) : QVariant(QStringLiteral("—"));
+        const int minutes = qAbs(info.ageMinutes());
+        return sorting ? QVariant(minutes) : QVariant(formatAge(minutes));
+    }
+    default:
+        return QVariant();
+    }
+}
+
+QVariant DashboardModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole) {
+        return QAbstractTableModel::headerData(section, orientation, role);
+    }
+    switch (section) {
+    case CityColumn: return QStringLiteral("Ville");
+    case TemperatureColumn: return QStringLiteral("Température");
+    case WindColumn: return QStringLiteral("Vent");
+    case ConditionsColumn: return QStringLiteral("Conditions");
+    case AgeColumn: return QStringLiteral("Âge");
+    default: return QVariant();
+    }
+}
+
+CityKey DashboardModel::keyAt(int row) const
+{
+    return row >= 0 && row < m_rows.size() ? m_rows.at(row).key : CityKey();
+}
+
+QString DashboardModel::cityAt(int row) const
+{
+    return row >= 0 && row < m_rows.size() ? m_rows.at(row).name : QString();
+}
+
+int DashboardModel::rowOf(const CityKey& key) const
+{
+    return m_rowOf.value(key, -1);
+}
+
+// =====================================================
+// MISES À JOUR REGROUPÉES
+// =====================================================
+
+void DashboardModel::cityUpdated(const CityKey& key, const QString& cityName)
+{
+    if (key.isEmpty()) return;
+
+    // Plusieurs notifications pour la même ville (météo + prévisions) : une seule ligne touchée
+    m_pending.insert(key, cityName);
+    if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
+}
+
+void DashboardModel::flush()
+{
+    m_flushTimer->stop();
+    if (m_pending.isEmpty()) return;
+
+    QList<Row> added;
+    QList<int> changed;
+    QList<int> removed;
+    for (auto it = m_pending.cbegin(); it != m_pending.cend(); ++it) {
+        const int row = rowOf(it.key());
+        const bool cached = isCached(it.key());
+        if (row < 0) {
+            if (cached) added.append({it.key(), it.value()});
+        } else if (!cached) {
+            removed.append(row);
+        } else {
+            if (!it.value().isEmpty()) m_rows[row].name = it.value();
+            changed.append(row);
+        }
+    }
+    m_pending.clear();
+
+    // Lignes modifiées avant les retraits (indices encore valides)
+    emitRowRanges(changed);
+    removeCityRows(removed);
+
+    // Nouvelles villes : une seule insertion en fin de tableau (le proxy trie)
+    if (!added.isEmpty()) {
+        const int first = int(m_rows.size());
+        beginInsertRows(QModelIndex(), first, first + int(added.size()) - 1);
+        m_rows.append(added);
+        rebuildIndex(first);
+        endInsertRows();
+    }
+}
+
+void DashboardModel::reload()
+{
+    m_flushTimer->stop();
+    m_pending.clear();
+
+    beginResetModel();
+    m_rows.clear();
+    const QList<CityKey> keys = m_cache->cachedKeys();
+    m_rows.reserve(keys.size());
+    for (const CityKey& key : keys) {
+        m_rows.append({key, key.toString()});
+    }
+    m_rowOf.clear();
+    rebuildIndex(0);
+    endResetModel();
+}
+
+// =====================================================
+// UTILITAIRES
+// =====================================================
+
+bool DashboardModel::isCached(const CityKey& key) const
+{
+    return m_cache->getCacheInfo(key, WeatherDataType::Weather).cachedAt.isValid()
+           || m_cache->getCacheInfo(key, WeatherDataType::Forecast).cachedAt.isValid();
+}
+
+void DashboardModel::removeCityRows(QList<int> rows)
+{
+    // Du bas vers le haut : une plage contiguë par notification
+    std::sort(rows.begin(), rows.end(), std::greater<int>());
+    int i = 0;
+    while (i < rows.size()) {
+        int last = rows.at(i);
+        int first = last;
+        while (i + 1 < rows.size() && rows.at(i + 1) == first - 1) {
+            first = rows.at(++i);
+        }
+        ++i;
+
+        beginRemoveRows(QModelIndex(), first, last);
+        for (int row = first; row <= last; ++row) {
+            m_rowOf.remove(m_rows.at(row).key);
+        }
+        m_rows.remove(first, last - first + 1);
+        endRemoveRows();
+    }
+    if (!rows.isEmpty()) {
+        rebuildIndex(rows.last());
+    }
+}
+
+void DashboardModel::emitRowRanges(QList<int> rows)
+{
+    std::sort(rows.begin(), rows.end());
+    int i = 0;
+    while (i < rows.size()) {
+        const int first = rows.at(i);
+        int last = first;
+        while (i + 1 < rows.size() && rows.at(i + 1) == last + 1) {
+            last = rows.at(++i);
+        }
+        ++i;
+        emit dataChanged(index(first, 0), index(last, ColumnCount - 1));
+    }
+}
+
+void DashboardModel::rebuildIndex(int fromRow)
+{
+    for (int row = fromRow; row < m_rows.size(); ++row) {
+        m_rowOf.insert(m_rows.at(row).key, row);
+    }
+}
@@ -0,0 +1,94 @@
+#ifndef DASHBOARDMODEL_H
+#define DASHBOARDMODEL_H
+
+#include "citykey.h"
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QList>
+#include <QTimer>
+
+class ICacheManager;
+
+/**
+ * Tableau de bord multi-villes (une ligne par ville en cache)
+ *
+ * - Le modèle ne garde que la clé et le nom de chaque ligne : température,
+ *   vent, conditions et âge sont lus dans le cache au moment de l'affichage
+ *   (lignes visibles seulement, la vue étant virtualisée)
+ * - Les mises à jour du cache sont regroupées : cityUpdated() ne fait que
+ *   noter la ville, flush() émet une insertion pour les nouvelles villes et
+ *   un dataChanged par plage de lignes contiguës
+ * - Tri et filtre par QSortFilterProxyModel (SortRole : valeurs brutes)
+ */
+class DashboardModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        CityColumn,
+        TemperatureColumn,
+        WindColumn,
+        ConditionsColumn,
+        AgeColumn,
+        ColumnCount
+    };
+
+    enum Roles {
+        SortRole = Qt::UserRole + 1,   // Valeur numérique / texte brut pour le tri
+        CityKeyRole,                   // Forme texte de la clé (identifiant ou nom normalisé)
+        StaleRole                      // Données expirées ou absentes
+    };
+
+    static constexpr int FLUSH_INTERVAL_MS = 100;
+    static constexpr int AGE_REFRESH_MS = 60 * 1000;
+
+    explicit DashboardModel(const ICacheManager* cache, QObject* parent = nullptr);
+
+    // QAbstractTableModel
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    CityKey keyAt(int row) const;
+    QString cityAt(int row) const;     // Nom utilisé pour les requêtes
+    int rowOf(const CityKey& key) const;
+
+    int pendingCount() const { return int(m_pending.size()); }
+
+public slots:
+    /**
+     * Note une ville mise à jour ; affichée au prochain flush()
+     *
+     * @param key Clé de cache
+     * @param cityName Nom utilisé pour les requêtes (celui des signaux du service)
+     */
+    void cityUpdated(const CityKey& key, const QString& cityName);
+
+    // Applique les mises à jour en attente (ajouts, retraits, dataChanged)
+    void flush();
+
+    // Relit toutes les villes du cache (après un vidage)
+    void reload();
+
+private:
+    struct Row {
+        CityKey key;
+        QString name;
+    };
+
+    const ICacheManager* m_cache;
+    QList<Row> m_rows;
+    QHash<CityKey, int> m_rowOf;
+    QHash<CityKey, QString> m_pending;   // Clé → nom, en attente du prochain flush
+    QTimer* m_flushTimer;
+    QTimer* m_ageTimer;
+
+    bool isCached(const CityKey& key) const;
+    void removeCityRows(QList<int> rows);
+    void emitRowRanges(QList<int> rows);
+    void rebuildIndex(int fromRow);
+};
+
+#endif // DASHBOARDMODEL_H
@@ -0,0 +1,178 @@
+#include "dashboardwidget.h"
+#include "dashboardmodel.h"
+#include <QHBoxLayout>
+#include <QHeaderView>
+#include <QLabel>
+#include <QLineEdit>
+#include <QPushButton>
+#include <QScrollBar>
+#include <QSortFilterProxyModel>
+#include <QTableView>
+#include <QVBoxLayout>
+#include <algorithm>
+
+DashboardWidget::DashboardWidget(const ICacheManager* cache, QWidget* parent)
+    : QWidget(parent)
+    , m_model(new DashboardModel(cache, this))
+    , m_proxy(new QSortFilterProxyModel(this))
+    , m_view(new QTableView(this))
+    , m_filterEdit(new QLineEdit(this))
+    , m_countLabel(new QLabel(this))
+    , m_compareButton(new QPushButton("Comparer", this))
+    , m_visibleTimer(new QTimer(this))
+{
+    // Tri sur les valeurs brutes, filtre sur le nom de la ville
+    m_proxy->setSourceModel(m_model);
+    m_proxy->setSortRole(DashboardModel::SortRole);
+    m_proxy->setFilterKeyColumn(DashboardModel::CityColumn);
+    m_proxy->setFilterCaseSensitivity(Qt::CaseInsensitive);
+    m_proxy->setDynamicSortFilter(true);
+
+    m_view->setModel(m_proxy);
+    m_view->setSortingEnabled(true);
+    m_view->sortByColumn(DashboardModel::CityColumn, Qt::AscendingOrder);
+    m_view->setSelectionBehavior(QAbstractItemView::SelectRows);
+    m_view->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_view->setAlternatingRowColors(true);
+    m_view->setWordWrap(false);
+    m_view->verticalHeader()->setVisible(false);
+    // Hauteur de ligne fixe : aucune mesure du contenu, défilement en O(1)
+    m_view->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    m_view->verticalHeader()->setDefaultSectionSize(m_view->fontMetrics().height() + 6);
+    m_view->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+    m_view->horizontalHeader()->setStretchLastSection(true);
+
+    m_filterEdit->setPlaceholderText("Filtrer les villes...");
+    m_filterEdit->setClearButtonEnabled(true);
+
+    QHBoxLayout* filterLayout = new QHBoxLayout();
+    filterLayout->addWidget(m_filterEdit, 1);
+    filterLayout->addWidget(m_countLabel);
+    filterLayout->addWidget(m_compareButton);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addLayout(filterLayout);
+    layout->addWidget(m_view);
+
+    connect(m_filterEdit, &QLineEdit::textChanged, this, [this](const QString& text) {
+        m_proxy->setFilterFixedString(text.trimmed());
+    });
+    connect(m_view, &QTableView::activated, this, [this](const QModelIndex& index) {
+        const int row = m_proxy->mapToSource(index).row();
+        emit cityActivated(m_model->cityAt(row));
+    });
+
+    // Comparaison : au moins deux villes sélectionnées
+    m_compareButton->setToolTip("Superposer les prévisions de température des villes sélectionnées");
+    connect(m_compareButton, &QPushButton::clicked, this, [this]() {
+        const QStringList cities = selectedCities();
+        if (cities.size() >= 2) {
+            emit comparisonRequested(cities);
+        }
+    });
+    connect(m_view->selectionModel(), &QItemSelectionModel::selectionChanged,
+            this, &DashboardWidget::updateCompareButton);
+    connect(m_proxy, &QAbstractItemModel::modelReset, this, &DashboardWidget::updateCompareButton);
+    connect(m_proxy, &QAbstractItemModel::rowsRemoved, this, &DashboardWidget::updateCompareButton);
+    updateCompareButton();
+
+    // Villes visibles : recalculées une fois par rafale de défilement / mises à jour
+    m_visibleTimer->setSingleShot(true);
+    m_visibleTimer->setInterval(VISIBLE_DEBOUNCE_MS);
+    connect(m_visibleTimer, &QTimer::timeout, this, &DashboardWidget::publishVisibleCities);
+    connect(m_view->verticalScrollBar(), &QScrollBar::valueChanged, this, &DashboardWidget::scheduleVisibleUpdate);
+    connect(m_proxy, &QAbstractItemModel::layoutChanged, this, &DashboardWidget::scheduleVisibleUpdate);
+    connect(m_proxy, &QAbstractItemModel::modelReset, this, &DashboardWidget::scheduleVisibleUpdate);
+    connect(m_proxy, &QAbstractItemModel::rowsInserted, this, &DashboardWidget::scheduleVisibleUpdate);
+    connect(m_proxy, &QAbstractItemModel::rowsRemoved, this, &DashboardWidget::scheduleVisibleUpdate);
+
+    connect(m_proxy, &QAbstractItemModel::modelReset, this, &DashboardWidget::updateCountLabel);
+    connect(m_proxy, &QAbstractItemModel::rowsInserted, this, &DashboardWidget::updateCountLabel);
+    connect(m_proxy, &QAbstractItemModel::rowsRemoved, this, &DashboardWidget::updateCountLabel);
+    updateCountLabel();
+}
+
+QStringList DashboardWidget::visibleCities() const
+{
+    QStringList cities;
+    const int rows = m_proxy->rowCount();
+    if (rows == 0 || !m_view->isVisible()) {
+        return cities;
+    }
+
+    // Première et dernière ligne sous le viewport (lignes partiellement visibles incluses)
+    int first = m_view->rowAt(0);
+    int last = m_view->rowAt(m_view->viewport()->height() - 1);
+    if (first < 0) first = 0;
+    if (last < 0) last = rows - 1;
+
+    cities.reserve(last - first + 1);
+    for (int row = first; row <= last; ++row) {
+        const QModelIndex source = m_proxy->mapToSource(m_proxy->index(row, 0));
+        cities.append(m_model->cityAt(source.row()));
+    }
+    return cities;
+}
+
+QStringList DashboardWidget::selectedCities() const
+{
+    QModelIndexList rows = m_view->selectionModel()->selectedRows(DashboardModel::CityColumn);
+    std::sort(rows.begin(), rows.end(),
+              [](const QModelIndex& a, const QModelIndex& b) { return a.row() < b.row(); });
+
+    QStringList cities;
+    cities.reserve(rows.size());
+    for (const QModelIndex& index : std::as_const(rows)) {
+        cities.append(m_model->cityAt(m_proxy->mapToSource(index).row()));
+    }
+    return cities;
+}
+
+void DashboardWidget::showEvent(QShowEvent* event)
+{
+    QWidget::showEvent(event);
+    scheduleVisibleUpdate();
+}
+
+void DashboardWidget::hideEvent(QHideEvent* event)
+{
+    QWidget::hideEvent(event);
+    m_visibleTimer->stop();
+    if (!m_lastVisible.isEmpty()) {
+        m_lastVisible.clear();
+        emit visibleCitiesChanged(m_lastVisible);
+    }
+}
+
+void DashboardWidget::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    scheduleVisibleUpdate();
+}
+
+void DashboardWidget::scheduleVisibleUpdate()
+{
+    if (!m_visibleTimer->isActive()) {
+        m_visibleTimer->start();
+    }
+}
+
+void DashboardWidget::publishVisibleCities()
+{
+    const QStringList cities = visibleCities();
+    if (cities == m_lastVisible) return;
+
+    m_lastVisible = cities;
+    emit visibleCitiesChanged(cities);
+}
+
+void DashboardWidget::updateCountLabel()
+{
+    m_countLabel->setText(QString("%1 / %2 villes").arg(m_proxy->rowCount()).arg(m_model->rowCount()));
+}
+
+void DashboardWidget::updateCompareButton()
+{
+    m_compareButton->setEnabled(m_view->selectionModel()->selectedRows().size() >= 2);
+}
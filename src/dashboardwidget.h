@@ -0,0 +1,75 @@
+#ifndef DASHBOARDWIDGET_H
+#define DASHBOARDWIDGET_H
+
+#include <QWidget>
+#include <QStringList>
+#include <QTimer>
+
+class QLineEdit;
+class QLabel;
+class QPushButton;
+class QTableView;
+class QSortFilterProxyModel;
+class DashboardModel;
+class ICacheManager;
+
+/**
+ * Onglet "Tableau de bord" : grille de toutes les villes en cache
+ *
+ * - QTableView virtualisé sur DashboardModel, à travers un
+ *   QSortFilterProxyModel (tri par colonne, filtre sur le nom) : le proxy
+ *   ne garde que des indices, aucune donnée n'est copiée
+ * - Après un défilement, un redimensionnement, un tri ou un filtre, les
+ *   villes visibles sont recalculées (regroupé, une fois par rafale) et
+ *   publiées par visibleCitiesChanged() : elles sont rafraîchies en premier
+ *   (liste vide quand l'onglet est masqué)
+ * - Sélection multiple : "Comparer" publie les villes sélectionnées par
+ *   comparisonRequested() (courbes de température superposées)
+ */
+class DashboardWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr int VISIBLE_DEBOUNCE_MS = 150;
+
+    explicit DashboardWidget(const ICacheManager* cache, QWidget* parent = nullptr);
+
+    DashboardModel* model() const { return m_model; }
+    QSortFilterProxyModel* proxy() const { return m_proxy; }
+    QTableView* view() const { return m_view; }
+
+    // Noms des villes affichées à l'écran, de haut en bas
+    QStringList visibleCities() const;
+    // Noms des villes sélectionnées, dans l'ordre affiché
+    QStringList selectedCities() const;
+
+signals:
+    void visibleCitiesChanged(const QStringList& cityNames);
+    void cityActivated(const QString& cityName);
+    void comparisonRequested(const QStringList& cityNames);
+
+protected:
+    void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+
+private slots:
+    void scheduleVisibleUpdate();
+    void publishVisibleCities();
+
+private:
+    DashboardModel* m_model;
+    QSortFilterProxyModel* m_proxy;
+    QTableView* m_view;
+    QLineEdit* m_filterEdit;
+    QLabel* m_countLabel;
+    QPushButton* m_compareButton;
+    QTimer* m_visibleTimer;
+    QStringList m_lastVisible;
+
+    void updateCountLabel();
+    void updateCompareButton();
+};
+
+#endif // DASHBOARDWIDGET_H
@@ -0,0 +1,141 @@
+#include "derivedmetrics.h"
+#include "WeatherData.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+// Magnus (Alduchov & Eskridge), valable de -45 à 60 °C
+constexpr double MAGNUS_A = 17.62;
+constexpr double MAGNUS_B = 243.12;
+
+// Seuils d'application des indices
+constexpr double HEAT_INDEX_MIN_F = 80.0;       // 26,7 °C
+constexpr double WIND_CHILL_MAX_C = 10.0;
+constexpr double WIND_CHILL_MIN_KMH = 4.8;
+
+inline double dewPoint(double temperature, double humidity)
+{
+    const double relative = std::clamp(humidity, 1.0, 100.0) / 100.0;
+    const double gamma = std::log(relative) + MAGNUS_A * temperature / (MAGNUS_B + temperature);
+    return MAGNUS_B * gamma / (MAGNUS_A - gamma);
+}
+
+// Régression de Rothfusz (NOAA), calculée en °F
+inline double heatIndex(double temperature, double humidity)
+{
+    const double f = temperature * 9.0 / 5.0 + 32.0;
+    const double rh = humidity;
+    const double index = -42.379 + 2.04901523 * f + 10.14333127 * rh
+                         - 0.22475541 * f * rh - 0.00683783 * f * f
+                         - 0.05481717 * rh * rh + 0.00122874 * f * f * rh
+                         + 0.00085282 * f * rh * rh - 0.00000199 * f * f * rh * rh;
+    return f >= HEAT_INDEX_MIN_F ? (index - 32.0) * 5.0 / 9.0 : temperature;
+}
+
+// Formule Environnement Canada / NWS (vent en km/h)
+inline double windChill(double temperature, double windSpeedMs)
+{
+    const double kmh = windSpeedMs * 3.6;
+    const double factor = std::pow(std::max(kmh, WIND_CHILL_MIN_KMH), 0.16);
+    const double chill = 13.12 + 0.6215 * temperature - 11.37 * factor + 0.3965 * temperature * factor;
+    return (temperature <= WIND_CHILL_MAX_C && kmh > WIND_CHILL_MIN_KMH) ? chill : temperature;
+}
+
+} // namespace
+
+namespace WeatherMetrics {
+
+void computeColumns(const Columns& columns, DerivedMetrics* out)
+{
+    const qsizetype count = columns.count;
+    if (count <= 0) return;
+
+    // Une colonne de sortie par grandeur, puis regroupement par élément
+    std::vector<double> dew(size_t(count));
+    std::vector<double> heat(size_t(count));
+    std::vector<double> chill(size_t(count));
+
+    for (qsizetype i = 0; i < count; ++i) {
+        dew[size_t(i)] = dewPoint(columns.temperature[i], columns.humidity[i]);
+    }
+    for (qsizetype i = 0; i < count; ++i) {
+        heat[size_t(i)] = heatIndex(columns.temperature[i], columns.humidity[i]);
+    }
+    for (qsizetype i = 0; i < count; ++i) {
+        chill[size_t(i)] = windChill(columns.temperature[i], columns.windSpeed[i]);
+    }
+
+    for (qsizetype i = 0; i < count; ++i) {
+        DerivedMetrics& metrics = out[i];
+        metrics.dewPoint = dew[size_t(i)];
+        metrics.heatIndex = heat[size_t(i)];
+        metrics.windChill = chill[size_t(i)];
+        metrics.feelsLikeDelta = columns.feelsLike[i] - columns.temperature[i];
+    }
+}
+
+DerivedMetrics compute(const CurrentWeatherData& data)
+{
+    DerivedMetrics metrics;
+    metrics.dewPoint = dewPoint(data.temperature, data.humidity);
+    metrics.heatIndex = heatIndex(data.temperature, data.humidity);
+    metrics.windChill = windChill(data.temperature, data.windSpeed);
+    metrics.feelsLikeDelta = data.feelsLike - data.temperature;
+    if (data.sunrise.isValid() && data.sunset.isValid()) {
+        metrics.daylightSeconds = data.sunrise.secsTo(data.sunset);
+    }
+    return metrics;
+}
+
+QList<DerivedMetrics> compute(const ForecastData& data)
+{
+    const qsizetype count = data.entries.size();
+    std::vector<double> temperature(size_t(count));
+    std::vector<double> humidity(size_t(count));
+    std::vector<double> windSpeed(size_t(count));
+    std::vector<double> feelsLike(size_t(count));
+    for (qsizetype i = 0; i < count; ++i) {
+        const ForecastEntry& entry = data.entries[int(i)];
+        temperature[size_t(i)] = entry.temperature;
+        humidity[size_t(i)] = entry.humidity;
+        windSpeed[size_t(i)] = entry.windSpeed;
+        feelsLike[size_t(i)] = entry.feelsLike;
+    }
+
+    QList<DerivedMetrics> result(count);
+    computeColumns({temperature.data(), humidity.data(), windSpeed.data(), feelsLike.data(), count},
+                   result.data());
+    return result;
+}
+
+QList<DerivedMetrics> computeBatch(const QList<const CurrentWeatherData*>& cities)
+{
+    const qsizetype count = cities.size();
+    std::vector<double> temperature(size_t(count));
+    std::vector<double> humidity(size_t(count));
+    std::vector<double> windSpeed(size_t(count));
+    std::vector<double> feelsLike(size_t(count));
+    for (qsizetype i = 0; i < count; ++i) {
+        temperature[size_t(i)] = cities[i]->temperature;
+        humidity[size_t(i)] = cities[i]->humidity;
+        windSpeed[size_t(i)] = cities[i]->windSpeed;
+        feelsLike[size_t(i)] = cities[i]->feelsLike;
+    }
+
+    QList<DerivedMetrics> result(count);
+    computeColumns({temperature.data(), humidity.data(), windSpeed.data(), feelsLike.data(), count},
+                   result.data());
+
+    // La durée du jour ne dépend que des horaires : pas de colonne
+    for (qsizetype i = 0; i < count; ++i) {
+        const CurrentWeatherData& city = *cities[i];
+        if (city.sunrise.isValid() && city.sunset.isValid()) {
+            result[i].daylightSeconds = city.sunrise.secsTo(city.sunset);
+        }
+    }
+    return result;
+}
+
+} // namespace WeatherMetrics
@@ -0,0 +1,58 @@
+#ifndef DERIVEDMETRICS_H
+#define DERIVEDMETRICS_H
+
+#include <QList>
+#include <QtGlobal>
+#include <memory>
+
+struct CurrentWeatherData;
+struct ForecastData;
+
+/**
+ * Grandeurs dérivées d'une observation (ou d'un créneau de prévision)
+ *
+ * Calculées à la demande et mémorisées avec l'entrée du cache : une
+ * entrée remplacée repart sans valeurs, rien n'est à invalider à la main.
+ */
+struct DerivedMetrics {
+    double dewPoint = 0.0;          // Point de rosée (°C, formule de Magnus)
+    double heatIndex = 0.0;         // Indice de chaleur (°C, NOAA ; = température sous 26,7 °C)
+    double windChill = 0.0;         // Refroidissement éolien (°C ; = température au-dessus de 10 °C ou vent < 4,8 km/h)
+    double feelsLikeDelta = 0.0;    // Ressenti fourni par l'API - température
+    qint64 daylightSeconds = -1;    // Durée du jour (lever → coucher), -1 si inconnue
+};
+
+// Partagées et immuables, comme les données dont elles dérivent
+using DerivedMetricsPtr = std::shared_ptr<const DerivedMetrics>;
+using ForecastMetricsPtr = std::shared_ptr<const QList<DerivedMetrics>>; // Un élément par créneau
+
+namespace WeatherMetrics {
+
+// Une observation
+DerivedMetrics compute(const CurrentWeatherData& data);
+
+// Tous les créneaux d'une prévision, en un passage sur colonnes
+QList<DerivedMetrics> compute(const ForecastData& data);
+
+/**
+ * Calcul groupé sur colonnes contiguës (une valeur par ville ou par créneau)
+ *
+ * Boucles sans branchement sur des tableaux séparés : vectorisables par le
+ * compilateur ; exp/log/pow le sont si sa bibliothèque mathématique
+ * vectorielle est disponible.
+ */
+struct Columns {
+    const double* temperature = nullptr;
+    const double* humidity = nullptr;
+    const double* windSpeed = nullptr;  // m/s
+    const double* feelsLike = nullptr;
+    qsizetype count = 0;
+};
+void computeColumns(const Columns& columns, DerivedMetrics* out);
+
+// Plusieurs villes en un passage (mêmes résultats que compute() ville par ville)
+QList<DerivedMetrics> computeBatch(const QList<const CurrentWeatherData*>& cities);
+
+} // namespace WeatherMetrics
+
+#endif // DERIVEDMETRICS_H
@@ -0,0 +1,268 @@
+#include "heatmapgrid.h"
+#include <QtConcurrent>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace {
+constexpr float NO_VALUE = std::numeric_limits<float>::quiet_NaN();
+constexpr double SAME_PLACE_KM = 1.0;          // En deçà : valeur de la ville telle quelle
+
+int wrap(int column, int columns)
+{
+    return ((column % columns) + columns) % columns;
+}
+}
+
+HeatmapGrid::HeatmapGrid(double cellDegrees, double influenceRadiusKm)
+    : m_radiusKm(qMax(1.0, influenceRadiusKm))
+    , m_dirtyCount(0)
+    , m_minimum(0.0)
+    , m_maximum(1.0)
+{
+    // Nombre pair de colonnes : cases carrées, rows = columns / 2
+    m_rows = qMax(1, int(std::lround(180.0 / qBound(0.1, cellDegrees, 90.0))));
+    m_columns = 2 * m_rows;
+    m_cellDegrees = 180.0 / m_rows;
+
+    const int cells = m_columns * m_rows;
+    m_values = QVector<float>(cells, NO_VALUE);
+    m_coverage = QVector<float>(cells, 0.0f);
+    m_dirty = QVector<bool>(cells, false);
+
+    m_image = QImage(m_columns, m_rows, QImage::Format_ARGB32_Premultiplied);
+    m_image.fill(Qt::transparent);
+
+    setPalette({{0.0, QColor(0x19, 0x76, 0xD2)}, {0.5, QColor(0xFB, 0xC0, 0x2D)}, {1.0, QColor(0xD3, 0x2F, 0x2F)}},
+               0.0, 1.0);
+}
+
+// =====================================================
+// ÉCHANTILLONS
+// =====================================================
+
+void HeatmapGrid::setSample(const CityKey& key, double latitude, double longitude, double value)
+{
+    auto it = m_samples.find(key);
+    if (it != m_samples.end()) {
+        Sample& sample = it.value();
+        if (sample.latitude == latitude && sample.longitude == longitude && sample.value == value) {
+            return;
+        }
+        // Ancienne position : ces cases perdent (ou changent) une voisine
+        if (sample.latitude != latitude || sample.longitude != longitude) {
+            markAround(sample.latitude, sample.longitude);
+        }
+        sample = {latitude, longitude, value};
+    } else {
+        m_samples.insert(key, {latitude, longitude, value});
+    }
+    m_index.insert(key, latitude, longitude);
+    markAround(latitude, longitude);
+}
+
+bool HeatmapGrid::removeSample(const CityKey& key)
+{
+    auto it = m_samples.find(key);
+    if (it == m_samples.end()) return false;
+    markAround(it.value().latitude, it.value().longitude);
+    m_index.remove(key);
+    m_samples.erase(it);
+    return true;
+}
+
+void HeatmapGrid::clear()
+{
+    m_samples.clear();
+    m_index.clear();
+    m_values.fill(NO_VALUE);
+    m_coverage.fill(0.0f);
+    m_dirty.fill(false);
+    m_dirtyCount = 0;
+    m_image.fill(Qt::transparent);
+}
+
+void HeatmapGrid::markAround(double latitude, double longitude)
+{
+    // Cases dont le centre est dans le rayon d'influence (une colonne de marge)
+    const double angular = m_radiusKm / CitySpatialIndex::EARTH_RADIUS_KM;
+    const double radiusDegrees = qRadiansToDegrees(angular);
+    const double sinHalfRadius = std::sin(angular / 2);
+    const double cosLatitude = std::cos(qDegreesToRadians(latitude));
+
+    const int firstRow = qBound(0, int(std::floor((90.0 - (latitude + radiusDegrees)) / m_cellDegrees)), m_rows - 1);
+    const int lastRow = qBound(0, int(std::floor((90.0 - (latitude - radiusDegrees)) / m_cellDegrees)), m_rows - 1);
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        const double rowLatitude = 90.0 - (row + 0.5) * m_cellDegrees;
+        const double sinHalfLatitude = std::sin(qDegreesToRadians(rowLatitude - latitude) / 2);
+        const double denominator = std::cos(qDegreesToRadians(rowLatitude)) * cosLatitude;
+
+        // Demi-largeur en longitude du cercle sur cette ligne (haversine inversée)
+        int firstColumn = 0;
+        int lastColumn = m_columns - 1;
+        if (denominator > 1e-12) {
+            const double s = (sinHalfRadius * sinHalfRadius - sinHalfLatitude * sinHalfLatitude) / denominator;
+            if (s < 0.0) continue;
+            if (s < 1.0) {
+                const double halfWidth = qRadiansToDegrees(2.0 * std::asin(std::sqrt(s)));
+                firstColumn = int(std::ceil((longitude - halfWidth + 180.0) / m_cellDegrees - 0.5)) - 1;
+                lastColumn = int(std::floor((longitude + halfWidth + 180.0) / m_cellDegrees - 0.5)) + 1;
+                lastColumn = qMin(lastColumn, firstColumn + m_columns - 1);
+            }
+        }
+
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const int index = row * m_columns + wrap(column, m_columns);
+            if (!m_dirty[index]) {
+                m_dirty[index] = true;
+                ++m_dirtyCount;
+            }
+        }
+    }
+}
+
+// =====================================================
+// CALCUL
+// =====================================================
+
+int HeatmapGrid::update()
+{
+    if (m_dirtyCount == 0) return 0;
+
+    QVector<int> dirtyRows;
+    for (int row = 0; row < m_rows; ++row) {
+        const bool* first = m_dirty.constData() + row * m_columns;
+        if (std::find(first, first + m_columns, true) != first + m_columns) {
+            dirtyRows.append(row);
+        }
+    }
+
+    // Pointeurs pris ici : les threads n'écrivent que dans leurs lignes.
+    // bits() détache l'image si une copie est encore affichée
+    Targets targets;
+    targets.values = m_values.data();
+    targets.coverage = m_coverage.data();
+    targets.dirty = m_dirty.data();
+    targets.bits = m_image.bits();
+    targets.bytesPerLine = m_image.bytesPerLine();
+
+    if (dirtyRows.size() < PARALLEL_MIN_ROWS) {
+        for (int row : std::as_const(dirtyRows)) {
+            computeRow(row, targets);
+        }
+    } else {
+        QtConcurrent::blockingMap(dirtyRows, [this, &targets](int row) { computeRow(row, targets); });
+    }
+
+    const int updated = m_dirtyCount;
+    m_dirtyCount = 0;
+    return updated;
+}
+
+void HeatmapGrid::computeRow(int row, const Targets& targets) const
+{
+    const double latitude = 90.0 - (row + 0.5) * m_cellDegrees;
+    QRgb* line = reinterpret_cast<QRgb*>(targets.bits + row * targets.bytesPerLine);
+
+    for (int column = 0; column < m_columns; ++column) {
+        const int index = row * m_columns + column;
+        if (!targets.dirty[index]) continue;
+        targets.dirty[index] = false;
+
+        const double longitude = -180.0 + (column + 0.5) * m_cellDegrees;
+        const QList<CityKey> neighbours = m_index.nearest(latitude, longitude, MAX_NEIGHBOURS, m_radiusKm);
+
+        float value = NO_VALUE;
+        float coverage = 0.0f;
+        if (!neighbours.isEmpty()) {
+            double weightSum = 0.0;
+            double weighted = 0.0;
+            double closest = m_radiusKm;
+            for (const CityKey& key : neighbours) {
+                const Sample& sample = *m_samples.constFind(key);
+                const double distance = CitySpatialIndex::distanceKm(latitude, longitude,
+                                                                     sample.latitude, sample.longitude);
+                closest = qMin(closest, distance);
+                if (distance < SAME_PLACE_KM) {
+                    weightSum = 1.0;
+                    weighted = sample.value;
+                    break;
+                }
+                const double weight = 1.0 / (distance * distance);
+                weightSum += weight;
+                weighted += weight * sample.value;
+            }
+            value = float(weighted / weightSum);
+            coverage = float(1.0 - closest / m_radiusKm);
+        }
+
+        targets.values[index] = value;
+        targets.coverage[index] = coverage;
+        line[column] = colorFor(value, coverage);
+    }
+}
+
+double HeatmapGrid::valueAt(double latitude, double longitude) const
+{
+    const int row = qBound(0, int(std::floor((90.0 - latitude) / m_cellDegrees)), m_rows - 1);
+    const int column = wrap(int(std::floor((longitude + 180.0) / m_cellDegrees)), m_columns);
+    return m_values[row * m_columns + column];
+}
+
+// =====================================================
+// COULEURS
+// =====================================================
+
+void HeatmapGrid::setPalette(const QGradientStops& stops, double minimum, double maximum)
+{
+    m_minimum = minimum;
+    m_maximum = maximum > minimum ? maximum : minimum + 1.0;
+
+    // Table de 256 couleurs interpolées entre les stops
+    m_palette.resize(256);
+    for (int i = 0; i < 256; ++i) {
+        const double t = i / 255.0;
+        QColor color = stops.isEmpty() ? QColor(Qt::gray) : stops.first().second;
+        for (qsizetype s = 1; s < stops.size(); ++s) {
+            if (t > stops[s].first) {
+                color = stops[s].second;
+                continue;
+            }
+            const QGradientStop& from = stops[s - 1];
+            const QGradientStop& to = stops[s];
+            const double span = to.first - from.first;
+            const double f = span > 0 ? qBound(0.0, (t - from.first) / span, 1.0) : 1.0;
+            color = QColor::fromRgbF(float(from.second.redF() + f * (to.second.redF() - from.second.redF())),
+                                     float(from.second.greenF() + f * (to.second.greenF() - from.second.greenF())),
+                                     float(from.second.blueF() + f * (to.second.blueF() - from.second.blueF())));
+            break;
+        }
+        m_palette[i] = color.rgb();
+    }
+    recolor();
+}
+
+QRgb HeatmapGrid::colorFor(float value, float coverage) const
+{
+    if (std::isnan(value)) return qRgba(0, 0, 0, 0);
+
+    const double t = qBound(0.0, (value - m_minimum) / (m_maximum - m_minimum), 1.0);
+    const QRgb color = m_palette[int(std::lround(t * 255))];
+    // Opaque près des villes, s'efface sur la seconde moitié du rayon
+    const int alpha = int(MAX_ALPHA * qMin(1.0f, coverage * 2.0f));
+    return qPremultiply(qRgba(qRed(color), qGreen(color), qBlue(color), alpha));
+}
+
+void HeatmapGrid::recolor()
+{
+    for (int row = 0; row < m_rows; ++row) {
+        QRgb* line = reinterpret_cast<QRgb*>(m_image.scanLine(row));
+        for (int column = 0; column < m_columns; ++column) {
+            const int index = row * m_columns + column;
+            line[column] = colorFor(m_values[index], m_coverage[index]);
+        }
+    }
+}
@@ -0,0 +1,102 @@
+#ifndef HEATMAPGRID_H
+#define HEATMAPGRID_H
+
+#include "citykey.h"
+#include "cityspatialindex.h"
+#include <QBrush>
+#include <QHash>
+#include <QImage>
+#include <QVector>
+
+/**
+ * Carte de chaleur interpolée sur une grille grossière (lat, lon)
+ *
+ * - Valeur d'une case : pondération inverse du carré de la distance (IDW)
+ *   des MAX_NEIGHBOURS villes les plus proches de son centre, dans un rayon
+ *   d'influence ; aucune ville dans le rayon → case transparente
+ * - Une ville ajoutée, déplacée, modifiée ou retirée ne marque que les cases
+ *   de son rayon d'influence ; update() ne recalcule que celles-ci, lignes
+ *   réparties entre les threads (QtConcurrent)
+ * - Résultat : image columns() x rows() (nord en haut, 180°O à gauche),
+ *   couleurs de la palette, opacité décroissante loin des villes ; à étirer
+ *   sur la carte équirectangulaire
+ */
+class HeatmapGrid
+{
+public:
+    static constexpr double DEFAULT_CELL_DEGREES = 2.0;
+    static constexpr double DEFAULT_RADIUS_KM = 1500.0;
+    static constexpr int MAX_NEIGHBOURS = 8;
+    static constexpr int MAX_ALPHA = 170;
+    static constexpr int PARALLEL_MIN_ROWS = 4;     // En dessous : calcul sur le thread appelant
+
+    explicit HeatmapGrid(double cellDegrees = DEFAULT_CELL_DEGREES,
+                         double influenceRadiusKm = DEFAULT_RADIUS_KM);
+
+    // Échantillons (valeur d'une ville) ; sans effet si rien ne change
+    void setSample(const CityKey& key, double latitude, double longitude, double value);
+    bool removeSample(const CityKey& key);
+    void clear();
+
+    int sampleCount() const { return int(m_samples.size()); }
+    bool hasSample(const CityKey& key) const { return m_samples.contains(key); }
+    QList<CityKey> sampleKeys() const { return m_samples.keys(); }
+
+    // Couleurs : stops de 0 à 1 répartis entre minimum et maximum (recolore sans recalcul)
+    void setPalette(const QGradientStops& stops, double minimum, double maximum);
+
+    /**
+     * Recalcule les cases marquées depuis le dernier appel
+     * @return nombre de cases recalculées
+     */
+    int update();
+    bool isDirty() const { return m_dirtyCount > 0; }
+
+    const QImage& image() const { return m_image; }
+    double valueAt(double latitude, double longitude) const;   // NaN hors couverture
+
+    int columns() const { return m_columns; }
+    int rows() const { return m_rows; }
+    double cellDegrees() const { return m_cellDegrees; }
+
+private:
+    struct Sample {
+        double latitude;
+        double longitude;
+        double value;
+    };
+
+    double m_cellDegrees;
+    double m_radiusKm;
+    int m_columns;
+    int m_rows;
+
+    QHash<CityKey, Sample> m_samples;
+    CitySpatialIndex m_index;           // Voisins des centres de cases
+
+    QVector<float> m_values;            // NaN : aucune ville dans le rayon
+    QVector<float> m_coverage;          // 1 sur une ville → 0 au bord du rayon
+    QVector<bool> m_dirty;
+    int m_dirtyCount;
+
+    QImage m_image;
+    QVector<QRgb> m_palette;            // 256 couleurs opaques
+    double m_minimum;
+    double m_maximum;
+
+    // Zones écrites par les threads de calcul (une ligne chacun)
+    struct Targets {
+        float* values;
+        float* coverage;
+        bool* dirty;
+        uchar* bits;
+        qsizetype bytesPerLine;
+    };
+
+    void markAround(double latitude, double longitude);
+    void computeRow(int row, const Targets& targets) const;
+    QRgb colorFor(float value, float coverage) const;
+    void recolor();
+};
+
+#endif // HEATMAPGRID_H
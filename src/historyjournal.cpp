@@ -0,0 +1,235 @@
+#include "historyjournal.h"
+#include <QSaveFile>
+#include <QDebug>
+
+namespace {
+constexpr quint32 SNAPSHOT_MAGIC = 0x57485332; // "WHS2" : magic, génération, entrées
+constexpr quint32 LOG_MAGIC = 0x57484C32;      // "WHL2" : magic, génération, modifications
+constexpr quint32 SNAPSHOT_MAGIC_V1 = 0x57485331; // "WHS1" : sans génération (lue comme 0)
+constexpr quint32 LOG_MAGIC_V1 = 0x57484C31;      // "WHL1"
+constexpr QDataStream::Version STREAM_VERSION = QDataStream::Qt_6_0;
+}
+
+// =====================================================
+// SÉRIALISATION
+// =====================================================
+
+QDataStream& operator<<(QDataStream& out, const HistoryMutation& mutation)
+{
+    out << quint8(mutation.type) << mutation.time.toMSecsSinceEpoch()
+        << mutation.cityName << mutation.favorite;
+    return out;
+}
+
+QDataStream& operator>>(QDataStream& in, HistoryMutation& mutation)
+{
+    quint8 type = 0;
+    qint64 msecs = 0;
+    in >> type >> msecs >> mutation.cityName >> mutation.favorite;
+    mutation.type = HistoryMutation::Type(type);
+    mutation.time = QDateTime::fromMSecsSinceEpoch(msecs);
+    return in;
+}
+
+QDataStream& operator<<(QDataStream& out, const SearchHistoryEntry& entry)
+{
+    out << entry.cityName << entry.searchTime.toMSecsSinceEpoch() << qint32(entry.searchCount)
+        << entry.lastAccess.toMSecsSinceEpoch() << entry.isFavorite << entry.hourlyCounts;
+    return out;
+}
+
+QDataStream& operator>>(QDataStream& in, SearchHistoryEntry& entry)
+{
+    qint64 searchTime = 0;
+    qint64 lastAccess = 0;
+    qint32 count = 0;
+    in >> entry.cityName >> searchTime >> count >> lastAccess >> entry.isFavorite >> entry.hourlyCounts;
+    entry.searchTime = QDateTime::fromMSecsSinceEpoch(searchTime);
+    entry.lastAccess = QDateTime::fromMSecsSinceEpoch(lastAccess);
+    entry.searchCount = count;
+    return in;
+}
+
+// =====================================================
+// JOURNAL
+// =====================================================
+
+HistoryJournal::HistoryJournal(const QString& snapshotPath, const QString& logPath, quint64 generation,
+                               QObject* parent)
+    : QObject(parent)
+    , m_snapshotPath(snapshotPath)
+    , m_logPath(logPath)
+    , m_generation(generation)
+    , m_logFile(nullptr)
+{
+}
+
+HistoryJournal::~HistoryJournal()
+{
+    if (m_logFile && m_logFile->isOpen()) {
+        m_logFile->flush();
+        m_logFile->close();
+    }
+}
+
+bool HistoryJournal::readSnapshot(const QString& path, QList<SearchHistoryEntry>& entries, quint64* generation)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(STREAM_VERSION);
+
+    quint32 magic = 0;
+    quint64 snapshotGeneration = 0;
+    qint32 count = 0;
+    in >> magic;
+    if (magic == SNAPSHOT_MAGIC) {
+        in >> snapshotGeneration;
+    }
+    in >> count;
+    if ((magic != SNAPSHOT_MAGIC && magic != SNAPSHOT_MAGIC_V1) || count < 0 || in.status() != QDataStream::Ok) {
+        qWarning() << "HistoryJournal: invalid snapshot" << path;
+        return false;
+    }
+    if (generation) {
+        *generation = snapshotGeneration;
+    }
+
+    entries.reserve(count);
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        SearchHistoryEntry entry;
+        in >> entry;
+        if (in.status() == QDataStream::Ok) {
+            entries.append(entry);
+        }
+    }
+    return true;
+}
+
+QList<HistoryMutation> HistoryJournal::readLog(const QString& path, quint64 generation, qint64* validSize)
+{
+    QList<HistoryMutation> mutations;
+    if (validSize) *validSize = 0;
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return mutations;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(STREAM_VERSION);
+
+    quint32 magic = 0;
+    quint64 logGeneration = 0;
+    in >> magic;
+    if (magic == LOG_MAGIC) {
+        in >> logGeneration;
+    }
+    if ((magic != LOG_MAGIC && magic != LOG_MAGIC_V1) || in.status() != QDataStream::Ok) {
+        qWarning() << "HistoryJournal: invalid log header in" << path;
+        return mutations;
+    }
+    if (logGeneration != generation) {
+        // Compactage interrompu : ces modifications sont déjà dans le snapshot
+        qWarning() << "HistoryJournal: log generation" << logGeneration << "superseded by snapshot" << generation;
+        return mutations;
+    }
+
+    qint64 goodEnd = file.pos();
+    while (!in.atEnd()) {
+        HistoryMutation mutation;
+        in >> mutation;
+        if (in.status() != QDataStream::Ok) {
+            qWarning() << "HistoryJournal: truncated record ignored in" << path;
+            break;
+        }
+        mutations.append(mutation);
+        goodEnd = file.pos();
+    }
+    if (validSize) *validSize = goodEnd;
+    return mutations;
+}
+
+bool HistoryJournal::truncateLog(const QString& path, qint64 validSize)
+{
+    // Sans cela, les ajouts suivants seraient écrits après la queue illisible et perdus
+    QFile file(path);
+    if (!file.exists() || file.size() <= validSize) return true;
+    qWarning() << "HistoryJournal: log cut from" << file.size() << "to" << validSize << "bytes";
+    return file.resize(validSize);
+}
+
+void HistoryJournal::append(const QList<HistoryMutation>& mutations)
+{
+    if (mutations.isEmpty()) return;
+    if ((!m_logFile || !m_logFile->isOpen()) && !openLog(false)) return;
+
+    // Un seul write() par lot de modifications regroupées
+    QByteArray buffer;
+    QDataStream out(&buffer, QIODevice::WriteOnly);
+    out.setVersion(STREAM_VERSION);
+    for (const HistoryMutation& mutation : mutations) {
+        out << mutation;
+    }
+
+    m_logFile->write(buffer);
+    m_logFile->flush();
+}
+
+bool HistoryJournal::compact(const QList<SearchHistoryEntry>& entries)
+{
+    QSaveFile snapshot(m_snapshotPath);
+    if (!snapshot.open(QIODevice::WriteOnly)) {
+        qWarning() << "HistoryJournal: cannot write snapshot" << snapshot.errorString();
+        return false;
+    }
+
+    const quint64 next = m_generation + 1;
+    QDataStream out(&snapshot);
+    out.setVersion(STREAM_VERSION);
+    out << SNAPSHOT_MAGIC << next << qint32(entries.size());
+    for (const SearchHistoryEntry& entry : entries) {
+        out << entry;
+    }
+
+    if (!snapshot.commit()) {
+        qWarning() << "HistoryJournal: snapshot commit failed" << snapshot.errorString();
+        return false;
+    }
+
+    // Le snapshot contient tout le journal : on repart d'un journal vide de la nouvelle
+    // génération (arrêt avant : l'ancien journal, d'une autre génération, est ignoré)
+    m_generation = next;
+    openLog(true);
+    qDebug() << "HistoryJournal: compacted" << entries.size() << "entries, generation" << m_generation;
+    return true;
+}
+
+bool HistoryJournal::openLog(bool truncate)
+{
+    // Appelé dans le thread du journal : le fichier partage l'affinité de l'objet
+    if (!m_logFile) {
+        m_logFile = new QFile(m_logPath, this);
+    } else if (m_logFile->isOpen()) {
+        m_logFile->close();
+    }
+
+    bool isNew = truncate || !m_logFile->exists() || m_logFile->size() == 0;
+    QIODevice::OpenMode mode = isNew ? (QIODevice::WriteOnly | QIODevice::Truncate)
+                                     : (QIODevice::WriteOnly | QIODevice::Append);
+    if (!m_logFile->open(mode)) {
+        qWarning() << "HistoryJournal: cannot open log" << m_logFile->errorString();
+        return false;
+    }
+
+    if (isNew) {
+        QDataStream out(m_logFile);
+        out.setVersion(STREAM_VERSION);
+        out << LOG_MAGIC << m_generation;
+        m_logFile->flush();
+    }
+    return true;
+}
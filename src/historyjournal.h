@@ -0,0 +1,68 @@
+#ifndef HISTORYJOURNAL_H
+#define HISTORYJOURNAL_H
+
+#include "SearchHistory.h"
+#include <QObject>
+#include <QFile>
+#include <QDataStream>
+#include <QList>
+
+QDataStream& operator<<(QDataStream& out, const HistoryMutation& mutation);
+QDataStream& operator>>(QDataStream& in, HistoryMutation& mutation);
+QDataStream& operator<<(QDataStream& out, const SearchHistoryEntry& entry);
+QDataStream& operator>>(QDataStream& in, SearchHistoryEntry& entry);
+
+/**
+ * Persistance binaire de l'historique, exécutée dans un thread dédié
+ *
+ * Deux fichiers :
+ * - snapshot : état complet au dernier compactage
+ * - journal  : modifications ajoutées depuis (append-only)
+ *
+ * Le chargement lit le snapshot puis rejoue le journal ; un enregistrement
+ * tronqué (arrêt brutal) termine la relecture, et le journal est ramené au
+ * dernier enregistrement complet avant tout nouvel ajout.
+ *
+ * Génération : numéro incrémenté à chaque compactage, écrit dans les deux
+ * en-têtes. Un journal d'une autre génération que le snapshot (arrêt entre
+ * l'écriture du snapshot et la remise à zéro du journal) est déjà inclus
+ * dans le snapshot : il n'est pas rejoué.
+ */
+class HistoryJournal : public QObject
+{
+    Q_OBJECT
+
+public:
+    // generation : celle du snapshot lu au chargement
+    HistoryJournal(const QString& snapshotPath, const QString& logPath, quint64 generation = 0,
+                   QObject* parent = nullptr);
+    ~HistoryJournal();
+
+    // Lecture (appelée avant le démarrage du thread)
+    static bool readSnapshot(const QString& path, QList<SearchHistoryEntry>& entries,
+                             quint64* generation = nullptr);
+    /**
+     * Modifications du journal si sa génération est celle du snapshot
+     * @param validSize Octets à conserver : fin du dernier enregistrement
+     *                  complet, 0 si l'en-tête est invalide ou périmé
+     */
+    static QList<HistoryMutation> readLog(const QString& path, quint64 generation,
+                                          qint64* validSize = nullptr);
+    // Coupe le journal après validSize octets (queue illisible ou génération périmée)
+    static bool truncateLog(const QString& path, qint64 validSize);
+
+    // Écriture (dans le thread du journal)
+    void append(const QList<HistoryMutation>& mutations);
+    bool compact(const QList<SearchHistoryEntry>& entries);
+    quint64 generation() const { return m_generation; }
+
+private:
+    QString m_snapshotPath;
+    QString m_logPath;
+    quint64 m_generation;
+    QFile* m_logFile;       // Créé au premier accès, dans le thread du journal (enfant de l'objet)
+
+    bool openLog(bool truncate);
+};
+
+#endif // HISTORYJOURNAL_H
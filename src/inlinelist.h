@@ -0,0 +1,193 @@
+#ifndef INLINELIST_H
+#define INLINELIST_H
+
+#include <QtGlobal>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * Liste à capacité fixe stockée dans l'objet lui-même
+ *
+ * - Jusqu'à InlineCapacity éléments : aucun bloc mémoire séparé, les
+ *   éléments vivent dans la structure qui contient la liste
+ * - Au-delà : repli sur un std::vector (réservé d'un coup si la taille
+ *   est connue via reserve())
+ *
+ * Les éléments restent contigus dans les deux modes (data(), begin(), end()).
+ */
+template <typename T, int InlineCapacity>
+class InlineList
+{
+    static_assert(InlineCapacity > 0, "InlineList needs a positive inline capacity");
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    InlineList() = default;
+
+    InlineList(const InlineList& other)
+    {
+        reserve(other.size());
+        for (const T& value : other) {
+            append(value);
+        }
+    }
+
+    InlineList(InlineList&& other) noexcept
+    {
+        takeFrom(std::move(other));
+    }
+
+    InlineList& operator=(const InlineList& other)
+    {
+        if (this != &other) {
+            clear();
+            reserve(other.size());
+            for (const T& value : other) {
+                append(value);
+            }
+        }
+        return *this;
+    }
+
+    InlineList& operator=(InlineList&& other) noexcept
+    {
+        if (this != &other) {
+            clear();
+            takeFrom(std::move(other));
+        }
+        return *this;
+    }
+
+    ~InlineList() { clear(); }
+
+    // === TAILLE ===
+    int size() const { return m_spilled ? int(m_overflow.size()) : m_inlineSize; }
+    bool isEmpty() const { return size() == 0; }
+    bool empty() const { return isEmpty(); }
+    int capacity() const { return m_spilled ? int(m_overflow.capacity()) : InlineCapacity; }
+    static constexpr int inlineCapacity() { return InlineCapacity; }
+
+    // true tant qu'aucun bloc mémoire séparé n'a été alloué
+    bool isInline() const { return !m_spilled; }
+
+    // Octets alloués hors de l'objet (0 en mode intégré)
+    qint64 heapBytes() const { return m_spilled ? qint64(m_overflow.capacity() * sizeof(T)) : 0; }
+
+    // Taille annoncée supérieure à la capacité intégrée → une seule allocation
+    void reserve(int count)
+    {
+        if (count > capacity()) {
+            spill(count);
+        }
+    }
+
+    // === AJOUT / SUPPRESSION ===
+    void append(const T& value)
+    {
+        if (m_spilled) {
+            m_overflow.push_back(value);
+        } else if (m_inlineSize < InlineCapacity) {
+            new (inlineData() + m_inlineSize) T(value);
+            ++m_inlineSize;
+        } else {
+            T copy(value); // value peut désigner un élément déplacé par spill()
+            spill(2 * InlineCapacity);
+            m_overflow.push_back(std::move(copy));
+        }
+    }
+
+    void append(T&& value)
+    {
+        if (m_spilled) {
+            m_overflow.push_back(std::move(value));
+        } else if (m_inlineSize < InlineCapacity) {
+            new (inlineData() + m_inlineSize) T(std::move(value));
+            ++m_inlineSize;
+        } else {
+            T moved(std::move(value));
+            spill(2 * InlineCapacity);
+            m_overflow.push_back(std::move(moved));
+        }
+    }
+
+    void clear()
+    {
+        T* items = inlineData();
+        for (int i = 0; i < m_inlineSize; ++i) {
+            items[i].~T();
+        }
+        m_inlineSize = 0;
+        m_overflow.clear();
+        m_overflow.shrink_to_fit();
+        m_spilled = false;
+    }
+
+    // === ACCÈS ===
+    T* data() { return m_spilled ? m_overflow.data() : inlineData(); }
+    const T* data() const { return m_spilled ? m_overflow.data() : inlineData(); }
+
+    T& operator[](int index) { Q_ASSERT(index >= 0 && index < size()); return data()[index]; }
+    const T& operator[](int index) const { Q_ASSERT(index >= 0 && index < size()); return data()[index]; }
+    const T& at(int index) const { return (*this)[index]; }
+
+    T& first() { return (*this)[0]; }
+    const T& first() const { return (*this)[0]; }
+    T& last() { return (*this)[size() - 1]; }
+    const T& last() const { return (*this)[size() - 1]; }
+
+    iterator begin() { return data(); }
+    iterator end() { return data() + size(); }
+    const_iterator begin() const { return data(); }
+    const_iterator end() const { return data() + size(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+private:
+    alignas(T) unsigned char m_inline[InlineCapacity * sizeof(T)];
+    int m_inlineSize = 0;
+    bool m_spilled = false;
+    std::vector<T> m_overflow;  // Utilisé seulement au-delà de la capacité intégrée
+
+    T* inlineData() { return std::launder(reinterpret_cast<T*>(m_inline)); }
+    const T* inlineData() const { return std::launder(reinterpret_cast<const T*>(m_inline)); }
+
+    // Passage en mode vector : déplace les éléments intégrés
+    void spill(int newCapacity)
+    {
+        if (m_spilled) {
+            m_overflow.reserve(size_t(newCapacity));
+            return;
+        }
+        std::vector<T> overflow;
+        overflow.reserve(size_t(qMax(newCapacity, m_inlineSize)));
+        T* items = inlineData();
+        for (int i = 0; i < m_inlineSize; ++i) {
+            overflow.push_back(std::move(items[i]));
+            items[i].~T();
+        }
+        m_inlineSize = 0;
+        m_overflow = std::move(overflow);
+        m_spilled = true;
+    }
+
+    void takeFrom(InlineList&& other)
+    {
+        if (other.m_spilled) {
+            m_overflow = std::move(other.m_overflow);
+            m_spilled = true;
+        } else {
+            T* source = other.inlineData();
+            for (int i = 0; i < other.m_inlineSize; ++i) {
+                new (inlineData() + i) T(std::move(source[i]));
+            }
+            m_inlineSize = other.m_inlineSize;
+        }
+        other.clear();
+    }
+};
+
+#endif // INLINELIST_H
@@ -0,0 +1,75 @@
+#include "logpanel.h"
+
+LogPanel::LogPanel(QWidget* parent, int capacity)
+    : QPlainTextEdit(parent)
+    , m_head(0)
+    , m_pendingCount(0)
+    , m_droppedCount(0)
+    , m_flushCount(0)
+    , m_flushTimer(new QTimer(this))
+{
+    setReadOnly(true);
+    setUndoRedoEnabled(false);   // Pas d'historique d'annulation pour un journal
+    setCapacity(capacity);
+
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(FLUSH_INTERVAL_MS);
+    connect(m_flushTimer, &QTimer::timeout, this, &LogPanel::flush);
+}
+
+void LogPanel::append(const QString& line)
+{
+    const int capacity = int(m_ring.size());
+    if (m_pendingCount < capacity) {
+        m_ring[(m_head + m_pendingCount) % capacity] = line;
+        ++m_pendingCount;
+    } else {
+        // Tampon plein : la plus ancienne ligne en attente n'aurait pas survécu à maximumBlockCount
+        m_ring[m_head] = line;
+        m_head = (m_head + 1) % capacity;
+        ++m_droppedCount;
+    }
+
+    if (!m_flushTimer->isActive()) {
+        m_flushTimer->start();
+    }
+}
+
+void LogPanel::flush()
+{
+    m_flushTimer->stop();
+    if (m_pendingCount == 0) return;
+
+    const int capacity = int(m_ring.size());
+    qsizetype length = 0;
+    for (int i = 0; i < m_pendingCount; ++i) {
+        length += m_ring.at((m_head + i) % capacity).size() + 1;
+    }
+
+    QString text;
+    text.reserve(length);
+    for (int i = 0; i < m_pendingCount; ++i) {
+        QString& line = m_ring[(m_head + i) % capacity];
+        if (i > 0) text += QLatin1Char('\n');
+        text += line;
+        line = QString(); // Libère la chaîne sans réallouer le tampon
+    }
+    m_head = 0;
+    m_pendingCount = 0;
+
+    // Un seul ajout au document par image ; le défilement suit s'il était en bas
+    appendPlainText(text);
+    ++m_flushCount;
+}
+
+void LogPanel::setCapacity(int lines)
+{
+    lines = qMax(1, lines);
+    if (!m_ring.isEmpty()) {
+        flush();
+    }
+
+    m_ring = QList<QString>(lines);
+    m_head = 0;
+    setMaximumBlockCount(lines);
+}
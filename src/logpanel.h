@@ -0,0 +1,55 @@
+#ifndef LOGPANEL_H
+#define LOGPANEL_H
+
+#include <QPlainTextEdit>
+#include <QList>
+#include <QString>
+#include <QTimer>
+
+/**
+ * Journal d'activité à coût constant
+ *
+ * - append() ne touche pas au document : la ligne entre dans un tampon
+ *   circulaire de `capacity` lignes (les plus anciennes sont écrasées si
+ *   une rafale dépasse la capacité entre deux affichages)
+ * - Un seul ajout au document par image (~16 ms), pour toutes les lignes
+ *   en attente : une seule mise en page, quel que soit le volume
+ * - Texte brut (QPlainTextEdit) limité à `capacity` lignes par
+ *   maximumBlockCount : les plus anciennes sont retirées automatiquement
+ */
+class LogPanel : public QPlainTextEdit
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DEFAULT_CAPACITY = 500;
+    static constexpr int FLUSH_INTERVAL_MS = 16;
+
+    explicit LogPanel(QWidget* parent = nullptr, int capacity = DEFAULT_CAPACITY);
+
+    // O(1) : affiché au prochain flush
+    void append(const QString& line);
+
+    // Lignes conservées (tampon et document)
+    void setCapacity(int lines);
+    int capacity() const { return int(m_ring.size()); }
+
+    // === STATISTIQUES ===
+    int pendingCount() const { return m_pendingCount; }
+    qint64 droppedCount() const { return m_droppedCount; }  // Écrasées avant affichage
+    qint64 flushCount() const { return m_flushCount; }
+
+public slots:
+    // Affiche immédiatement les lignes en attente
+    void flush();
+
+private:
+    QList<QString> m_ring;     // Lignes en attente (tampon circulaire)
+    int m_head;                // Plus ancienne ligne en attente
+    int m_pendingCount;
+    qint64 m_droppedCount;
+    qint64 m_flushCount;
+    QTimer* m_flushTimer;
+};
+
+#endif // LOGPANEL_H
@@ -20,6 +20,10 @@ int main(int argc, char *argv[])
     qRegisterMetaType<CurrentWeatherData>("CurrentWeatherData");
     qRegisterMetaType<ForecastData>("ForecastData");
     qRegisterMetaType<ForecastEntry>("ForecastEntry");
+    qRegisterMetaType<CurrentWeatherPtr>("CurrentWeatherPtr");
+    qRegisterMetaType<ForecastPtr>("ForecastPtr");
+    qRegisterMetaType<CityKey>("CityKey");
+    qRegisterMetaType<WeatherDataType>("WeatherDataType");
 
     // Créer dossier cache
     QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
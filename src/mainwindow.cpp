@@ -5,25 +5,50 @@
 #include <QApplication>
 #include <QMessageBox>
 #include <QDateTime>
+#include <QFileInfo>
 #include <QDebug>
+#include <QStyle>
+#include <QScrollBar>
+#include <QRegularExpression>
+#include <QtConcurrent>
+
+namespace {
+// Rayon de recherche d'une ville en cache autour de coordonnées saisies
+constexpr double NEARBY_CITY_RADIUS_KM = 100.0;
+}
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent)
+    , m_mainTabWidget(nullptr)
     , m_centralWidget(nullptr)
+    , m_cityCompleter(nullptr)
+    , m_suggestionModel(nullptr)
     , m_weatherService(nullptr)
+    , m_searchHistory(nullptr)
+    , m_prefetcher(nullptr)
+    , m_recentModel(nullptr)
+    , m_favoritesModel(nullptr)
+    , m_visibleHistoryTimer(nullptr)
+    , m_gazetteerWatcher(nullptr)
+    , m_dashboard(nullptr)
     , m_isLoading(false)
 {
     setupUI();
     setupStatusBar();
-    //Initialisation de cache
-    std::unique_ptr<ICacheManager> cacheManager = std::make_unique<weathercachemanager>();
+    // Charge la cle par json
+    ConfigLoader config;
+    const bool configLoaded = config.loadConfig();
+
+    //Initialisation de cache (réponses brutes et budget mémoire selon config.json)
+    auto cache = std::make_unique<weathercachemanager>();
+    cache->setRawPayloadMode(config.getRawPayloadMode());
+    cache->setMemoryBudget(config.getCacheMemoryBudget());
+    std::unique_ptr<ICacheManager> cacheManager = std::move(cache);
     // Initialisation du service météo
     m_weatherService = new WeatherService(std::move(cacheManager));
 
     // Set the API key
-    // Charge la cle par json
-    ConfigLoader config;
-    if (config.loadConfig()) {
+    if (configLoaded) {
         // Configuration OK
         m_weatherService->setApiKey(config.getApiKey());
         m_logDisplay->append("Clé API chargée depuis config.json");
@@ -35,7 +60,34 @@ MainWindow::MainWindow(QWidget *parent)
         QMessageBox::critical(this, "Configuration", config.getErrorMessage());
     }
 
+    // Historique des recherches + préchargement des villes habituelles
+    m_searchHistory = new SearchHistory(this);
+    m_prefetcher = new WeatherPrefetcher(m_weatherService, m_searchHistory, this);
+    setupCompleter();
+    setupHistoryConnections();
+    setupDashboard();
+
     setupConnections();
+    m_prefetcher->start();
+
+    // Gazetteer hors ligne : généré une fois depuis le city.list.json complet
+    // déposé dans les données de l'application, sinon depuis la liste embarquée.
+    // Génération et lecture des noms hors du thread de l'interface ; d'ici là,
+    // les recherches partent par nom côté serveur
+    m_gazetteerWatcher = new QFutureWatcher<QStringList>(this);
+    connect(m_gazetteerWatcher, &QFutureWatcher<QStringList>::finished, this, &MainWindow::onGazetteerReady);
+    m_gazetteerWatcher->setFuture(QtConcurrent::run([]() {
+        const QString gazetteerPath = CityGazetteer::defaultPath();
+        if (!QFile::exists(gazetteerPath)) {
+            QString cityList = QFileInfo(gazetteerPath).absolutePath() + "/city.list.json";
+            if (!QFile::exists(cityList)) {
+                cityList = ":/data/city.list.json";
+            }
+            CityGazetteer::build(cityList, gazetteerPath);
+        }
+        CityGazetteer gazetteer;
+        return gazetteer.open(gazetteerPath) ? gazetteer.names() : QStringList();
+    }));
 
     setWindowTitle("Application Météo ");
     resize(1200, 900);
@@ -52,8 +104,12 @@ MainWindow::~MainWindow()
 
 void MainWindow::setupUI()
 {
+    // Onglets : ville courante, puis tableau de bord (setupDashboard, une fois le cache créé)
+    m_mainTabWidget = new QTabWidget(this);
+    setCentralWidget(m_mainTabWidget);
+
     m_centralWidget = new QWidget(this);
-    setCentralWidget(m_centralWidget);
+    m_mainTabWidget->addTab(m_centralWidget, "Ville");
 
     // Layout principal horizontal qu on va diviser en 2
     QHBoxLayout* mainHorizontalLayout = new QHBoxLayout(m_centralWidget);
@@ -96,23 +152,21 @@ void MainWindow::setupMapSection()
     QGroupBox* mapGroup = new QGroupBox("Carte Météo", this);
     QVBoxLayout* mapGroupLayout = new QVBoxLayout(mapGroup);
 
-    // Placeholder pour la carte
-    QLabel* mapPlaceholder = new QLabel("Zone Carte\nLa carte sera intégrée ici", this);
-    mapPlaceholder->setAlignment(Qt::AlignCenter);
-    mapPlaceholder->setMinimumHeight(250);
-    mapPlaceholder->setStyleSheet(
-        "border: 2px dashed #95a5a6;"
-        "color: #7f8c8d;"
-        "font-size: 14px;"
-        "padding: 40px;"
-        "border-radius: 8px;"
-        "background: #ecf0f1;"
-        );
+    // Localisation de la ville affichée (alimentée par currentWeatherReady)
+    m_mapWidget = new SimpleMapWidget(this);
+    m_mapWidget->setMinimumHeight(250);
 
-    mapGroupLayout->addWidget(mapPlaceholder);
+    mapGroupLayout->addWidget(m_mapWidget);
     m_mainRightLayout->addWidget(mapGroup,2);
 }
 
+void MainWindow::setupDashboard()
+{
+    // Grille de toutes les villes, lue directement dans le cache du service
+    m_dashboard = new DashboardWidget(m_weatherService->cacheManager(), this);
+    m_mainTabWidget->addTab(m_dashboard, "Tableau de bord");
+}
+
 void MainWindow::setupHistorySection()
 {
     // Groupe principal pour l'historique
@@ -127,13 +181,15 @@ void MainWindow::setupHistorySection()
     QVBoxLayout* recentLayout = new QVBoxLayout(recentTab);
 
     // Liste des recherches récentes
-    m_recentSearchList = new QListWidget(this);
+    // Vue virtualisée : seules les lignes visibles sont dessinées, hauteur unique
+    m_recentSearchList = new QListView(this);
+    m_recentSearchList->setUniformItemSizes(true);
     m_recentSearchList->setMaximumHeight(200);
     m_recentSearchList->setStyleSheet(
-        "QListWidget { border: 1px solid #ccc; border-radius: 4px; }"
-        "QListWidget::item { padding: 8px; border-bottom: 1px solid #eee; }"
-        "QListWidget::item:hover { background-color: #f0f8ff; }"
-        "QListWidget::item:selected { background-color: #3498db; color: white; }"
+        "QListView { border: 1px solid #ccc; border-radius: 4px; }"
+        "QListView::item { padding: 8px; border-bottom: 1px solid #eee; }"
+        "QListView::item:hover { background-color: #f0f8ff; }"
+        "QListView::item:selected { background-color: #3498db; color: white; }"
         );
 
     // Label statistiques récent
@@ -149,13 +205,14 @@ void MainWindow::setupHistorySection()
     QVBoxLayout* favoritesLayout = new QVBoxLayout(favoritesTab);
 
     // Liste des favoris
-    m_favoritesSearchList = new QListWidget(this);
+    m_favoritesSearchList = new QListView(this);
+    m_favoritesSearchList->setUniformItemSizes(true);
     m_favoritesSearchList->setMaximumHeight(150);
     m_favoritesSearchList->setStyleSheet(
-        "QListWidget { border: 1px solid #ccc; border-radius: 4px; }"
-        "QListWidget::item { padding: 8px; border-bottom: 1px solid #eee; }"
-        "QListWidget::item:hover { background-color: #fff3cd; }"
-        "QListWidget::item:selected { background-color: #f39c12; color: white; }"
+        "QListView { border: 1px solid #ccc; border-radius: 4px; }"
+        "QListView::item { padding: 8px; border-bottom: 1px solid #eee; }"
+        "QListView::item:hover { background-color: #fff3cd; }"
+        "QListView::item:selected { background-color: #f39c12; color: white; }"
         );
 
     // Boutons de gestion des favoris
@@ -213,19 +270,117 @@ void MainWindow::setupHistorySection()
 
     m_mainRightLayout->addWidget(historyGroup,1);
 
-    // === CONNEXIONS DES SIGNAUX ===
-    //setupHistoryConnections();
+    // Modèles et connexions : setupHistoryConnections(), une fois l'historique chargé
+}
 
-    // === INITIALISATION DES DONNÉES ===
-    //refreshHistoryDisplay();
+void MainWindow::setupHistoryConnections()
+{
+    // Modèles sur l'historique : chaque modification ne notifie que ses lignes
+    m_recentModel = new SearchHistoryModel(m_searchHistory, SearchHistoryModel::Mode::Recent, this);
+    m_favoritesModel = new SearchHistoryModel(m_searchHistory, SearchHistoryModel::Mode::Favorites, this);
+    m_recentSearchList->setModel(m_recentModel);
+    m_favoritesSearchList->setModel(m_favoritesModel);
+
+    // Double-clic / Entrée sur une ville : nouvelle recherche
+    auto searchFromHistory = [this](const QModelIndex& index) {
+        m_cityInput->setText(index.data(SearchHistoryModel::CityNameRole).toString());
+        onSearchButtonClicked();
+    };
+    connect(m_recentSearchList, &QListView::activated, this, searchFromHistory);
+    connect(m_favoritesSearchList, &QListView::activated, this, searchFromHistory);
+
+    // Boutons favoris selon la ville sélectionnée
+    connect(m_recentSearchList->selectionModel(), &QItemSelectionModel::currentChanged,
+            this, [this](const QModelIndex& current) {
+                m_addFavoriteButton->setEnabled(current.isValid()
+                                                && !current.data(SearchHistoryModel::FavoriteRole).toBool());
+            });
+    connect(m_favoritesSearchList->selectionModel(), &QItemSelectionModel::currentChanged,
+            this, [this](const QModelIndex& current) {
+                m_removeFavoriteButton->setEnabled(current.isValid());
+            });
+    connect(m_addFavoriteButton, &QPushButton::clicked, this, [this]() {
+        const QModelIndex current = m_recentSearchList->currentIndex();
+        if (current.isValid()) {
+            m_searchHistory->addToFavorites(current.data(SearchHistoryModel::CityNameRole).toString());
+            m_addFavoriteButton->setEnabled(false);
+        }
+    });
+    connect(m_removeFavoriteButton, &QPushButton::clicked, this, [this]() {
+        const QModelIndex current = m_favoritesSearchList->currentIndex();
+        if (current.isValid()) {
+            m_searchHistory->removeFromFavorites(current.data(SearchHistoryModel::CityNameRole).toString());
+        }
+    });
+    connect(m_clearHistoryButton, &QPushButton::clicked, m_searchHistory, &SearchHistory::clearHistory);
+
+    // Compteurs : recalculés seulement quand le nombre de lignes change
+    auto updateHistoryStats = [this]() {
+        const int recent = m_recentModel->rowCount();
+        const int favorites = m_favoritesModel->rowCount();
+        m_recentStatsLabel->setText(recent > 0 ? QString("%1 ville(s) dans l'historique").arg(recent)
+                                               : QString("Aucune recherche récente"));
+        m_favoritesStatsLabel->setText(favorites > 0 ? QString("%1 favori(s)").arg(favorites)
+                                                     : QString("Aucun favori"));
+        m_removeFavoriteButton->setEnabled(m_favoritesSearchList->currentIndex().isValid());
+    };
+    for (SearchHistoryModel* model : {m_recentModel, m_favoritesModel}) {
+        connect(model, &QAbstractItemModel::rowsInserted, this, updateHistoryStats);
+        connect(model, &QAbstractItemModel::rowsRemoved, this, updateHistoryStats);
+        connect(model, &QAbstractItemModel::modelReset, this, updateHistoryStats);
+    }
+    updateHistoryStats();
+
+    // Villes visibles des listes → priorité de rafraîchissement du service
+    m_visibleHistoryTimer = new QTimer(this);
+    m_visibleHistoryTimer->setSingleShot(true);
+    m_visibleHistoryTimer->setInterval(150);
+    connect(m_visibleHistoryTimer, &QTimer::timeout, this, &MainWindow::publishVisibleHistoryCities);
+    auto scheduleVisibleHistory = [this]() { m_visibleHistoryTimer->start(); };
+    for (QListView* list : {m_recentSearchList, m_favoritesSearchList}) {
+        connect(list->verticalScrollBar(), &QScrollBar::valueChanged, this, scheduleVisibleHistory);
+    }
+    for (SearchHistoryModel* model : {m_recentModel, m_favoritesModel}) {
+        connect(model, &QAbstractItemModel::rowsInserted, this, scheduleVisibleHistory);
+        connect(model, &QAbstractItemModel::rowsRemoved, this, scheduleVisibleHistory);
+        connect(model, &QAbstractItemModel::rowsMoved, this, scheduleVisibleHistory);
+        connect(model, &QAbstractItemModel::modelReset, this, scheduleVisibleHistory);
+    }
+    connect(m_historyTabWidget, &QTabWidget::currentChanged, this, scheduleVisibleHistory);
+    connect(m_mainTabWidget, &QTabWidget::currentChanged, this, scheduleVisibleHistory);
+    scheduleVisibleHistory();
 }
+
+void MainWindow::publishVisibleHistoryCities()
+{
+    // Onglet "Ville" seulement : liste courante + ville affichée
+    QStringList cities;
+    QStringList current;
+    if (m_mainTabWidget->currentWidget() == m_centralWidget) {
+        QListView* list = m_historyTabWidget->currentIndex() == 0 ? m_recentSearchList : m_favoritesSearchList;
+        const QModelIndex first = list->indexAt(QPoint(0, 0));
+        if (first.isValid()) {
+            const QModelIndex last = list->indexAt(QPoint(0, list->viewport()->height() - 1));
+            const int lastRow = last.isValid() ? last.row() : list->model()->rowCount() - 1;
+            for (int row = first.row(); row <= lastRow; ++row) {
+                cities.append(list->model()->index(row, 0).data(SearchHistoryModel::CityNameRole).toString());
+            }
+        }
+        if (!m_currentCity.isEmpty()) {
+            current.append(m_currentCity);
+        }
+    }
+    m_weatherService->setVisibleCities("history", cities);
+    m_weatherService->setVisibleCities("current", current);
+}
+
 void MainWindow::setupSearchSection()
 {
     m_searchGroup = new QGroupBox("Recherche Ville", this);
     m_searchLayout = new QHBoxLayout(m_searchGroup);
 
     m_cityInput = new QLineEdit(this);
-    m_cityInput->setPlaceholderText("Entrez un nom de ville (ex: Paris, London, Tokyo)");
+    m_cityInput->setPlaceholderText("Entrez un nom de ville (ex: Paris, London, Tokyo) ou une position (48.85, 2.35)");
     m_cityInput->setMinimumWidth(300);
 
     m_searchButton = new QPushButton("Rechercher Météo", this);
@@ -260,7 +415,14 @@ void MainWindow::createWeatherLabels()
     m_cityNameLabel->setStyleSheet("font-weight: bold; font-size: 14px;");
 
     m_temperatureLabel = new QLabel("Température: -", this);
-    m_temperatureLabel->setStyleSheet("font-size: 16px; color: #2196F3;");
+    // Feuille de style fixée une fois ; la couleur suit la propriété "band"
+    m_temperatureLabel->setStyleSheet(
+        "QLabel { font-size: 16px; color: #2196F3; }"
+        "QLabel[band=\"hot\"] { font-size: 18px; font-weight: bold; color: #FF5722; }"
+        "QLabel[band=\"warm\"] { font-size: 18px; font-weight: bold; color: #FF9800; }"
+        "QLabel[band=\"mild\"] { font-size: 18px; font-weight: bold; color: #2196F3; }"
+        "QLabel[band=\"cold\"] { font-size: 18px; font-weight: bold; color: #9C27B0; }"
+        "QLabel[band=\"error\"] { color: red; }");
 
     m_descriptionLabel = new QLabel("Conditions: -", this);
     m_feelsLikeLabel = new QLabel("Ressenti: -", this);
@@ -318,7 +480,8 @@ void MainWindow::setupStatusSection()
     m_loadingBar->setRange(0, 0); // Animation infinie
     m_loadingBar->setVisible(false);
 
-    m_logDisplay = new QTextEdit(this);
+    // Journal borné, ajouts regroupés par image (coût constant en rafale)
+    m_logDisplay = new LogPanel(this);
     m_logDisplay->setMaximumHeight(120);
     m_logDisplay->setStyleSheet("font-family: monospace; font-size: 9px;");
 
@@ -339,6 +502,9 @@ void MainWindow::setupConnections()
     connect(m_cityInput, &QLineEdit::returnPressed,
             this, &MainWindow::onCityInputReturnPressed);
 
+    connect(m_cityInput, &QLineEdit::textEdited,
+            this, &MainWindow::onCityInputEdited);
+
     // === CONNEXIONS WEATHERSERVICE → UI ===
     connect(m_weatherService, &WeatherService::currentWeatherReady,
             this, &MainWindow::onCurrentWeatherReady);
@@ -355,8 +521,82 @@ void MainWindow::setupConnections()
     connect(m_weatherService, &WeatherService::cacheUpdated,
             this, &MainWindow::onCacheUpdated);
 
+    connect(m_weatherService, &WeatherService::backgroundRefreshCompleted,
+            this, &MainWindow::onBackgroundRefreshCompleted);
+
     connect(m_weatherService, &WeatherService::forecastReady,
             m_chartWidget, &WeatherChartWidget::onForecastDataReceived);
+
+    // Carte : même poignée partagée que la fenêtre principale, aucune copie
+    connect(m_weatherService, &WeatherService::currentWeatherReady,
+            m_mapWidget, &SimpleMapWidget::onWeatherDataReceived);
+
+    // Marqueurs des villes en cache, relus par rafale ; clic → recherche
+    m_mapWidget->setCacheManager(m_weatherService->cacheManager());
+    connect(m_weatherService, &WeatherService::cacheUpdated,
+            m_mapWidget, &SimpleMapWidget::onCacheUpdated);
+    connect(m_weatherService, &WeatherService::cacheCleanedUp,
+            m_mapWidget, &SimpleMapWidget::refreshMarkers);
+    connect(m_mapWidget, &SimpleMapWidget::cityClicked, this, [this](const QString& cityName) {
+        m_cityInput->setText(cityName);
+        onSearchButtonClicked();
+    });
+
+    // === TABLEAU DE BORD ===
+    // Notifications regroupées par le modèle : une mise à jour de lignes par rafale
+    connect(m_weatherService, &WeatherService::cacheUpdated, m_dashboard,
+            [this](const QString& cityName, const QString&) {
+                m_dashboard->model()->cityUpdated(m_weatherService->cityKey(cityName), cityName);
+            });
+    connect(m_weatherService, &WeatherService::cacheCleanedUp,
+            m_dashboard->model(), &DashboardModel::reload);
+    connect(m_dashboard, &DashboardWidget::visibleCitiesChanged,
+            this, &MainWindow::onDashboardVisibleCitiesChanged);
+    connect(m_dashboard, &DashboardWidget::cityActivated, this, [this](const QString& cityName) {
+        m_cityInput->setText(cityName);
+        m_mainTabWidget->setCurrentWidget(m_centralWidget);
+        onSearchButtonClicked();
+    });
+    connect(m_dashboard, &DashboardWidget::comparisonRequested, this, [this](const QStringList& cityNames) {
+        // Prévisions du cache partagées telles quelles ; pas de requête (sa réponse
+        // remplacerait la comparaison par la courbe d'une seule ville)
+        QList<ForecastPtr> forecasts;
+        QStringList missing;
+        for (const QString& cityName : cityNames) {
+            ForecastPtr forecast = m_weatherService->cacheManager()->tryGetForecast(m_weatherService->cityKey(cityName));
+            if (forecast) {
+                forecasts.append(forecast);
+            } else {
+                missing.append(cityName);
+            }
+        }
+        if (!missing.isEmpty()) {
+            m_logDisplay->append(QString("Comparaison: pas de prévisions en cache pour %1").arg(missing.join(", ")));
+        }
+        if (forecasts.size() < 2) return;
+
+        m_chartWidget->displayComparison(forecasts);
+        m_mainTabWidget->setCurrentWidget(m_centralWidget);
+    });
+
+    // === PRÉCHARGEMENT ===
+    connect(m_prefetcher, &WeatherPrefetcher::statsChanged, this, [this](const PrefetchStats& stats) {
+        statusBar()->showMessage(QString("Préchargement: %1 villes, %2 succès (%3%)")
+                                     .arg(stats.issued)
+                                     .arg(stats.attributableHits)
+                                     .arg(stats.hitRate() * 100, 0, 'f', 0), 3000);
+    });
+}
+
+void MainWindow::setupCompleter()
+{
+    // Suggestions calculées par SearchHistory (accents/casse ignorés) :
+    // le completer affiche la liste telle quelle, sans refiltrer
+    m_suggestionModel = new QStringListModel(this);
+    m_cityCompleter = new QCompleter(m_suggestionModel, this);
+    m_cityCompleter->setCompletionMode(QCompleter::UnfilteredPopupCompletion);
+    m_cityCompleter->setCaseSensitivity(Qt::CaseInsensitive);
+    m_cityInput->setCompleter(m_cityCompleter);
 }
 
 void MainWindow::setupStatusBar()
@@ -372,19 +612,54 @@ void MainWindow::onSearchButtonClicked()
         QMessageBox::warning(this, "Attention", "Veuillez entrer un nom de ville");
         return;
     }
+
+    // Position saisie : ville en cache la plus proche (index spatial du cache)
+    double latitude = 0.0;
+    double longitude = 0.0;
+    if (parseCoordinates(city, &latitude, &longitude)) {
+        const QStringList nearby = m_weatherService->nearestCachedCities(latitude, longitude, 1,
+                                                                         NEARBY_CITY_RADIUS_KM);
+        if (nearby.isEmpty()) {
+            m_logDisplay->append(QString("📍 Aucune ville en cache à moins de %1 km de %2")
+                                     .arg(NEARBY_CITY_RADIUS_KM, 0, 'f', 0).arg(city));
+            statusBar()->showMessage("Aucune ville connue à proximité", 3000);
+            return;
+        }
+        m_logDisplay->append(QString("📍 Ville en cache la plus proche de %1 : %2").arg(city, nearby.first()));
+        city = nearby.first();
+        m_cityInput->setText(city);
+    }
+
     m_logDisplay->append(QString("=== Recherche pour: %1 ===").arg(city));
-    // Demander météo actuelle ET prévisions
+    m_currentCity = city;
+    m_searchHistory->addSearch(city);
+    m_weatherService->setVisibleCities("current", {city});
 
+    // Demander météo actuelle ET prévisions
     m_weatherService->requestCurrentWeather(city);
 
     m_weatherService->requestForecast(city);
+}
 
-    m_currentCity = city;
+bool MainWindow::parseCoordinates(const QString& text, double* latitude, double* longitude)
+{
+    static const QRegularExpression pattern(
+        QStringLiteral("^\\s*(-?\\d+(?:\\.\\d+)?)\\s*[,;\\s]\\s*(-?\\d+(?:\\.\\d+)?)\\s*$"));
+    const QRegularExpressionMatch match = pattern.match(text);
+    if (!match.hasMatch()) return false;
+
+    const double lat = match.captured(1).toDouble();
+    const double lon = match.captured(2).toDouble();
+    if (lat < -90.0 || lat > 90.0 || lon < -180.0 || lon > 180.0) return false;
+    *latitude = lat;
+    *longitude = lon;
+    return true;
 }
 
 void MainWindow::onClearCacheClicked()
 {
     m_weatherService->clearCache();
+    m_mapWidget->refreshMarkers();
     m_logDisplay->append("Cache vidé manuellement");
 }
 
@@ -393,10 +668,25 @@ void MainWindow::onCityInputReturnPressed()
     onSearchButtonClicked();
 }
 
-void MainWindow::onCurrentWeatherReady(const QString& cityName, const CurrentWeatherData& data)
+void MainWindow::onCityInputEdited(const QString& text)
+{
+    m_suggestionModel->setStringList(m_searchHistory->getSuggestions(text, 8));
+    if (m_suggestionModel->rowCount() > 0) {
+        m_cityCompleter->complete();
+    }
+}
+
+void MainWindow::onCurrentWeatherReady(const QString& cityName, CurrentWeatherPtr data)
 {
     m_logDisplay->append(QString("✓ Météo actuelle reçue pour %1").arg(cityName));
-    displayCurrentWeather(data);
+    displayCurrentWeather(*data);
+
+    // Calculées une fois par entrée du cache, pas à chaque affichage
+    if (DerivedMetricsPtr metrics = m_weatherService->derivedMetrics(cityName)) {
+        m_humidityLabel->setText(QString("Humidité: %1% (rosée %2)")
+                                     .arg(data->humidity, 0, 'f', 0)
+                                     .arg(formatTemperature(metrics->dewPoint)));
+    }
 
     // Cacher loading si visible
     if (m_isLoading) {
@@ -407,13 +697,13 @@ void MainWindow::onCurrentWeatherReady(const QString& cityName, const CurrentWea
     statusBar()->showMessage(QString("Météo de %1 mise à jour").arg(cityName), 5000);
 }
 
-void MainWindow::onForecastReady(const QString& cityName, const ForecastData& data)
+void MainWindow::onForecastReady(const QString& cityName, ForecastPtr data)
 {
     m_logDisplay->append(QString("✓ Prévisions reçues pour %1 (%2 créneaux)")
                              .arg(cityName)
-                             .arg(data.entries.size()));
+                             .arg(data->entries.size()));
 
-    displayForecastSummary(data);
+    displayForecastSummary(*data);
 }
 
 void MainWindow::onLoadingStarted(const QString& cityName, const QString& requestType)
@@ -453,6 +743,60 @@ void MainWindow::onCacheUpdated(const QString& cityName, const QString& dataType
     m_logDisplay->append(QString("💾 Cache mis à jour: %1 (%2)")
                              .arg(cityName)
                              .arg(dataType));
+
+    // Image du graphique rendue depuis l'ancienne entrée : inutile désormais
+    if (dataType == "forecast") {
+        m_chartWidget->invalidateRenderCache(cityName);
+    }
+}
+
+void MainWindow::onBackgroundRefreshCompleted(const QString& cityName, const QString& dataType)
+{
+    m_logDisplay->append(QString("🔄 Rafraîchissement auto: %1 (%2)")
+                             .arg(cityName)
+                             .arg(dataType));
+
+    // Ville affichée : afficher la poignée fraîche du cache, sans repasser par une requête
+    // (qui compterait une consultation et un succès de cache qui n'ont pas eu lieu)
+    const CityKey key = m_weatherService->cityKey(cityName);
+    if (key != m_weatherService->cityKey(m_currentCity)) return;
+
+    const ICacheManager* cache = m_weatherService->cacheManager();
+    if (dataType == "weather") {
+        if (CurrentWeatherPtr data = cache->tryGetWeather(key)) {
+            onCurrentWeatherReady(cityName, data);
+        }
+    } else if (ForecastPtr data = cache->tryGetForecast(key)) {
+        onForecastReady(cityName, data);
+    }
+}
+
+void MainWindow::onDashboardVisibleCitiesChanged(const QStringList& cityNames)
+{
+    // Lignes à l'écran : rafraîchies avant les autres villes (liste vide quand l'onglet est masqué)
+    const int queuedBefore = m_weatherService->queuedRequestCount();
+    m_weatherService->setVisibleCities("dashboard", cityNames);
+    if (!cityNames.isEmpty() && queuedBefore > 0) {
+        m_logDisplay->append(QString("📋 Tableau de bord: %1 ville(s) visibles prioritaires (%2 en attente)")
+                                 .arg(cityNames.size())
+                                 .arg(m_weatherService->queuedRequestCount()));
+    }
+}
+
+void MainWindow::onGazetteerReady()
+{
+    // Fichier prêt (généré par la tâche de fond) : projection sur le thread de l'interface
+    if (!m_weatherService->loadGazetteer(CityGazetteer::defaultPath())) {
+        m_logDisplay->append("Gazetteer absent: recherche par nom côté serveur");
+        return;
+    }
+
+    // Noms du gazetteer proposés par l'autocomplétion, après l'historique
+    const QStringList names = m_gazetteerWatcher->result();
+    for (const QString& name : names) {
+        m_searchHistory->addSuggestionName(name);
+    }
+    m_logDisplay->append(QString("Gazetteer chargé: %1 villes").arg(m_weatherService->gazetteer()->size()));
 }
 
 void MainWindow::displayCurrentWeather(const CurrentWeatherData& data)
@@ -476,20 +820,27 @@ void MainWindow::displayCurrentWeather(const CurrentWeatherData& data)
     m_timestampLabel->setText(QString("Mis à jour: %1").arg(formatTime(data.timestamp)));
 
     // Style selon température
-    QString tempColor = data.temperature >= 25 ? "#FF5722" :
-                            data.temperature >= 15 ? "#FF9800" :
-                            data.temperature >= 5 ? "#2196F3" : "#9C27B0";
+    setTemperatureBand(data.temperature >= 25 ? "hot" :
+                           data.temperature >= 15 ? "warm" :
+                           data.temperature >= 5 ? "mild" : "cold");
+}
+
+void MainWindow::setTemperatureBand(const char* band)
+{
+    // Nouveau style seulement quand la tranche change (pas de re-polish à chaque mise à jour)
+    if (m_temperatureLabel->property("band").toByteArray() == band) return;
 
-    m_temperatureLabel->setStyleSheet(QString("font-size: 18px; font-weight: bold; color: %1;")
-                                          .arg(tempColor));
+    m_temperatureLabel->setProperty("band", QByteArray(band));
+    m_temperatureLabel->style()->unpolish(m_temperatureLabel);
+    m_temperatureLabel->style()->polish(m_temperatureLabel);
 }
 
 void MainWindow::displayForecastSummary(const ForecastData& data)
 {
     m_forecastDisplay->clear();
 
-    // Générer résumés quotidiens
-    auto dailySummaries = data.getDailySummaries();
+    // Résumés quotidiens déjà calculés au parsing (jours locaux de la ville)
+    const QList<ForecastData::DailySummary> dailySummaries = data.getDailySummaries();
 
     m_forecastDisplay->append(QString("=== Prévisions pour %1 ===\n").arg(data.cityName));
 
@@ -502,23 +853,27 @@ void MainWindow::displayForecastSummary(const ForecastData& data)
         else dayName = summary.date.toString("dddd dd/MM");
 
         m_forecastDisplay->append(
-            QString("%1: %2 à %3 - %4")
+            QString("%1: %2 à %3 (moy. %4) - %5, pluie jusqu'à %6%")
                 .arg(dayName)
                 .arg(formatTemperature(summary.minTemp))
                 .arg(formatTemperature(summary.maxTemp))
+                .arg(formatTemperature(summary.meanTemp))
                 .arg(summary.dominantCondition)
+                .arg(summary.maxPrecipitationProbability, 0, 'f', 0)
             );
     }
 
-    // Afficher quelques créneaux détaillés du premier jour
+    if (dailySummaries.isEmpty()) return;
+
+    // Afficher quelques créneaux détaillés du premier jour (heure locale de la ville)
     m_forecastDisplay->append(QString("\n=== Détail Aujourd'hui ==="));
-    auto todayEntries = data.getEntriesForDay(0);
+    const ForecastData::DailySummary& today = dailySummaries.first();
 
-    for (int i = 0; i < qMin(6, todayEntries.size()); ++i) {
-        const auto& entry = todayEntries[i];
+    for (int i = today.firstIndex; i < today.firstIndex + qMin(6, today.count); ++i) {
+        const ForecastEntry& entry = data.entries[i];
         m_forecastDisplay->append(
             QString("%1: %2 - %3 (pluie: %4%)")
-                .arg(entry.dateTime.toString("hh:mm"))
+                .arg(entry.dateTime.toOffsetFromUtc(data.timezoneOffset).toString("hh:mm"))
                 .arg(formatTemperature(entry.temperature))
                 .arg(entry.description)
                 .arg(entry.precipitationProbability, 0, 'f', 0)
@@ -531,7 +886,7 @@ void MainWindow::showErrorState(const QString& message)
     // Afficher erreur dans interface
     m_cityNameLabel->setText("Erreur");
     m_temperatureLabel->setText("--°C");
-    m_temperatureLabel->setStyleSheet("font-size: 16px; color: red;");
+    setTemperatureBand("error");
     m_descriptionLabel->setText(QString("Erreur: %1").arg(message));
 
     // Réinitialiser autres champs
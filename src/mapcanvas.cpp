@@ -0,0 +1,368 @@
+#include "mapcanvas.h"
+#include "maptilecache.h"
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPaintEvent>
+#include <QWheelEvent>
+#include <cmath>
+
+namespace {
+const QColor BACKGROUND_COLOR(0x9C, 0xB9, 0xCE);   // Hors du monde (pôles à faible zoom)
+constexpr int MARKER_RADIUS = 4;
+constexpr int CLICK_TOLERANCE = 4;
+
+// Même découpage que les bandes de température de la fenêtre principale
+QColor temperatureColor(const MapMarker& marker)
+{
+    if (!marker.hasTemperature) return QColor(0x88, 0x88, 0x88);
+    if (marker.temperature >= 30) return QColor(0xD3, 0x2F, 0x2F);
+    if (marker.temperature >= 20) return QColor(0xF5, 0x7C, 0x00);
+    if (marker.temperature >= 10) return QColor(0x38, 0x8E, 0x3C);
+    return QColor(0x19, 0x76, 0xD2);
+}
+
+int floorDiv(int value, int divisor)
+{
+    return value >= 0 ? value / divisor : -((-value + divisor - 1) / divisor);
+}
+
+// Rectangle en pixels physiques du tampon → plus petit rectangle logique qui le couvre
+QRect toLogical(const QRect& device, qreal devicePixelRatio)
+{
+    const int left = int(std::floor(device.x() / devicePixelRatio));
+    const int top = int(std::floor(device.y() / devicePixelRatio));
+    const int right = int(std::ceil((device.x() + device.width()) / devicePixelRatio));
+    const int bottom = int(std::ceil((device.y() + device.height()) / devicePixelRatio));
+    return QRect(left, top, right - left, bottom - top);
+}
+}
+
+MapCanvas::MapCanvas(MapTileCache* tiles, QWidget* parent)
+    : QWidget(parent)
+    , m_tiles(tiles)
+    , m_zoom(0)
+    , m_bufferZoom(-1)
+    , m_bufferValid(false)
+    , m_dragging(false)
+    , m_lastTilesDrawn(0)
+    , m_lastMarkersDrawn(0)
+{
+    setAttribute(Qt::WA_OpaquePaintEvent);   // Le tampon couvre tout le widget
+    setMouseTracking(false);
+    setCursor(Qt::OpenHandCursor);
+    setMinimumSize(200, 120);
+}
+
+// =====================================================
+// MARQUEURS
+// =====================================================
+
+void MapCanvas::setMarkers(const QList<MapMarker>& markers)
+{
+    m_markers = markers;
+    update();   // Tuiles inchangées : le tampon est réutilisé tel quel
+}
+
+void MapCanvas::setHighlightedCity(const QString& name)
+{
+    if (m_highlighted == name) return;
+    m_highlighted = name;
+    update();
+}
+
+void MapCanvas::setOverlay(const QImage& overlay)
+{
+    if (overlay.isNull() && m_overlay.isNull()) return;
+    m_overlay = overlay;
+    m_bufferValid = false;      // Recomposition depuis les tuiles en mémoire
+    update();
+}
+
+// =====================================================
+// VUE
+// =====================================================
+
+void MapCanvas::centerOn(double latitude, double longitude)
+{
+    const QPointF world = MapTileCache::project(latitude, longitude, m_zoom);
+    m_origin = QPoint(qRound(world.x()) - width() / 2, qRound(world.y()) - height() / 2);
+    clampOrigin();
+    update();
+    emit viewportChanged();
+}
+
+void MapCanvas::setZoom(int zoom, const QPoint& anchor)
+{
+    zoom = qBound(0, zoom, int(MapTileCache::MAX_ZOOM));
+    if (zoom == m_zoom) return;
+
+    // Le point sous l'ancre reste sous l'ancre
+    const QPointF anchorWorld = QPointF(m_origin + anchor);
+    const double factor = std::pow(2.0, zoom - m_zoom);
+    m_zoom = zoom;
+    m_origin = QPoint(qRound(anchorWorld.x() * factor) - anchor.x(),
+                      qRound(anchorWorld.y() * factor) - anchor.y());
+    clampOrigin();
+    update();
+    emit viewportChanged();
+}
+
+void MapCanvas::panBy(const QPoint& delta)
+{
+    if (delta.isNull()) return;
+    const QPoint before = m_origin;
+    m_origin -= delta;
+    clampOrigin();
+    if (m_origin != before) {
+        update();
+        emit viewportChanged();
+    }
+}
+
+QRectF MapCanvas::visibleBounds() const
+{
+    // Longitudes non ramenées dans [-180, 180] : l'appelant gère le bouclage
+    const QPointF topLeft = MapTileCache::unproject(QPointF(m_origin), m_zoom);
+    const QPointF bottomRight = MapTileCache::unproject(QPointF(m_origin + QPoint(width(), height())), m_zoom);
+    return QRectF(QPointF(topLeft.x(), qMax(-90.0, bottomRight.y())),
+                  QPointF(bottomRight.x(), qMin(90.0, topLeft.y())));
+}
+
+QPointF MapCanvas::toWidget(double latitude, double longitude) const
+{
+    const QPointF world = MapTileCache::project(latitude, longitude, m_zoom);
+    const int worldWidth = MapTileCache::worldSize(m_zoom).width();
+
+    // Copie du monde la plus proche du centre de la vue
+    double x = world.x() - m_origin.x();
+    const double center = width() / 2.0;
+    x -= std::round((x - center) / worldWidth) * worldWidth;
+    return QPointF(x, world.y() - m_origin.y());
+}
+
+void MapCanvas::clampOrigin()
+{
+    const QSize world = MapTileCache::worldSize(m_zoom);
+    m_origin.setX(wrapX(m_origin.x()));
+
+    // Verticalement : monde centré s'il est plus petit que la vue, sinon borné
+    if (world.height() <= height()) {
+        m_origin.setY(-(height() - world.height()) / 2);
+    } else {
+        m_origin.setY(qBound(0, m_origin.y(), world.height() - height()));
+    }
+}
+
+int MapCanvas::wrapX(int worldX) const
+{
+    const int worldWidth = MapTileCache::worldSize(m_zoom).width();
+    return ((worldX % worldWidth) + worldWidth) % worldWidth;
+}
+
+// =====================================================
+// RENDU
+// =====================================================
+
+void MapCanvas::updateBuffer()
+{
+    m_lastTilesDrawn = 0;
+    if (size().isEmpty()) return;
+
+    // Tampon en pixels physiques (écrans HiDPI), dessiné en coordonnées logiques
+    const qreal dpr = devicePixelRatioF();
+    const QSize deviceSize = (QSizeF(size()) * dpr).toSize();
+
+    QRegion dirty;      // Coordonnées logiques
+    if (!m_bufferValid || m_bufferZoom != m_zoom || m_buffer.size() != deviceSize
+        || m_buffer.devicePixelRatio() != dpr) {
+        m_buffer = QPixmap(deviceSize);
+        m_buffer.setDevicePixelRatio(dpr);
+        dirty = QRegion(rect());
+    } else {
+        // Décalage du contenu, le plus court modulo la largeur du monde
+        const int worldWidth = MapTileCache::worldSize(m_zoom).width();
+        int dx = m_bufferOrigin.x() - m_origin.x();
+        dx -= int(std::round(double(dx) / worldWidth)) * worldWidth;
+        const int dy = m_bufferOrigin.y() - m_origin.y();
+        if (dx == 0 && dy == 0) return;
+
+        // scroll() travaille en pixels physiques : décalage fractionnaire (facteur 1,5...) → recomposition
+        const QPoint deviceDelta(qRound(dx * dpr), qRound(dy * dpr));
+        const bool wholePixels = qAbs(deviceDelta.x() - dx * dpr) < 1e-6 && qAbs(deviceDelta.y() - dy * dpr) < 1e-6;
+
+        if (qAbs(dx) >= width() || qAbs(dy) >= height() || !wholePixels) {
+            dirty = QRegion(rect());
+        } else {
+            QRegion exposed;
+            m_buffer.scroll(deviceDelta.x(), deviceDelta.y(), m_buffer.rect(), &exposed);
+            for (const QRect& area : exposed) {
+                dirty += toLogical(area, dpr);
+            }
+        }
+    }
+
+    QPainter painter(&m_buffer);
+    painter.setClipRegion(dirty);
+    for (const QRect& area : dirty) {
+        drawTiles(painter, area);
+    }
+
+    m_bufferOrigin = m_origin;
+    m_bufferZoom = m_zoom;
+    m_bufferValid = true;
+}
+
+void MapCanvas::drawTiles(QPainter& painter, const QRect& area)
+{
+    // Limité à la zone : le calque ne doit pas se superposer deux fois
+    painter.save();
+    painter.setClipRect(area, Qt::IntersectClip);
+    painter.fillRect(area, BACKGROUND_COLOR);
+
+    // Tuiles recouvrant la zone (coordonnées monde, x non borné)
+    const int tileSize = MapTileCache::TILE_SIZE;
+    const QRect world = area.translated(m_origin);
+    const int firstX = floorDiv(world.left(), tileSize);
+    const int lastX = floorDiv(world.right(), tileSize);
+    const int firstY = qMax(0, floorDiv(world.top(), tileSize));
+    const int lastY = qMin(MapTileCache::tilesY(m_zoom) - 1, floorDiv(world.bottom(), tileSize));
+
+    for (int ty = firstY; ty <= lastY; ++ty) {
+        for (int tx = firstX; tx <= lastX; ++tx) {
+            const QImage image = m_tiles->tile(m_zoom, tx, ty);
+            if (image.isNull()) continue;
+            painter.drawImage(QPoint(tx * tileSize - m_origin.x(), ty * tileSize - m_origin.y()), image);
+            ++m_lastTilesDrawn;
+        }
+    }
+
+    // Calque étiré sur chaque copie du monde recouvrant la zone
+    if (!m_overlay.isNull()) {
+        const QSize worldSize = MapTileCache::worldSize(m_zoom);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform);
+        for (int copy = floorDiv(world.left(), worldSize.width());
+             copy <= floorDiv(world.right(), worldSize.width()); ++copy) {
+            const QRect target(copy * worldSize.width() - m_origin.x(), -m_origin.y(),
+                               worldSize.width(), worldSize.height());
+            painter.drawImage(target, m_overlay);
+        }
+    }
+    painter.restore();
+}
+
+void MapCanvas::paintEvent(QPaintEvent* event)
+{
+    updateBuffer();
+
+    // Cible logique, source en pixels physiques du tampon
+    const QRect target = event->rect();
+    const qreal dpr = m_buffer.devicePixelRatio();
+    const QRectF source(QPointF(target.topLeft()) * dpr, QSizeF(target.size()) * dpr);
+    QPainter painter(this);
+    painter.drawPixmap(QRectF(target), m_buffer, source);
+
+    // Marqueurs à l'écran seulement ; la ville mise en avant par-dessus
+    painter.setRenderHint(QPainter::Antialiasing);
+    const QRectF visible = QRectF(rect()).adjusted(-MARKER_RADIUS, -MARKER_RADIUS, MARKER_RADIUS, MARKER_RADIUS);
+    m_lastMarkersDrawn = 0;
+    const MapMarker* highlighted = nullptr;
+    for (const MapMarker& marker : m_markers) {
+        const QPointF pos = toWidget(marker.latitude, marker.longitude);
+        if (!visible.contains(pos)) continue;
+        if (marker.name == m_highlighted) {
+            highlighted = &marker;
+            continue;
+        }
+        drawMarker(painter, marker, pos, false);
+        ++m_lastMarkersDrawn;
+    }
+    if (highlighted) {
+        drawMarker(painter, *highlighted, toWidget(highlighted->latitude, highlighted->longitude), true);
+        ++m_lastMarkersDrawn;
+    }
+}
+
+void MapCanvas::drawMarker(QPainter& painter, const MapMarker& marker, const QPointF& pos, bool highlighted) const
+{
+    const double radius = highlighted ? MARKER_RADIUS + 2 : MARKER_RADIUS;
+    painter.setPen(QPen(Qt::white, highlighted ? 2 : 1));
+    painter.setBrush(temperatureColor(marker));
+    painter.drawEllipse(pos, radius, radius);
+
+    // Étiquette : ville mise en avant, ou toutes à partir d'un zoom suffisant
+    if (highlighted || m_zoom >= 3) {
+        const QString text = marker.label.isEmpty() ? marker.name : marker.label;
+        painter.setPen(highlighted ? Qt::black : QColor(0x33, 0x33, 0x33));
+        painter.drawText(pos + QPointF(radius + 3, 4), text);
+    }
+}
+
+void MapCanvas::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+    clampOrigin();
+    emit viewportChanged();
+}
+
+// =====================================================
+// INTERACTIONS
+// =====================================================
+
+void MapCanvas::mousePressEvent(QMouseEvent* event)
+{
+    if (event->button() != Qt::LeftButton) return;
+    m_pressPos = event->position().toPoint();
+    m_lastDragPos = m_pressPos;
+    m_dragging = true;
+    setCursor(Qt::ClosedHandCursor);
+}
+
+void MapCanvas::mouseMoveEvent(QMouseEvent* event)
+{
+    if (!m_dragging) return;
+    const QPoint pos = event->position().toPoint();
+    panBy(pos - m_lastDragPos);
+    m_lastDragPos = pos;
+}
+
+void MapCanvas::mouseReleaseEvent(QMouseEvent* event)
+{
+    if (event->button() != Qt::LeftButton || !m_dragging) return;
+    m_dragging = false;
+    setCursor(Qt::OpenHandCursor);
+
+    // Clic sans déplacement : sélection d'un marqueur
+    const QPoint pos = event->position().toPoint();
+    if ((pos - m_pressPos).manhattanLength() <= CLICK_TOLERANCE) {
+        const QString name = markerAt(pos);
+        if (!name.isEmpty()) {
+            emit markerClicked(name);
+        }
+    }
+}
+
+void MapCanvas::mouseDoubleClickEvent(QMouseEvent* event)
+{
+    setZoom(m_zoom + 1, event->position().toPoint());
+}
+
+void MapCanvas::wheelEvent(QWheelEvent* event)
+{
+    const int steps = event->angleDelta().y() / 120;
+    if (steps != 0) {
+        setZoom(m_zoom + steps, event->position().toPoint());
+    }
+    event->accept();
+}
+
+QString MapCanvas::markerAt(const QPoint& pos) const
+{
+    const double tolerance = MARKER_RADIUS + CLICK_TOLERANCE;
+    for (auto it = m_markers.crbegin(); it != m_markers.crend(); ++it) {
+        const QPointF delta = toWidget(it->latitude, it->longitude) - QPointF(pos);
+        if (delta.x() * delta.x() + delta.y() * delta.y() <= tolerance * tolerance) {
+            return it->name;
+        }
+    }
+    return QString();
+}
@@ -0,0 +1,117 @@
+#ifndef MAPCANVAS_H
+#define MAPCANVAS_H
+
+#include <QWidget>
+#include <QImage>
+#include <QList>
+#include <QPixmap>
+#include <QPoint>
+#include <QRectF>
+#include <QString>
+
+class MapTileCache;
+
+/**
+ * Marqueur de ville sur la carte
+ */
+struct MapMarker {
+    QString name;               // Nom utilisé pour les requêtes
+    QString label;              // Texte affiché ("Paris 21°C")
+    double latitude = 0.0;
+    double longitude = 0.0;
+    double temperature = 0.0;
+    bool hasTemperature = false;
+};
+
+/**
+ * Surface de la carte hors ligne : tuiles + marqueurs
+ *
+ * - Les tuiles sont composées dans un tampon de la taille du widget
+ *   (en pixels physiques : net sur les écrans HiDPI) ;
+ *   un déplacement décale le tampon (QPixmap::scroll) et seules les
+ *   bandes découvertes sont redessinées. Zoom ou redimensionnement :
+ *   recomposition complète depuis le cache de tuiles
+ * - Calque optionnel (carte de chaleur) composé avec les tuiles
+ * - Les marqueurs sont dessinés par-dessus à chaque image (lignes à
+ *   l'écran seulement) ; le monde se répète horizontalement
+ * - Glisser pour déplacer, molette ou double-clic pour zoomer,
+ *   clic sur un marqueur → markerClicked()
+ */
+class MapCanvas : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit MapCanvas(MapTileCache* tiles, QWidget* parent = nullptr);
+
+    // Marqueurs (remplacent les précédents)
+    void setMarkers(const QList<MapMarker>& markers);
+    const QList<MapMarker>& markers() const { return m_markers; }
+    void setHighlightedCity(const QString& name);
+
+    /**
+     * Calque étiré sur tout le monde (carte de chaleur...), image nulle : aucun
+     * Composé dans le tampon avec les tuiles : un déplacement ne le redessine pas
+     */
+    void setOverlay(const QImage& overlay);
+    const QImage& overlay() const { return m_overlay; }
+
+    // Vue
+    void centerOn(double latitude, double longitude);
+    void setZoom(int zoom, const QPoint& anchor);
+    void setZoom(int zoom) { setZoom(zoom, rect().center()); }
+    int zoom() const { return m_zoom; }
+    void panBy(const QPoint& delta);            // Le contenu suit la souris
+    QRectF visibleBounds() const;              // (lon, lat) de la zone affichée
+
+    // Position d'un point (lat, lon) dans le widget (copie du monde la plus proche)
+    QPointF toWidget(double latitude, double longitude) const;
+
+    // === STATISTIQUES ===
+    int lastTilesDrawn() const { return m_lastTilesDrawn; }
+    int lastMarkersDrawn() const { return m_lastMarkersDrawn; }
+
+signals:
+    void viewportChanged();
+    void markerClicked(const QString& name);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+    void mouseDoubleClickEvent(QMouseEvent* event) override;
+    void wheelEvent(QWheelEvent* event) override;
+
+private:
+    MapTileCache* m_tiles;
+    int m_zoom;
+    QPoint m_origin;            // Pixel monde du coin haut-gauche
+
+    QPixmap m_buffer;           // Tuiles composées
+    QPoint m_bufferOrigin;
+    int m_bufferZoom;
+    bool m_bufferValid;
+
+    QImage m_overlay;
+
+    QList<MapMarker> m_markers;
+    QString m_highlighted;
+
+    QPoint m_pressPos;
+    QPoint m_lastDragPos;
+    bool m_dragging;
+
+    int m_lastTilesDrawn;
+    int m_lastMarkersDrawn;
+
+    void updateBuffer();
+    void drawTiles(QPainter& painter, const QRect& area);
+    void drawMarker(QPainter& painter, const MapMarker& marker, const QPointF& pos, bool highlighted) const;
+    void clampOrigin();
+    int wrapX(int worldX) const;
+    QString markerAt(const QPoint& pos) const;
+};
+
+#endif // MAPCANVAS_H
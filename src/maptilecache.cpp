@@ -0,0 +1,251 @@
+#include "maptilecache.h"
+#include <QColor>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QPainter>
+#include <QPainterPath>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTextStream>
+
+namespace {
+// Version du style de rendu : la changer régénère les tuiles sur disque
+const QByteArray RENDER_STYLE = "style-1";
+
+const QColor OCEAN_COLOR(0xB5, 0xD3, 0xE7);
+const QColor LAND_COLOR(0xEF, 0xEB, 0xDD);
+const QColor COAST_COLOR(0x8E, 0x9C, 0x86);
+const QColor GRATICULE_COLOR(0xCF, 0xE0, 0xEC);
+
+// Degrés couverts par une tuile du niveau zoom (identiques en longitude et latitude)
+double tileSpanDegrees(int zoom)
+{
+    return 360.0 / MapTileCache::tilesX(zoom);
+}
+}
+
+MapTileCache::MapTileCache(const QString& cacheDir, qint64 memoryBytes)
+    : m_baseDir(cacheDir)
+    , m_memory(qsizetype(memoryBytes / 1024))
+    , m_memoryHits(0)
+    , m_diskHits(0)
+    , m_rendered(0)
+{
+}
+
+bool MapTileCache::loadCoastlines(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        qWarning() << "MapTileCache: cannot open coastlines" << path;
+        return false;
+    }
+    const QByteArray content = file.readAll();
+
+    QList<Shape> land;
+    QList<Shape> water;
+    QList<Shape>* target = nullptr;
+    QPolygonF current;
+
+    auto finishShape = [&]() {
+        if (target && current.size() >= 3) {
+            target->append({current, current.boundingRect()});
+        }
+        current.clear();
+    };
+
+    QTextStream stream(content);
+    while (!stream.atEnd()) {
+        const QString line = stream.readLine().trimmed();
+        if (line.isEmpty() || line.startsWith('#')) continue;
+
+        if (line.startsWith(QLatin1String("land")) || line.startsWith(QLatin1String("water"))) {
+            finishShape();
+            target = line.startsWith(QLatin1String("land")) ? &land : &water;
+            continue;
+        }
+
+        const QStringList parts = line.split(' ', Qt::SkipEmptyParts);
+        bool lonOk = false;
+        bool latOk = false;
+        const double lon = parts.value(0).toDouble(&lonOk);
+        const double lat = parts.value(1).toDouble(&latOk);
+        if (!target || parts.size() != 2 || !lonOk || !latOk) {
+            qWarning() << "MapTileCache: invalid coastline line" << line;
+            return false;
+        }
+        current.append(QPointF(lon, lat));
+    }
+    finishShape();
+
+    m_land = land;
+    m_water = water;
+    m_memory.clear();
+
+    // Répertoire propre à ce jeu de données et à ce style de rendu
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(content);
+    hash.addData(RENDER_STYLE);
+    m_cacheDir = m_baseDir.isEmpty() ? QString()
+                                     : m_baseDir + "/" + QString::fromLatin1(hash.result().toHex().left(12));
+    return true;
+}
+
+// =====================================================
+// PROJECTION
+// =====================================================
+
+QPointF MapTileCache::project(double latitude, double longitude, int zoom)
+{
+    const QSize world = worldSize(zoom);
+    return QPointF((longitude + 180.0) / 360.0 * world.width(),
+                   (90.0 - latitude) / 180.0 * world.height());
+}
+
+QPointF MapTileCache::unproject(const QPointF& worldPoint, int zoom)
+{
+    const QSize world = worldSize(zoom);
+    return QPointF(worldPoint.x() / world.width() * 360.0 - 180.0,
+                   90.0 - worldPoint.y() / world.height() * 180.0);
+}
+
+// =====================================================
+// TUILES
+// =====================================================
+
+QImage MapTileCache::tile(int zoom, int x, int y)
+{
+    if (zoom < 0 || zoom > MAX_ZOOM || y < 0 || y >= tilesY(zoom)) {
+        return QImage();
+    }
+    x = ((x % tilesX(zoom)) + tilesX(zoom)) % tilesX(zoom);
+
+    const quint64 id = tileId(zoom, x, y);
+    if (QImage* cached = m_memory.object(id)) {
+        ++m_memoryHits;
+        return *cached;
+    }
+
+    QImage image;
+    const QString path = tilePath(zoom, x, y);
+    if (!path.isEmpty() && image.load(path)) {
+        ++m_diskHits;
+    } else {
+        image = renderTile(zoom, x, y);
+        m_rendered.fetch_add(1, std::memory_order_relaxed);
+        if (!path.isEmpty() && QDir().mkpath(QFileInfo(path).absolutePath())) {
+            saveTile(image, path);
+        }
+    }
+
+    m_memory.insert(id, new QImage(image), qMax<qsizetype>(1, image.sizeInBytes() / 1024));
+    return image;
+}
+
+QImage MapTileCache::renderTile(int zoom, int x, int y) const
+{
+    QImage image(TILE_SIZE, TILE_SIZE, QImage::Format_RGB32);
+    image.fill(OCEAN_COLOR);
+
+    // Étendue de la tuile en degrés (lon, lat), pour ignorer les polygones hors tuile
+    const double span = tileSpanDegrees(zoom);
+    const QRectF tileBounds(-180.0 + x * span, 90.0 - (y + 1) * span, span, span);
+
+    // (lon, lat) → pixels de la tuile
+    const double pixelsPerDegree = TILE_SIZE / span;
+    QTransform transform;
+    transform.translate(-x * TILE_SIZE, -y * TILE_SIZE);
+    transform.scale(pixelsPerDegree, pixelsPerDegree);
+    transform.translate(180.0, 90.0);
+    transform.scale(1.0, -1.0);
+
+    QPainter painter(&image);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setTransform(transform);
+
+    // Graticule tous les 30°
+    QPen graticulePen(GRATICULE_COLOR);
+    graticulePen.setCosmetic(true);
+    painter.setPen(graticulePen);
+    for (int lon = -180; lon <= 180; lon += 30) {
+        painter.drawLine(QPointF(lon, -90), QPointF(lon, 90));
+    }
+    for (int lat = -60; lat <= 60; lat += 30) {
+        painter.drawLine(QPointF(-180, lat), QPointF(180, lat));
+    }
+
+    QPen coastPen(COAST_COLOR);
+    coastPen.setCosmetic(true);
+    painter.setPen(coastPen);
+    painter.setBrush(LAND_COLOR);
+    drawShapes(painter, m_land, tileBounds);
+    painter.setBrush(OCEAN_COLOR);
+    drawShapes(painter, m_water, tileBounds);
+
+    return image;
+}
+
+void MapTileCache::drawShapes(QPainter& painter, const QList<Shape>& shapes, const QRectF& tileBounds) const
+{
+    // Marge d'un pixel pour le trait de côte des polygones voisins
+    const double margin = tileBounds.width() / TILE_SIZE;
+    const QRectF visible = tileBounds.adjusted(-margin, -margin, margin, margin);
+    for (const Shape& shape : shapes) {
+        if (shape.bounds.intersects(visible)) {
+            painter.drawPolygon(shape.points);
+        }
+    }
+}
+
+int MapTileCache::pregenerate(int maxZoom, const std::atomic<bool>* cancelled) const
+{
+    if (m_cacheDir.isEmpty()) return 0;
+
+    int generated = 0;
+    for (int zoom = 0; zoom <= qMin(maxZoom, int(MAX_ZOOM)); ++zoom) {
+        QDir().mkpath(m_cacheDir + "/" + QString::number(zoom));
+        for (int y = 0; y < tilesY(zoom); ++y) {
+            for (int x = 0; x < tilesX(zoom); ++x) {
+                if (cancelled && cancelled->load()) return generated;
+                const QString path = tilePath(zoom, x, y);
+                if (QFile::exists(path)) continue;
+                if (saveTile(renderTile(zoom, x, y), path)) {
+                    ++generated;
+                }
+                m_rendered.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    return generated;
+}
+
+QString MapTileCache::defaultCacheDir()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/maptiles";
+}
+
+// =====================================================
+// UTILITAIRES
+// =====================================================
+
+quint64 MapTileCache::tileId(int zoom, int x, int y)
+{
+    return (quint64(zoom) << 48) | (quint64(quint32(y)) << 24) | quint64(quint32(x));
+}
+
+QString MapTileCache::tilePath(int zoom, int x, int y) const
+{
+    if (m_cacheDir.isEmpty()) return QString();
+    return QString("%1/%2/%3_%4.png").arg(m_cacheDir).arg(zoom).arg(x).arg(y);
+}
+
+bool MapTileCache::saveTile(const QImage& image, const QString& path)
+{
+    // Fichier temporaire renommé : jamais de PNG tronqué visible par l'autre thread
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly)) return false;
+    return image.save(&file, "PNG") && file.commit();
+}
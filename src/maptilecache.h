@@ -0,0 +1,98 @@
+#ifndef MAPTILECACHE_H
+#define MAPTILECACHE_H
+
+#include <QCache>
+#include <QImage>
+#include <QList>
+#include <QPointF>
+#include <QPolygonF>
+#include <QRectF>
+#include <QSize>
+#include <QString>
+#include <atomic>
+
+class QPainter;
+
+/**
+ * Pyramide de tuiles de la carte hors ligne (aucun service en ligne)
+ *
+ * - Fond : traits de côte simplifiés livrés avec l'application
+ *   (ressource :/map/coastlines.txt), projection équirectangulaire
+ * - Niveau z : monde de (2^(z+1) x 2^z) tuiles de TILE_SIZE pixels
+ * - tile() : mémoire (QCache), puis disque, sinon rendu puis écriture sur
+ *   disque ; une tuile n'est donc rendue qu'une fois par poste
+ * - Répertoire disque nommé d'après l'empreinte du jeu de données :
+ *   modifier les traits de côte régénère la pyramide
+ * - renderTile() et pregenerate() ne lisent que les traits de côte : sûrs
+ *   depuis un autre thread tant que loadCoastlines() n'est pas rappelé ;
+ *   les écritures disque sont atomiques (QSaveFile), une tuile lue pendant
+ *   sa génération est donc complète ou absente
+ */
+class MapTileCache
+{
+public:
+    static constexpr int TILE_SIZE = 256;
+    static constexpr int MAX_ZOOM = 5;
+    static constexpr qint64 DEFAULT_MEMORY_BYTES = 32 * 1024 * 1024;
+
+    explicit MapTileCache(const QString& cacheDir = defaultCacheDir(),
+                          qint64 memoryBytes = DEFAULT_MEMORY_BYTES);
+
+    // Chargement des traits de côte (remplace les précédents, vide la mémoire)
+    bool loadCoastlines(const QString& path = QStringLiteral(":/map/coastlines.txt"));
+    int polygonCount() const { return int(m_land.size() + m_water.size()); }
+
+    // === PROJECTION (pixels monde au niveau zoom) ===
+    static int tilesX(int zoom) { return 2 << zoom; }
+    static int tilesY(int zoom) { return 1 << zoom; }
+    static QSize worldSize(int zoom) { return QSize(tilesX(zoom) * TILE_SIZE, tilesY(zoom) * TILE_SIZE); }
+    static QPointF project(double latitude, double longitude, int zoom);
+    static QPointF unproject(const QPointF& worldPoint, int zoom);   // (lon, lat)
+
+    /**
+     * Tuile (x, y) du niveau zoom ; x est ramené dans [0, tilesX[ (monde cyclique)
+     * Image nulle si y ou zoom est hors limites
+     */
+    QImage tile(int zoom, int x, int y);
+
+    // Rendu direct, sans cache
+    QImage renderTile(int zoom, int x, int y) const;
+
+    /**
+     * Génère sur disque les tuiles manquantes des niveaux 0..maxZoom
+     * (prévu pour un thread de travail : n'utilise pas le cache mémoire)
+     * @param cancelled Arrêt avant la tuile suivante dès qu'il passe à true
+     * @return nombre de tuiles générées
+     */
+    int pregenerate(int maxZoom, const std::atomic<bool>* cancelled = nullptr) const;
+
+    QString cacheDir() const { return m_cacheDir; }
+    static QString defaultCacheDir();
+
+    // === STATISTIQUES ===
+    qint64 memoryHits() const { return m_memoryHits; }
+    qint64 diskHits() const { return m_diskHits; }
+    qint64 renderedCount() const { return m_rendered.load(std::memory_order_relaxed); }
+
+private:
+    struct Shape {
+        QPolygonF points;   // (lon, lat)
+        QRectF bounds;
+    };
+
+    QList<Shape> m_land;
+    QList<Shape> m_water;
+    QString m_baseDir;
+    QString m_cacheDir;     // m_baseDir/<empreinte du jeu de données>
+    QCache<quint64, QImage> m_memory;
+    qint64 m_memoryHits;
+    qint64 m_diskHits;
+    mutable std::atomic<qint64> m_rendered;     // Incrémenté aussi par pregenerate()
+
+    static quint64 tileId(int zoom, int x, int y);
+    QString tilePath(int zoom, int x, int y) const;
+    static bool saveTile(const QImage& image, const QString& path);
+    void drawShapes(QPainter& painter, const QList<Shape>& shapes, const QRectF& tileBounds) const;
+};
+
+#endif // MAPTILECACHE_H
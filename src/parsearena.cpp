@@ -0,0 +1,36 @@
+#include "parsearena.h"
+
+ParseArena::ParseArena(size_t initialBytes, std::pmr::memory_resource* upstream)
+    : m_resource(initialBytes, upstream)
+    , m_hits(0)
+{
+    m_strings.emplace(&m_resource);
+}
+
+QString ParseArena::intern(const QString& value)
+{
+    if (value.isEmpty()) {
+        return value;
+    }
+
+    auto it = m_strings->find(QStringView(value));
+    if (it != m_strings->end()) {
+        ++m_hits;
+        return it->second;
+    }
+
+    // Clé = vue sur la copie stockée (mêmes données partagées que `value`)
+    QString stored = value;
+    QStringView key(stored);
+    m_strings->emplace(key, std::move(stored));
+    return value;
+}
+
+void ParseArena::release()
+{
+    // La table rend ses QString avant que la mémoire de ses nœuds ne soit récupérée
+    m_strings.reset();
+    m_resource.release();
+    m_strings.emplace(&m_resource);
+    m_hits = 0;
+}
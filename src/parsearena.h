@@ -0,0 +1,57 @@
+#ifndef PARSEARENA_H
+#define PARSEARENA_H
+
+#include <QString>
+#include <QStringView>
+#include <QHash>
+#include <memory_resource>
+#include <optional>
+#include <unordered_map>
+
+/**
+ * Mémoire de travail d'un lot de parsing JSON
+ *
+ * - Les temporaires du parseur (table d'internement) sont pris dans un
+ *   tampon monotone : aucune libération individuelle, tout est rendu
+ *   d'un coup par release() ou à la destruction
+ * - intern() renvoie une QString partagée pour les valeurs répétées
+ *   ("Rain", "pluie modérée", "10d"...) : 40 créneaux × N villes
+ *   n'allouent qu'une copie de chaque libellé
+ *
+ * Un arena n'est pas thread-safe : un par lot / par thread.
+ * Les blocs viennent de `upstream` (par défaut la ressource pmr par défaut
+ * au moment de la construction), ce qui permet de les compter.
+ */
+class ParseArena
+{
+public:
+    explicit ParseArena(size_t initialBytes = 16 * 1024,
+                        std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+    ParseArena(const ParseArena&) = delete;
+    ParseArena& operator=(const ParseArena&) = delete;
+
+    // Chaîne équivalente déjà vue dans ce lot, sinon `value` qui devient la référence
+    QString intern(const QString& value);
+
+    // Libère d'un coup tous les temporaires du lot (les QString renvoyées restent valides)
+    void release();
+
+    int internedCount() const { return int(m_strings->size()); }
+    int internHits() const { return m_hits; }
+
+private:
+    struct ViewHash {
+        size_t operator()(QStringView view) const noexcept { return qHash(view); }
+    };
+
+    // Premier bloc de initialBytes, puis blocs croissants ; jamais libérés un par un
+    std::pmr::monotonic_buffer_resource m_resource;
+    // Les clés pointent dans les données des valeurs (nœuds stables) ;
+    // recréée après release() car ses blocs appartiennent à m_resource
+    using InternTable = std::pmr::unordered_map<QStringView, QString, ViewHash>;
+    std::optional<InternTable> m_strings;
+    int m_hits;
+};
+
+#endif // PARSEARENA_H
@@ -0,0 +1,199 @@
+#include "refreshscheduler.h"
+#include <QRandomGenerator>
+#include <QDebug>
+#include <limits>
+
+RefreshScheduler::RefreshScheduler(QObject* parent)
+    : QObject(parent)
+    , m_timer(nullptr)
+    , m_leadTimeSecs(60)
+    , m_jitterSecs(45)
+    , m_idleThresholdMins(60)
+    , m_maxBackoffLevel(3)
+{
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &RefreshScheduler::onTimerFired);
+}
+
+void RefreshScheduler::setLeadTime(int seconds)
+{
+    m_leadTimeSecs = qMax(0, seconds);
+}
+
+void RefreshScheduler::setJitter(int seconds)
+{
+    m_jitterSecs = qMax(0, seconds);
+}
+
+void RefreshScheduler::setIdleThreshold(int minutes)
+{
+    m_idleThresholdMins = qMax(1, minutes);
+}
+
+void RefreshScheduler::setMaxBackoffLevel(int level)
+{
+    m_maxBackoffLevel = qMax(0, level);
+}
+
+void RefreshScheduler::watchCity(const CityKey& key)
+{
+    if (!m_cities.contains(key)) {
+        m_cities.insert(key, CityState());
+    }
+}
+
+void RefreshScheduler::unwatchCity(const CityKey& key)
+{
+    if (!m_cities.contains(key)) return;
+
+    setDeadline(key, WeatherDataType::Weather, 0);
+    setDeadline(key, WeatherDataType::Forecast, 0);
+    m_cities.remove(key);
+    rearmTimer();
+}
+
+void RefreshScheduler::markViewed(const CityKey& key)
+{
+    watchCity(key);
+    CityState& state = m_cities[key];
+    state.lastViewed = QDateTime::currentDateTime();
+    state.weatherBackoff = 0;
+    state.forecastBackoff = 0;
+}
+
+bool RefreshScheduler::isWatched(const CityKey& key) const
+{
+    return m_cities.contains(key);
+}
+
+QList<CityKey> RefreshScheduler::watchedCities() const
+{
+    return m_cities.keys();
+}
+
+void RefreshScheduler::clear()
+{
+    m_cities.clear();
+    m_queue.clear();
+    m_timer->stop();
+}
+
+void RefreshScheduler::scheduleRefresh(const CityKey& key, WeatherDataType dataType, const CacheInfo& info)
+{
+    auto it = m_cities.find(key);
+    if (it == m_cities.end() || !info.cachedAt.isValid()) {
+        return; // Ville non surveillée
+    }
+
+    CityState& state = it.value();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const qint64 validityMs = qint64(info.validityMinutes) * 60 * 1000;
+    const qint64 expiry = info.cachedAt.toMSecsSinceEpoch() + validityMs;
+    const qint64 jitter = QRandomGenerator::global()->bounded(m_jitterSecs * 1000 + 1);
+
+    bool idle = !state.lastViewed.isValid()
+                || state.lastViewed.secsTo(QDateTime::currentDateTime()) > m_idleThresholdMins * 60;
+
+    // Niveau propre au type : météo et prévisions avancent chacune d'un cran par cycle
+    int& backoff = backoffFor(state, dataType);
+    qint64 deadline;
+    if (!idle) {
+        // Ville consultée récemment : rafraîchir juste avant l'expiration
+        backoff = 0;
+        deadline = expiry - qint64(m_leadTimeSecs) * 1000 - jitter;
+    } else {
+        // Ville délaissée : laisser expirer puis espacer les rafraîchissements
+        if (backoff >= m_maxBackoffLevel) {
+            qDebug() << "RefreshScheduler: stop watching idle city" << key.toString();
+            unwatchCity(key);
+            return;
+        }
+        ++backoff;
+        deadline = expiry + validityMs * ((qint64(1) << backoff) - 1) + jitter;
+    }
+
+    setDeadline(key, dataType, qMax(deadline, now + 1000));
+    rearmTimer();
+}
+
+void RefreshScheduler::postpone(const CityKey& key, WeatherDataType dataType, int seconds)
+{
+    if (!m_cities.contains(key)) return;
+
+    const qint64 jitter = QRandomGenerator::global()->bounded(m_jitterSecs * 1000 + 1);
+    setDeadline(key, dataType,
+                QDateTime::currentMSecsSinceEpoch() + qint64(seconds) * 1000 + jitter);
+    rearmTimer();
+}
+
+qint64 RefreshScheduler::nextRefresh(const CityKey& key, WeatherDataType dataType) const
+{
+    auto it = m_cities.constFind(key);
+    if (it == m_cities.cend()) return 0;
+    return dataType == WeatherDataType::Forecast ? it.value().forecastDeadline : it.value().weatherDeadline;
+}
+
+void RefreshScheduler::onTimerFired()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+
+    QList<QPair<CityKey, WeatherDataType>> due;
+    while (!m_queue.isEmpty() && m_queue.firstKey() <= now) {
+        auto first = m_queue.begin();
+        due.append(first.value());
+        m_queue.erase(first);
+    }
+
+    for (const auto& item : due) {
+        auto it = m_cities.find(item.first);
+        if (it == m_cities.end()) continue;
+        deadlineFor(it.value(), item.second) = 0;
+        emit refreshDue(item.first, item.second);
+    }
+
+    rearmTimer();
+}
+
+qint64& RefreshScheduler::deadlineFor(CityState& state, WeatherDataType dataType) const
+{
+    return dataType == WeatherDataType::Forecast ? state.forecastDeadline : state.weatherDeadline;
+}
+
+int& RefreshScheduler::backoffFor(CityState& state, WeatherDataType dataType) const
+{
+    return dataType == WeatherDataType::Forecast ? state.forecastBackoff : state.weatherBackoff;
+}
+
+void RefreshScheduler::setDeadline(const CityKey& key, WeatherDataType dataType, qint64 deadline)
+{
+    auto it = m_cities.find(key);
+    if (it == m_cities.end()) return;
+
+    qint64& current = deadlineFor(it.value(), dataType);
+    const QPair<CityKey, WeatherDataType> item(key, dataType);
+
+    // Retirer l'ancienne échéance de la file
+    if (current != 0) {
+        auto queued = m_queue.find(current, item);
+        if (queued != m_queue.end()) {
+            m_queue.erase(queued);
+        }
+    }
+
+    current = deadline;
+    if (deadline != 0) {
+        m_queue.insert(deadline, item);
+    }
+}
+
+void RefreshScheduler::rearmTimer()
+{
+    if (m_queue.isEmpty()) {
+        m_timer->stop();
+        return;
+    }
+
+    qint64 delay = m_queue.firstKey() - QDateTime::currentMSecsSinceEpoch();
+    m_timer->start(int(qBound<qint64>(0, delay, std::numeric_limits<int>::max())));
+}
@@ -0,0 +1,102 @@
+#ifndef REFRESHSCHEDULER_H
+#define REFRESHSCHEDULER_H
+
+#include "WeatherData.h"
+#include "citykey.h"
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QMultiMap>
+#include <QDateTime>
+#include <QTimer>
+
+/**
+ * Planificateur de rafraîchissement en arrière-plan
+ *
+ * Fonctionnement :
+ * - Chaque ville surveillée reçoit une échéance un peu avant l'expiration
+ *   de son entrée de cache (avance + gigue aléatoire pour étaler les appels)
+ * - Un seul QTimer est armé sur l'échéance la plus proche
+ * - Une ville non consultée depuis longtemps recule ses échéances
+ *   (backoff exponentiel, compté séparément pour la météo et les
+ *   prévisions) puis n'est plus surveillée
+ *
+ * Le planificateur ne fait aucun appel réseau : il émet refreshDue()
+ * et laisse WeatherService décider selon le budget de requêtes.
+ */
+class RefreshScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit RefreshScheduler(QObject* parent = nullptr);
+
+    // Configuration
+    void setLeadTime(int seconds);          // Avance avant expiration (défaut: 60s)
+    void setJitter(int seconds);            // Fenêtre de gigue (défaut: 45s)
+    void setIdleThreshold(int minutes);     // Inactivité avant backoff (défaut: 60min)
+    void setMaxBackoffLevel(int level);     // Au-delà, la ville n'est plus suivie (défaut: 3)
+
+    // Villes surveillées
+    void watchCity(const CityKey& key);
+    void unwatchCity(const CityKey& key);
+    void markViewed(const CityKey& key);
+    bool isWatched(const CityKey& key) const;
+    QList<CityKey> watchedCities() const;
+    void clear();
+
+    /**
+     * Planifie le prochain rafraîchissement après une mise en cache
+     *
+     * @param key Ville mise en cache
+     * @param dataType Météo actuelle ou prévisions
+     * @param info Informations de cache (date + validité)
+     */
+    void scheduleRefresh(const CityKey& key, WeatherDataType dataType, const CacheInfo& info);
+
+    /**
+     * Reporte un rafraîchissement (budget de requêtes épuisé, erreur réseau)
+     */
+    void postpone(const CityKey& key, WeatherDataType dataType, int seconds);
+
+    int pendingCount() const { return m_queue.size(); }
+    // Échéance programmée (ms depuis epoch), 0 si aucune
+    qint64 nextRefresh(const CityKey& key, WeatherDataType dataType) const;
+
+signals:
+    /**
+     * Émis quand un rafraîchissement doit être lancé
+     *
+     * @param key Ville à rafraîchir
+     * @param dataType Météo actuelle ou prévisions
+     */
+    void refreshDue(const CityKey& key, WeatherDataType dataType);
+
+private slots:
+    void onTimerFired();
+
+private:
+    struct CityState {
+        QDateTime lastViewed;
+        int weatherBackoff = 0;        // Un niveau par cycle de rafraîchissement du type
+        int forecastBackoff = 0;
+        qint64 weatherDeadline = 0;    // ms depuis epoch, 0 = aucune
+        qint64 forecastDeadline = 0;
+    };
+
+    QHash<CityKey, CityState> m_cities;
+    QMultiMap<qint64, QPair<CityKey, WeatherDataType>> m_queue;  // échéance → (ville, type)
+    QTimer* m_timer;
+
+    int m_leadTimeSecs;
+    int m_jitterSecs;
+    int m_idleThresholdMins;
+    int m_maxBackoffLevel;
+
+    qint64& deadlineFor(CityState& state, WeatherDataType dataType) const;
+    int& backoffFor(CityState& state, WeatherDataType dataType) const;
+    void setDeadline(const CityKey& key, WeatherDataType dataType, qint64 deadline);
+    void rearmTimer();
+};
+
+#endif // REFRESHSCHEDULER_H
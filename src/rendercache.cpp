@@ -0,0 +1,60 @@
+#include "rendercache.h"
+
+namespace {
+// Même instance : comparaison des blocs de contrôle, sûre même si l'adresse
+// d'une donnée libérée a été réutilisée
+bool sameData(const std::weak_ptr<const void>& cached, const std::shared_ptr<const void>& data)
+{
+    return !cached.expired() && !cached.owner_before(data) && !data.owner_before(cached);
+}
+
+qsizetype costKiB(const QPixmap& pixmap)
+{
+    const qint64 bytes = qint64(pixmap.width()) * pixmap.height() * qMax(1, pixmap.depth() / 8);
+    return qsizetype(qMax<qint64>(1, bytes / 1024));
+}
+}
+
+RenderCache::RenderCache(qint64 maxBytes)
+    : m_entries(qsizetype(maxBytes / 1024))
+    , m_hits(0)
+    , m_misses(0)
+{
+}
+
+QPixmap RenderCache::find(const CityKey& key, const std::shared_ptr<const void>& data, const QSize& size)
+{
+    Entry* entry = m_entries.object(key);
+    if (!entry || !data || entry->size != size || !sameData(entry->data, data)) {
+        ++m_misses;
+        return QPixmap();
+    }
+    ++m_hits;
+    return entry->pixmap;
+}
+
+void RenderCache::insert(const CityKey& key, const std::shared_ptr<const void>& data, const QPixmap& pixmap)
+{
+    if (!data || pixmap.isNull()) return;
+
+    auto* entry = new Entry;
+    entry->data = data;
+    entry->pixmap = pixmap;
+    entry->size = pixmap.deviceIndependentSize().toSize();
+    m_entries.insert(key, entry, costKiB(pixmap)); // Remplace le rendu précédent de la ville
+}
+
+void RenderCache::invalidate(const CityKey& key)
+{
+    m_entries.remove(key);
+}
+
+void RenderCache::clear()
+{
+    m_entries.clear();
+}
+
+void RenderCache::setMaxBytes(qint64 maxBytes)
+{
+    m_entries.setMaxCost(qsizetype(maxBytes / 1024));
+}
@@ -0,0 +1,50 @@
+#ifndef RENDERCACHE_H
+#define RENDERCACHE_H
+
+#include <QCache>
+#include <QPixmap>
+#include <QSize>
+#include <memory>
+#include "citykey.h"
+
+/**
+ * Rendus déjà calculés (graphique, panneau) par ville
+ *
+ * - Version des données = instance partagée du cache météo : un rendu n'est
+ *   réutilisé que pour exactement les mêmes données (même ForecastPtr...) et
+ *   la même taille d'affichage
+ * - Une nouvelle entrée du cache donne une nouvelle instance : l'ancien rendu
+ *   ne correspond plus et sera remplacé (invalidate() le libère tout de suite)
+ * - Taille bornée en octets, les rendus les moins récemment utilisés partent
+ *   en premier
+ */
+class RenderCache
+{
+public:
+    explicit RenderCache(qint64 maxBytes = 64 * 1024 * 1024);
+
+    // Pixmap nulle si absente, rendue depuis d'autres données ou à une autre taille
+    QPixmap find(const CityKey& key, const std::shared_ptr<const void>& data, const QSize& size);
+    void insert(const CityKey& key, const std::shared_ptr<const void>& data, const QPixmap& pixmap);
+
+    void invalidate(const CityKey& key);
+    void clear();
+
+    void setMaxBytes(qint64 maxBytes);
+    int count() const { return int(m_entries.count()); }
+    qint64 hits() const { return m_hits; }
+    qint64 misses() const { return m_misses; }
+
+private:
+    struct Entry {
+        std::weak_ptr<const void> data;  // Ne prolonge pas la vie des données
+        QPixmap pixmap;
+        QSize size;                      // Taille logique (hors facteur d'échelle de l'écran)
+    };
+
+    QCache<CityKey, Entry> m_entries;    // Coût en Kio
+    qint64 m_hits;
+    qint64 m_misses;
+};
+
+#endif // RENDERCACHE_H
@@ -0,0 +1,516 @@
+#include "SearchHistory.h"
+#include "citytrie.h"
+#include "historyjournal.h"
+#include <QThread>
+#include <QFileInfo>
+#include <QDebug>
+#include <algorithm>
+
+SearchHistory::SearchHistory(QObject* parent)
+    : QObject(parent)
+    , m_maxHistorySize(100)
+    , m_saveTimer(nullptr)
+    , m_trie(new CityTrie())
+    , m_logRecordCount(0)
+    , m_compactionPending(false)
+    , m_journalThread(nullptr)
+    , m_journal(nullptr)
+{
+    m_historyFilePath = getHistoryFilePath();
+    QFileInfo legacy(m_historyFilePath);
+    QString basePath = legacy.absolutePath() + "/" + legacy.completeBaseName();
+    m_snapshotPath = basePath + ".snapshot";
+    m_logPath = basePath + ".log";
+
+    // Sauvegarde différée : plusieurs modifications rapprochées = une écriture
+    m_saveTimer = new QTimer(this);
+    m_saveTimer->setSingleShot(true);
+    m_saveTimer->setInterval(2000);
+    connect(m_saveTimer, &QTimer::timeout, this, &SearchHistory::saveToFile);
+
+    const quint64 generation = loadFromFile();
+
+    // Les écritures disque ne passent jamais par le thread de l'interface
+    m_journal = new HistoryJournal(m_snapshotPath, m_logPath, generation);
+    m_journalThread = new QThread(this);
+    m_journal->moveToThread(m_journalThread);
+    m_journalThread->start();
+
+    if (m_compactionPending) {
+        m_saveTimer->start();
+    }
+    qDebug() << "SearchHistory initialized with" << m_entries.size() << "entries";
+}
+
+SearchHistory::~SearchHistory()
+{
+    m_saveTimer->stop();
+    flushJournal(true);
+
+    m_journalThread->quit();
+    m_journalThread->wait();
+    delete m_journal;
+    delete m_trie;
+}
+
+// =====================================================
+// GESTION DES RECHERCHES
+// =====================================================
+
+void SearchHistory::addSearch(const QString& cityName)
+{
+    if (normalizeCityName(cityName).isEmpty()) return;
+
+    HistoryMutation mutation;
+    mutation.type = HistoryMutation::Search;
+    mutation.cityName = cityName.trimmed();
+    mutation.time = QDateTime::currentDateTime();
+
+    applyMutation(mutation);
+    recordMutation(mutation);
+    auto it = m_entries.constFind(normalizeCityName(cityName));
+    if (it != m_entries.cend()) {
+        emit searchRecorded(it->cityName);
+    }
+    emit historyChanged();
+}
+
+void SearchHistory::removeSearch(const QString& cityName)
+{
+    auto it = m_entries.constFind(normalizeCityName(cityName));
+    if (it == m_entries.cend()) return;
+    const QString storedName = it->cityName;
+
+    HistoryMutation mutation;
+    mutation.type = HistoryMutation::Remove;
+    mutation.cityName = cityName.trimmed();
+    mutation.time = QDateTime::currentDateTime();
+
+    applyMutation(mutation);
+    recordMutation(mutation);
+    emit searchRemoved(storedName);
+    emit historyChanged();
+}
+
+void SearchHistory::clearHistory()
+{
+    HistoryMutation mutation;
+    mutation.type = HistoryMutation::Clear;
+    mutation.time = QDateTime::currentDateTime();
+
+    applyMutation(mutation);
+    recordMutation(mutation);
+    emit historyCleared();
+    emit historyChanged();
+}
+
+// =====================================================
+// ACCÈS AUX DONNÉES
+// =====================================================
+
+QStringList SearchHistory::getRecentSearches(int maxCount) const
+{
+    QList<SearchHistoryEntry> entries = m_entries.values();
+    std::sort(entries.begin(), entries.end(),
+              [](const SearchHistoryEntry& a, const SearchHistoryEntry& b) {
+                  return a.lastAccess > b.lastAccess;
+              });
+
+    QStringList result;
+    for (int i = 0; i < qMin(maxCount, entries.size()); ++i) {
+        result.append(entries[i].cityName);
+    }
+    return result;
+}
+
+QStringList SearchHistory::getFrequentSearches(int maxCount) const
+{
+    QList<SearchHistoryEntry> entries = m_entries.values();
+    std::sort(entries.begin(), entries.end(),
+              [](const SearchHistoryEntry& a, const SearchHistoryEntry& b) {
+                  if (a.searchCount != b.searchCount) return a.searchCount > b.searchCount;
+                  return a.lastAccess > b.lastAccess;
+              });
+
+    QStringList result;
+    for (int i = 0; i < qMin(maxCount, entries.size()); ++i) {
+        result.append(entries[i].cityName);
+    }
+    return result;
+}
+
+QStringList SearchHistory::getFavorites() const
+{
+    QStringList result;
+    for (const SearchHistoryEntry& entry : m_entries) {
+        if (entry.isFavorite) {
+            result.append(entry.cityName);
+        }
+    }
+    return result;
+}
+
+QStringList SearchHistory::getSuggestions(const QString& prefix, int maxCount) const
+{
+    // Chaque nœud du trie garde ses meilleurs résultats : pas de parcours
+    QString normalizedPrefix = normalizeCityName(prefix);
+    if (normalizedPrefix.isEmpty()) return QStringList();
+
+    return m_trie->suggestions(normalizedPrefix, maxCount);
+}
+
+void SearchHistory::addSuggestionName(const QString& cityName, qint64 weight)
+{
+    m_trie->addDictionaryName(normalizeCityName(cityName), cityName.trimmed(), weight);
+}
+
+QStringList SearchHistory::getSearchesForHour(int hour, int maxCount) const
+{
+    if (hour < 0 || hour > 23) return QStringList();
+
+    QList<QPair<int, QString>> ranked;
+    for (const SearchHistoryEntry& entry : m_entries) {
+        int count = entry.searchesAtHour(hour);
+        if (count > 0) {
+            ranked.append({count, entry.cityName});
+        }
+    }
+    std::sort(ranked.begin(), ranked.end(),
+              [](const QPair<int, QString>& a, const QPair<int, QString>& b) {
+                  return a.first > b.first;
+              });
+
+    QStringList result;
+    for (int i = 0; i < qMin(maxCount, ranked.size()); ++i) {
+        result.append(ranked[i].second);
+    }
+    return result;
+}
+
+// =====================================================
+// GESTION DES FAVORIS
+// =====================================================
+
+void SearchHistory::addToFavorites(const QString& cityName)
+{
+    QString key = normalizeCityName(cityName);
+    if (key.isEmpty() || isFavorite(cityName)) return;
+
+    HistoryMutation mutation;
+    mutation.type = HistoryMutation::Favorite;
+    mutation.cityName = cityName.trimmed();
+    mutation.time = QDateTime::currentDateTime();
+    mutation.favorite = true;
+
+    applyMutation(mutation);
+    recordMutation(mutation);
+    emit favoriteChanged(m_entries.value(key).cityName, true);
+    emit historyChanged();
+}
+
+void SearchHistory::removeFromFavorites(const QString& cityName)
+{
+    if (!isFavorite(cityName)) return;
+
+    HistoryMutation mutation;
+    mutation.type = HistoryMutation::Favorite;
+    mutation.cityName = cityName.trimmed();
+    mutation.time = QDateTime::currentDateTime();
+    mutation.favorite = false;
+
+    applyMutation(mutation);
+    recordMutation(mutation);
+    emit favoriteChanged(m_entries.value(normalizeCityName(cityName)).cityName, false);
+    emit historyChanged();
+}
+
+bool SearchHistory::isFavorite(const QString& cityName) const
+{
+    auto it = m_entries.constFind(normalizeCityName(cityName));
+    return it != m_entries.cend() && it->isFavorite;
+}
+
+void SearchHistory::toggleFavorite(const QString& cityName)
+{
+    if (isFavorite(cityName)) {
+        removeFromFavorites(cityName);
+    } else {
+        addToFavorites(cityName);
+    }
+}
+
+// =====================================================
+// STATISTIQUES
+// =====================================================
+
+int SearchHistory::getTotalSearches() const
+{
+    int total = 0;
+    for (const SearchHistoryEntry& entry : m_entries) {
+        total += entry.searchCount;
+    }
+    return total;
+}
+
+int SearchHistory::getSearchCount(const QString& cityName) const
+{
+    auto it = m_entries.constFind(normalizeCityName(cityName));
+    return it != m_entries.cend() ? it->searchCount : 0;
+}
+
+QDateTime SearchHistory::getLastSearchTime(const QString& cityName) const
+{
+    auto it = m_entries.constFind(normalizeCityName(cityName));
+    return it != m_entries.cend() ? it->lastAccess : QDateTime();
+}
+
+SearchHistoryEntry SearchHistory::getEntry(const QString& cityName) const
+{
+    auto it = m_entries.constFind(normalizeCityName(cityName));
+    if (it == m_entries.cend()) {
+        SearchHistoryEntry empty;
+        empty.searchCount = 0;
+        return empty;
+    }
+    return it.value();
+}
+
+void SearchHistory::setMaxHistorySize(int maxSize)
+{
+    m_maxHistorySize = qMax(1, maxSize);
+
+    // Suppressions hors journal : le prochain enregistrement réécrit le snapshot
+    int before = m_entries.size();
+    cleanupOldEntries();
+    if (m_entries.size() != before) {
+        m_compactionPending = true;
+        m_saveTimer->start();
+    }
+}
+
+// =====================================================
+// PERSISTANCE
+// =====================================================
+
+void SearchHistory::saveToFile()
+{
+    flushJournal(false);
+}
+
+void SearchHistory::flushJournal(bool blocking)
+{
+    if (!m_journal) return;
+
+    // Compactage quand le journal dépasse largement l'état qu'il décrit
+    int threshold = qMax(1000, 4 * int(m_entries.size()));
+    bool compact = m_compactionPending || m_logRecordCount + m_pendingMutations.size() > threshold;
+    if (m_pendingMutations.isEmpty() && !compact) return;
+
+    HistoryJournal* journal = m_journal;
+    QList<HistoryMutation> batch;
+    batch.swap(m_pendingMutations);
+    QList<SearchHistoryEntry> snapshot;
+    if (compact) {
+        snapshot = m_entries.values();
+        m_logRecordCount = 0;
+        m_compactionPending = false;
+    } else {
+        m_logRecordCount += batch.size();
+    }
+
+    auto write = [journal, batch, snapshot, compact]() {
+        // Le snapshot inclut déjà le lot ; s'il n'a pas pu être écrit, le lot va au journal
+        if (!compact || !journal->compact(snapshot)) {
+            journal->append(batch);
+        }
+    };
+    QMetaObject::invokeMethod(journal, write,
+                              blocking ? Qt::BlockingQueuedConnection : Qt::QueuedConnection);
+}
+
+quint64 SearchHistory::loadFromFile()
+{
+    QList<SearchHistoryEntry> entries;
+    quint64 generation = 0;
+    if (HistoryJournal::readSnapshot(m_snapshotPath, entries, &generation)) {
+        for (const SearchHistoryEntry& entry : entries) {
+            QString key = normalizeCityName(entry.cityName);
+            if (!key.isEmpty()) {
+                m_entries.insert(key, entry);
+                m_trie->upsert(key, entry);
+            }
+        }
+    } else if (loadLegacyFile()) {
+        // Migration : le prochain enregistrement écrit un snapshot binaire
+        m_compactionPending = true;
+    }
+
+    // Queue illisible, en-tête invalide ou génération périmée : coupés avant le premier ajout
+    qint64 validSize = 0;
+    const QList<HistoryMutation> mutations = HistoryJournal::readLog(m_logPath, generation, &validSize);
+    for (const HistoryMutation& mutation : mutations) {
+        applyMutation(mutation);
+    }
+    m_logRecordCount = mutations.size();
+    if (!HistoryJournal::truncateLog(m_logPath, validSize)) {
+        // Journal inutilisable : le prochain enregistrement réécrit snapshot et journal
+        m_compactionPending = true;
+    }
+    return generation;
+}
+
+bool SearchHistory::loadLegacyFile()
+{
+    QFile file(m_historyFilePath);
+    if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isObject()) {
+        qWarning() << "SearchHistory: invalid history file" << m_historyFilePath;
+        return false;
+    }
+
+    const QJsonArray entriesJson = doc.object()["entries"].toArray();
+    for (const QJsonValue& value : entriesJson) {
+        SearchHistoryEntry entry = deserializeEntry(value.toObject());
+        QString key = normalizeCityName(entry.cityName);
+        if (!key.isEmpty()) {
+            m_entries.insert(key, entry);
+            m_trie->upsert(key, entry);
+        }
+    }
+    return true;
+}
+
+QString SearchHistory::getHistoryFilePath() const
+{
+    QString dataDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dataDir);
+    return dataDir + "/search_history.json";
+}
+
+SearchHistoryEntry SearchHistory::deserializeEntry(const QJsonObject& json) const
+{
+    SearchHistoryEntry entry(json["city"].toString());
+    entry.searchTime = QDateTime::fromString(json["searchTime"].toString(), Qt::ISODate);
+    entry.searchCount = qMax(1, json["count"].toInt());
+    entry.lastAccess = QDateTime::fromString(json["lastAccess"].toString(), Qt::ISODate);
+    entry.isFavorite = json["favorite"].toBool();
+
+    const QJsonArray hours = json["hours"].toArray();
+    if (hours.size() == 24) {
+        entry.hourlyCounts = QList<int>(24, 0);
+        for (int h = 0; h < 24; ++h) {
+            entry.hourlyCounts[h] = hours[h].toInt();
+        }
+    }
+    return entry;
+}
+
+// =====================================================
+// MODIFICATIONS
+// =====================================================
+
+void SearchHistory::applyMutation(const HistoryMutation& mutation)
+{
+    // Chemin commun aux opérations en direct et à la relecture du journal
+    QString key = normalizeCityName(mutation.cityName);
+
+    switch (mutation.type) {
+    case HistoryMutation::Search: {
+        if (key.isEmpty()) return;
+        auto it = m_entries.find(key);
+        if (it != m_entries.end()) {
+            it->searchCount++;
+            it->lastAccess = mutation.time;
+            it->recordHour(mutation.time);
+            m_trie->upsert(key, it.value());
+        } else {
+            SearchHistoryEntry entry(mutation.cityName);
+            entry.searchTime = mutation.time;
+            entry.lastAccess = mutation.time;
+            entry.recordHour(mutation.time);
+            m_entries.insert(key, entry);
+            m_trie->upsert(key, entry);
+            cleanupOldEntries(key);
+        }
+        break;
+    }
+    case HistoryMutation::Remove:
+        if (m_entries.remove(key) > 0) {
+            m_trie->remove(key);
+        }
+        break;
+    case HistoryMutation::Clear:
+        m_entries.clear();
+        m_trie->clearHistory();
+        break;
+    case HistoryMutation::Favorite: {
+        if (key.isEmpty()) return;
+        auto it = m_entries.find(key);
+        if (it == m_entries.end()) {
+            if (!mutation.favorite) return;
+            SearchHistoryEntry entry(mutation.cityName);
+            entry.searchTime = mutation.time;
+            entry.lastAccess = mutation.time;
+            it = m_entries.insert(key, entry);
+        }
+        it->isFavorite = mutation.favorite;
+        m_trie->upsert(key, it.value());
+        break;
+    }
+    default:
+        qWarning() << "SearchHistory: unknown journal record" << int(mutation.type);
+        break;
+    }
+}
+
+void SearchHistory::recordMutation(const HistoryMutation& mutation)
+{
+    m_pendingMutations.append(mutation);
+    m_saveTimer->start();
+}
+
+// =====================================================
+// UTILITAIRES
+// =====================================================
+
+void SearchHistory::cleanupOldEntries(const QString& keptKey)
+{
+    if (m_entries.size() <= m_maxHistorySize) return;
+
+    // Les favoris ne sont jamais supprimés, puis on retire les moins bien classés.
+    // Une nouvelle ville (1 recherche) serait la moins bien classée : elle est épargnée
+    QList<QPair<QString, SearchHistoryEntry>> candidates;
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it) {
+        if (!it->isFavorite && it.key() != keptKey) {
+            candidates.append({it.key(), it.value()});
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const QPair<QString, SearchHistoryEntry>& a, const QPair<QString, SearchHistoryEntry>& b) {
+                  return b.second < a.second; // moins bien classé en premier
+              });
+
+    for (int i = 0; i < candidates.size() && m_entries.size() > m_maxHistorySize; ++i) {
+        m_entries.remove(candidates[i].first);
+        m_trie->remove(candidates[i].first);
+        emit searchRemoved(candidates[i].second.cityName);
+    }
+}
+
+QString SearchHistory::normalizeCityName(const QString& cityName) const
+{
+    // "  Saint-Étienne " → "saint-etienne" (casse et accents ignorés)
+    QString decomposed = cityName.simplified().normalized(QString::NormalizationForm_D);
+    QString folded;
+    folded.reserve(decomposed.size());
+    for (const QChar& c : decomposed) {
+        if (c.category() != QChar::Mark_NonSpacing) {
+            folded.append(c);
+        }
+    }
+    return folded.toCaseFolded();
+}
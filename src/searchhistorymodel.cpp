@@ -0,0 +1,188 @@
+#include "searchhistorymodel.h"
+#include "SearchHistory.h"
+#include <algorithm>
+#include <limits>
+
+namespace {
+// Ordre des favoris (identique au chargement et aux insertions)
+bool favoriteLessThan(const QString& a, const QString& b)
+{
+    return QString::compare(a, b, Qt::CaseInsensitive) < 0;
+}
+}
+
+SearchHistoryModel::SearchHistoryModel(SearchHistory* history, Mode mode, QObject* parent)
+    : QAbstractListModel(parent)
+    , m_history(history)
+    , m_mode(mode)
+{
+    connect(m_history, &SearchHistory::searchRecorded, this, &SearchHistoryModel::onSearchRecorded);
+    connect(m_history, &SearchHistory::searchRemoved, this, &SearchHistoryModel::onSearchRemoved);
+    connect(m_history, &SearchHistory::favoriteChanged, this, &SearchHistoryModel::onFavoriteChanged);
+    connect(m_history, &SearchHistory::historyCleared, this, &SearchHistoryModel::reload);
+
+    reload();
+}
+
+// =====================================================
+// QAbstractListModel
+// =====================================================
+
+int SearchHistoryModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : int(m_cities.size());
+}
+
+QVariant SearchHistoryModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_cities.size()) {
+        return QVariant();
+    }
+    const QString& cityName = m_cities.at(index.row());
+
+    switch (role) {
+    case Qt::DisplayRole:
+    case CityNameRole:
+        return cityName;
+    case Qt::ToolTipRole: {
+        const SearchHistoryEntry entry = m_history->getEntry(cityName);
+        return QString("%1 recherche(s), dernière le %2")
+            .arg(entry.searchCount)
+            .arg(entry.lastAccess.toString("dd/MM/yyyy hh:mm"));
+    }
+    case SearchCountRole:
+        return m_history->getSearchCount(cityName);
+    case LastAccessRole:
+        return m_history->getLastSearchTime(cityName);
+    case FavoriteRole:
+        return m_history->isFavorite(cityName);
+    default:
+        return QVariant();
+    }
+}
+
+QHash<int, QByteArray> SearchHistoryModel::roleNames() const
+{
+    QHash<int, QByteArray> roles = QAbstractListModel::roleNames();
+    roles.insert(CityNameRole, "cityName");
+    roles.insert(SearchCountRole, "searchCount");
+    roles.insert(LastAccessRole, "lastAccess");
+    roles.insert(FavoriteRole, "favorite");
+    return roles;
+}
+
+QString SearchHistoryModel::cityAt(int row) const
+{
+    return row >= 0 && row < m_cities.size() ? m_cities.at(row) : QString();
+}
+
+int SearchHistoryModel::rowOf(const QString& cityName) const
+{
+    if (m_mode == Mode::Favorites) {
+        // Liste triée : recherche binaire
+        auto it = std::lower_bound(m_cities.cbegin(), m_cities.cend(), cityName, favoriteLessThan);
+        if (it != m_cities.cend() && *it == cityName) {
+            return int(it - m_cities.cbegin());
+        }
+        return -1;
+    }
+    // Récents : les villes revisitées sont presque toujours vers le haut
+    return int(m_cities.indexOf(cityName));
+}
+
+// =====================================================
+// MODIFICATIONS DE L'HISTORIQUE
+// =====================================================
+
+void SearchHistoryModel::onSearchRecorded(const QString& cityName)
+{
+    const int row = rowOf(cityName);
+
+    if (m_mode == Mode::Favorites) {
+        // Seul le compteur change pour un favori
+        if (row >= 0) {
+            emit dataChanged(index(row), index(row), {SearchCountRole, LastAccessRole, Qt::ToolTipRole});
+        }
+        return;
+    }
+
+    if (row < 0) {
+        insertCity(0, cityName);
+    } else {
+        moveToTop(row);
+        emit dataChanged(index(0), index(0), {SearchCountRole, LastAccessRole, Qt::ToolTipRole});
+    }
+}
+
+void SearchHistoryModel::onSearchRemoved(const QString& cityName)
+{
+    const int row = rowOf(cityName);
+    if (row >= 0) {
+        removeCityAt(row);
+    }
+}
+
+void SearchHistoryModel::onFavoriteChanged(const QString& cityName, bool isFavorite)
+{
+    const int row = rowOf(cityName);
+
+    if (m_mode == Mode::Recent) {
+        if (row >= 0) {
+            emit dataChanged(index(row), index(row), {FavoriteRole});
+        } else if (isFavorite) {
+            insertCity(0, cityName); // Favori ajouté hors historique : nouvelle entrée
+        }
+        return;
+    }
+
+    if (isFavorite && row < 0) {
+        insertCity(favoriteInsertPosition(cityName), cityName);
+    } else if (!isFavorite && row >= 0) {
+        removeCityAt(row);
+    }
+}
+
+void SearchHistoryModel::reload()
+{
+    beginResetModel();
+    if (m_mode == Mode::Favorites) {
+        m_cities = m_history->getFavorites();
+        std::sort(m_cities.begin(), m_cities.end(), favoriteLessThan);
+    } else {
+        m_cities = m_history->getRecentSearches(std::numeric_limits<int>::max());
+    }
+    endResetModel();
+}
+
+// =====================================================
+// UTILITAIRES
+// =====================================================
+
+void SearchHistoryModel::insertCity(int row, const QString& cityName)
+{
+    beginInsertRows(QModelIndex(), row, row);
+    m_cities.insert(row, cityName);
+    endInsertRows();
+}
+
+void SearchHistoryModel::removeCityAt(int row)
+{
+    beginRemoveRows(QModelIndex(), row, row);
+    m_cities.removeAt(row);
+    endRemoveRows();
+}
+
+void SearchHistoryModel::moveToTop(int row)
+{
+    if (row <= 0) return;
+
+    beginMoveRows(QModelIndex(), row, row, QModelIndex(), 0);
+    m_cities.move(row, 0);
+    endMoveRows();
+}
+
+int SearchHistoryModel::favoriteInsertPosition(const QString& cityName) const
+{
+    auto it = std::lower_bound(m_cities.cbegin(), m_cities.cend(), cityName, favoriteLessThan);
+    return int(it - m_cities.cbegin());
+}
@@ -0,0 +1,64 @@
+#ifndef SEARCHHISTORYMODEL_H
+#define SEARCHHISTORYMODEL_H
+
+#include <QAbstractListModel>
+#include <QStringList>
+
+class SearchHistory;
+
+/**
+ * Vue liste de l'historique (récents ou favoris) pour QListView
+ *
+ * - Le modèle ne garde que l'ordre des noms ; compteurs, dates et favoris
+ *   sont lus dans SearchHistory au moment de l'affichage (lignes visibles
+ *   seulement, la vue étant virtualisée)
+ * - Chaque modification de l'historique touche uniquement les lignes
+ *   concernées : insertion, suppression, déplacement en tête, dataChanged
+ * - Récents : dernière recherche en tête ; favoris : ordre alphabétique
+ */
+class SearchHistoryModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum class Mode {
+        Recent,
+        Favorites
+    };
+
+    enum Roles {
+        CityNameRole = Qt::UserRole + 1,
+        SearchCountRole,
+        LastAccessRole,
+        FavoriteRole
+    };
+
+    SearchHistoryModel(SearchHistory* history, Mode mode, QObject* parent = nullptr);
+
+    // QAbstractListModel
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QHash<int, QByteArray> roleNames() const override;
+
+    Mode mode() const { return m_mode; }
+    QString cityAt(int row) const;
+    int rowOf(const QString& cityName) const;
+
+private slots:
+    void onSearchRecorded(const QString& cityName);
+    void onSearchRemoved(const QString& cityName);
+    void onFavoriteChanged(const QString& cityName, bool isFavorite);
+    void reload();
+
+private:
+    SearchHistory* m_history;
+    Mode m_mode;
+    QStringList m_cities;   // Noms enregistrés, dans l'ordre d'affichage
+
+    void insertCity(int row, const QString& cityName);
+    void removeCityAt(int row);
+    void moveToTop(int row);
+    int favoriteInsertPosition(const QString& cityName) const;
+};
+
+#endif // SEARCHHISTORYMODEL_H
@@ -1,20 +1,73 @@
-#include "SimpleMapWidget.h"
+#include "simplemapwidget.h"
+#include "mapcanvas.h"
+#include "ICacheManager.h"
 #include <QDebug>
+#include <QHBoxLayout>
+#include <QSet>
+#include <QSignalBlocker>
+#include <QtConcurrent>
 
-SimpleMapWidget::SimpleMapWidget(QWidget* parent)
+namespace {
+// Palettes des calques (stops de 0 à 1 sur la plage de valeurs)
+const QGradientStops TEMPERATURE_STOPS = {
+    {0.0, QColor(0x19, 0x76, 0xD2)}, {0.4, QColor(0x4F, 0xC3, 0xF7)}, {0.55, QColor(0xFF, 0xF1, 0x76)},
+    {0.75, QColor(0xFB, 0x8C, 0x00)}, {1.0, QColor(0xD3, 0x2F, 0x2F)}};
+constexpr double TEMPERATURE_MIN = -15.0;
+constexpr double TEMPERATURE_MAX = 40.0;
+
+const QGradientStops PRECIPITATION_STOPS = {
+    {0.0, QColor(0xE3, 0xF2, 0xFD)}, {0.5, QColor(0x42, 0xA5, 0xF5)}, {1.0, QColor(0x0D, 0x47, 0xA1)}};
+constexpr double PRECIPITATION_MIN = 0.0;
+constexpr double PRECIPITATION_MAX = 100.0;
+}
+
+SimpleMapWidget::SimpleMapWidget(QWidget* parent, const QString& tileCacheDir)
     : QWidget(parent)
     , m_layout(nullptr)
     , m_titleLabel(nullptr)
     , m_locationLabel(nullptr)
     , m_coordsLabel(nullptr)
     , m_infoLabel(nullptr)
+    , m_layerCombo(nullptr)
+    , m_canvas(nullptr)
+    , m_tileCache(tileCacheDir)
+    , m_cache(nullptr)
+    , m_markerTimer(new QTimer(this))
+    , m_heatmapLayer(HeatmapLayer::None)
+    , m_cancelPregeneration(false)
     , m_latitude(0.0)
     , m_longitude(0.0)
 {
+    if (!m_tileCache.loadCoastlines()) {
+        qWarning() << "SimpleMapWidget: coastlines unavailable, ocean-only map";
+    }
+
     setupUI();
+
+    m_markerTimer->setSingleShot(true);
+    m_markerTimer->setInterval(MARKER_REFRESH_MS);
+    connect(m_markerTimer, &QTimer::timeout, this, &SimpleMapWidget::reloadMarkers);
+    connect(m_markerTimer, &QTimer::timeout, this, &SimpleMapWidget::updateHeatmap);
+
+    // Niveaux de vue d'ensemble générés une fois sur disque, hors du thread de l'interface :
+    // la carte affichée entre-temps rend elle-même les tuiles qui lui manquent
+    m_pregeneration = QtConcurrent::run([this]() {
+        const int generated = m_tileCache.pregenerate(PREGENERATED_ZOOM, &m_cancelPregeneration);
+        if (generated > 0) {
+            qDebug() << "SimpleMapWidget:" << generated << "map tiles generated in" << m_tileCache.cacheDir();
+        }
+        return generated;
+    });
     qDebug() << "SimpleMapWidget initialized";
 }
 
+SimpleMapWidget::~SimpleMapWidget()
+{
+    // Tuile en cours terminée, les suivantes abandonnées (reprises au prochain démarrage)
+    m_cancelPregeneration = true;
+    m_pregeneration.waitForFinished();
+}
+
 void SimpleMapWidget::setupUI()
 {
     // Layout principal
@@ -25,6 +78,15 @@ void SimpleMapWidget::setupUI()
     m_titleLabel->setStyleSheet("font-weight: bold; font-size: 14px;");
     m_titleLabel->setAlignment(Qt::AlignCenter);
 
+    // Choix du calque de carte de chaleur
+    m_layerCombo = new QComboBox(this);
+    m_layerCombo->addItem("Sans calque", int(HeatmapLayer::None));
+    m_layerCombo->addItem("Températures", int(HeatmapLayer::Temperature));
+    m_layerCombo->addItem("Probabilité de pluie", int(HeatmapLayer::Precipitation));
+    connect(m_layerCombo, &QComboBox::currentIndexChanged, this, [this](int index) {
+        setHeatmapLayer(HeatmapLayer(m_layerCombo->itemData(index).toInt()));
+    });
+
     // Ville et pays
     m_locationLabel = new QLabel("Aucune ville sélectionnée", this);
     m_locationLabel->setAlignment(Qt::AlignCenter);
@@ -38,13 +100,23 @@ void SimpleMapWidget::setupUI()
     // Information additionnelle
     m_infoLabel = new QLabel("Position sera affichée ici", this);
     m_infoLabel->setAlignment(Qt::AlignCenter);
-    m_infoLabel->setStyleSheet("font-size: 10px; color: #888; margin-top: 10px;");
+    m_infoLabel->setStyleSheet("font-size: 10px; color: #888;");
+
+    // Carte (prend toute la hauteur disponible)
+    m_canvas = new MapCanvas(&m_tileCache, this);
+    m_canvas->centerOn(20.0, 0.0);
+    connect(m_canvas, &MapCanvas::markerClicked, this, &SimpleMapWidget::cityClicked);
+    // Marqueurs limités à la vue : relus dans l'index spatial à chaque déplacement
+    connect(m_canvas, &MapCanvas::viewportChanged, this, &SimpleMapWidget::reloadMarkers);
 
     // Ajouter au layout
-    m_layout->addWidget(m_titleLabel);
+    QHBoxLayout* headerLayout = new QHBoxLayout();
+    headerLayout->addWidget(m_titleLabel, 1);
+    headerLayout->addWidget(m_layerCombo);
+    m_layout->addLayout(headerLayout);
+    m_layout->addWidget(m_canvas, 1);
     m_layout->addWidget(m_locationLabel);
     m_layout->addWidget(m_coordsLabel);
-    m_layout->addStretch(); // Espace flexible
     m_layout->addWidget(m_infoLabel);
 
     // Style du widget
@@ -53,22 +125,24 @@ void SimpleMapWidget::setupUI()
     setStyleSheet("SimpleMapWidget { border: 1px solid gray; background: #F0F8FF; border-radius: 5px; }");
 }
 
-void SimpleMapWidget::onWeatherDataReceived(const QString& cityName, const CurrentWeatherData& data)
+void SimpleMapWidget::onWeatherDataReceived(const QString& cityName, CurrentWeatherPtr data)
 {
     Q_UNUSED(cityName)
 
-    if (!data.isValid()) {
+    if (!data || !data->isValid()) {
         qWarning() << "Invalid weather data received in SimpleMapWidget";
         return;
     }
 
     // Stocker les données
-    m_currentCity = data.cityName;
-    m_latitude = data.latitude;
-    m_longitude = data.longitude;
+    m_currentCity = data->cityName;
+    m_latitude = data->latitude;
+    m_longitude = data->longitude;
 
     // Mettre à jour l'affichage
     updateLocationDisplay();
+    m_canvas->setHighlightedCity(m_currentCity);
+    m_canvas->centerOn(m_latitude, m_longitude);
 
     qDebug() << "SimpleMapWidget updated for" << m_currentCity
              << "at" << m_latitude << "," << m_longitude;
@@ -83,6 +157,8 @@ void SimpleMapWidget::showLocation(const QString& cityName, const QString& count
 
     m_locationLabel->setText(QString("%1, %2").arg(cityName).arg(country));
     m_coordsLabel->setText(formatCoordinates(latitude, longitude));
+    m_canvas->setHighlightedCity(cityName);
+    m_canvas->centerOn(latitude, longitude);
 
     // Information contextuelle
     m_infoLabel->setText("Position géographique");
@@ -97,6 +173,125 @@ void SimpleMapWidget::clearLocation()
     m_locationLabel->setText("Aucune ville sélectionnée");
     m_coordsLabel->setText("Coordonnées: -");
     m_infoLabel->setText("Position sera affichée ici");
+    m_canvas->setHighlightedCity(QString());
+}
+
+// =====================================================
+// MARQUEURS DES VILLES EN CACHE
+// =====================================================
+
+void SimpleMapWidget::setCacheManager(const ICacheManager* cache)
+{
+    m_cache = cache;
+    refreshMarkers();
+}
+
+void SimpleMapWidget::onCacheUpdated(const QString& cityName, const QString& dataType)
+{
+    Q_UNUSED(cityName)
+    // La météo actuelle porte les coordonnées et la température ; les prévisions, la pluie
+    if (dataType == "weather" || m_heatmapLayer == HeatmapLayer::Precipitation) {
+        refreshMarkers();
+    }
+}
+
+void SimpleMapWidget::refreshMarkers()
+{
+    if (!m_markerTimer->isActive()) {
+        m_markerTimer->start();
+    }
+}
+
+void SimpleMapWidget::reloadMarkers()
+{
+    if (!m_cache) return;
+
+    // Villes de la vue (plus une marge pour les étiquettes en bord), via l'index du cache
+    const QRectF visible = m_canvas->visibleBounds();
+    const double marginX = visible.width() * VIEW_MARGIN_RATIO;
+    const double marginY = visible.height() * VIEW_MARGIN_RATIO;
+    const QList<CityKey> keys = m_cache->citiesInArea(visible.adjusted(-marginX, -marginY, marginX, marginY));
+
+    QList<MapMarker> markers;
+    markers.reserve(keys.size());
+    for (const CityKey& key : keys) {
+        // Poignée partagée, même expirée : la position ne change pas
+        const CurrentWeatherPtr weather = m_cache->peekWeather(key);
+        if (!weather) continue;
+
+        MapMarker marker;
+        marker.name = weather->cityName.isEmpty() ? key.toString() : weather->cityName;
+        marker.label = QString("%1 %2°C").arg(marker.name).arg(weather->temperature, 0, 'f', 0);
+        marker.latitude = weather->latitude;
+        marker.longitude = weather->longitude;
+        marker.temperature = weather->temperature;
+        marker.hasTemperature = true;
+        markers.append(marker);
+    }
+    m_canvas->setMarkers(markers);
+
+    if (m_currentCity.isEmpty()) {
+        m_infoLabel->setText(QString("%1 ville(s) en cache dans la vue").arg(markers.size()));
+    }
+}
+
+// =====================================================
+// CARTE DE CHALEUR
+// =====================================================
+
+void SimpleMapWidget::setHeatmapLayer(HeatmapLayer layer)
+{
+    if (layer == m_heatmapLayer) return;
+    m_heatmapLayer = layer;
+
+    const QSignalBlocker blocker(m_layerCombo);
+    m_layerCombo->setCurrentIndex(m_layerCombo->findData(int(layer)));
+
+    // Autre grandeur : toutes les cases sont à recalculer
+    m_heatmap.clear();
+    if (layer == HeatmapLayer::Temperature) {
+        m_heatmap.setPalette(TEMPERATURE_STOPS, TEMPERATURE_MIN, TEMPERATURE_MAX);
+    } else if (layer == HeatmapLayer::Precipitation) {
+        m_heatmap.setPalette(PRECIPITATION_STOPS, PRECIPITATION_MIN, PRECIPITATION_MAX);
+    }
+    updateHeatmap();
+}
+
+void SimpleMapWidget::updateHeatmap()
+{
+    if (m_heatmapLayer == HeatmapLayer::None || !m_cache) {
+        m_canvas->setOverlay(QImage());
+        return;
+    }
+
+    // Échantillons alignés sur le cache : une ville inchangée ne marque aucune case
+    const QList<CityKey> keys = m_cache->cachedKeys();
+    QSet<CityKey> sampled;
+    sampled.reserve(keys.size());
+    for (const CityKey& key : keys) {
+        const CurrentWeatherPtr weather = m_cache->peekWeather(key);
+        if (!weather) continue;
+
+        double value = weather->temperature;
+        if (m_heatmapLayer == HeatmapLayer::Precipitation) {
+            const ForecastPtr forecast = m_cache->tryGetForecast(key);
+            if (!forecast || forecast->entries.isEmpty()) continue;
+            value = forecast->entries.first().precipitationProbability;
+        }
+        m_heatmap.setSample(key, weather->latitude, weather->longitude, value);
+        sampled.insert(key);
+    }
+    const QList<CityKey> previous = m_heatmap.sampleKeys();
+    for (const CityKey& key : previous) {
+        if (!sampled.contains(key)) {
+            m_heatmap.removeSample(key);
+        }
+    }
+
+    // Recalcul limité aux cases marquées ; l'image n'est republiée que si elle a changé
+    if (m_heatmap.update() > 0 || m_canvas->overlay().isNull()) {
+        m_canvas->setOverlay(m_heatmap.image());
+    }
 }
 
 void SimpleMapWidget::updateLocationDisplay()
@@ -4,28 +4,84 @@
 #include <QWidget>
 #include <QVBoxLayout>
 #include <QLabel>
+#include <QComboBox>
 #include <QString>
+#include <QTimer>
+#include <QFuture>
+#include <atomic>
 #include "WeatherData.h"
+#include "maptilecache.h"
+#include "heatmapgrid.h"
+
+class MapCanvas;
+class ICacheManager;
 
 /**
- * Widget simple pour afficher la localisation d'une ville
- * Affiche le nom de la ville et ses coordonnées GPS
+ * Calque de carte de chaleur affiché sous les marqueurs
+ */
+enum class HeatmapLayer {
+    None,
+    Temperature,        // Température actuelle (°C)
+    Precipitation       // Probabilité de pluie du prochain créneau de prévision (%)
+};
+
+/**
+ * Carte du monde hors ligne avec la ville affichée et les villes en cache
+ *
+ * - Fond : pyramide de tuiles (MapTileCache) rendue une fois depuis les
+ *   traits de côte embarqués puis relue sur disque ; niveaux de vue
+ *   d'ensemble générés en tâche de fond (QtConcurrent) au démarrage
+ * - Marqueurs : villes du cache situées dans la vue, lues dans l'index
+ *   spatial du cache à chaque déplacement et au plus une fois par rafale
+ *   de mises à jour (refreshMarkers)
+ * - Carte de chaleur optionnelle (HeatmapGrid) : échantillons synchronisés
+ *   avec le cache à chaque rafale, seules les cases proches des villes
+ *   modifiées sont recalculées, l'image obtenue est composée avec les tuiles
+ * - Sous la carte : nom et coordonnées GPS de la ville affichée
  */
 class SimpleMapWidget : public QWidget
 {
     Q_OBJECT
 
 public:
-    explicit SimpleMapWidget(QWidget* parent = nullptr);
+    static constexpr int MARKER_REFRESH_MS = 250;
+    static constexpr int PREGENERATED_ZOOM = 2;
+    static constexpr double VIEW_MARGIN_RATIO = 0.1;     // Marge autour de la vue (fraction)
+
+    explicit SimpleMapWidget(QWidget* parent = nullptr,
+                             const QString& tileCacheDir = MapTileCache::defaultCacheDir());
+    ~SimpleMapWidget();
 
     // Affichage manuel des informations
     void showLocation(const QString& cityName, const QString& country,
                       double latitude, double longitude);
     void clearLocation();
 
+    // Source des marqueurs (non possédée)
+    void setCacheManager(const ICacheManager* cache);
+
+    // Calque de carte de chaleur (aucun par défaut)
+    void setHeatmapLayer(HeatmapLayer layer);
+    HeatmapLayer heatmapLayer() const { return m_heatmapLayer; }
+    const HeatmapGrid& heatmap() const { return m_heatmap; }
+
+    MapCanvas* canvas() const { return m_canvas; }
+    MapTileCache* tileCache() { return &m_tileCache; }
+
 public slots:
     // Slot connecté aux signaux WeatherService
-    void onWeatherDataReceived(const QString& cityName, const CurrentWeatherData& data);
+    void onWeatherDataReceived(const QString& cityName, CurrentWeatherPtr data);
+    void onCacheUpdated(const QString& cityName, const QString& dataType);
+
+    // Relit les marqueurs au prochain tour (regroupé)
+    void refreshMarkers();
+
+signals:
+    void cityClicked(const QString& cityName);
+
+private slots:
+    void reloadMarkers();
+    void updateHeatmap();
 
 private:
     // Interface
@@ -34,6 +90,17 @@ private:
     QLabel* m_locationLabel;
     QLabel* m_coordsLabel;
     QLabel* m_infoLabel;
+    QComboBox* m_layerCombo;
+    MapCanvas* m_canvas;
+
+    // Carte
+    MapTileCache m_tileCache;
+    const ICacheManager* m_cache;
+    QTimer* m_markerTimer;
+    HeatmapGrid m_heatmap;
+    HeatmapLayer m_heatmapLayer;
+    QFuture<int> m_pregeneration;           // Lit m_tileCache : attendue avant sa destruction
+    std::atomic<bool> m_cancelPregeneration;
 
     QString m_currentCity;
     double m_latitude;
@@ -1,5 +1,5 @@
 # src/src.pro
-QT += core gui network charts
+QT += core gui network charts concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -13,22 +13,70 @@ TEMPLATE = app
 TARGET = WeatherApp
 
 SOURCES += \
+    chartdownsampling.cpp \
+    citygazetteer.cpp \
+    cityspatialindex.cpp \
+    citytrie.cpp \
+    historyjournal.cpp \
+    logpanel.cpp \
     configloader.cpp \
+    dashboardmodel.cpp \
+    dashboardwidget.cpp \
+    derivedmetrics.cpp \
+    heatmapgrid.cpp \
     main.cpp \
     mainwindow.cpp \
+    mapcanvas.cpp \
+    maptilecache.cpp \
+    parsearena.cpp \
+    refreshscheduler.cpp \
+    rendercache.cpp \
+    searchhistory.cpp \
+    searchhistorymodel.cpp \
+    simplemapwidget.cpp \
     weathercachemanager.cpp \
     weatherchartwidget.cpp \
-    weatherservice.cpp
+    weatherjsonparser.cpp \
+    weatherprefetcher.cpp \
+    weatherservice.cpp \
+    weatherstats.cpp
 
 HEADERS += \
     ICacheManager.h \
     WeatherData.h \
+    chartdownsampling.h \
+    citygazetteer.h \
+    cityspatialindex.h \
+    citykey.h \
+    citytrie.h \
+    historyjournal.h \
+    logpanel.h \
+    inlinelist.h \
     configloader.h \
+    dashboardmodel.h \
+    dashboardwidget.h \
+    derivedmetrics.h \
+    heatmapgrid.h \
     mainwindow.h \
+    mapcanvas.h \
+    maptilecache.h \
+    parsearena.h \
+    refreshscheduler.h \
+    rendercache.h \
+    SearchHistory.h \
+    searchhistorymodel.h \
+    simplemapwidget.h \
     weathercachemanager.h \
     weatherchartwidget.h \
+    weatherjsonparser.h \
     weathererrors.h \
-    weatherservice.h
+    weatherprefetcher.h \
+    weatherservice.h \
+    weatherstats.h
+
+# Données embarquées (traits de côte de la carte hors ligne, villes de base du gazetteer)
+RESOURCES += \
+    resources.qrc
 
 # Rendre les headers accessibles aux tests
 INCLUDEPATH += $$PWD
@@ -1,28 +1,59 @@
 #include "weathercachemanager.h"
+#include <QJsonDocument>
+#include <algorithm>
 
 weathercachemanager::weathercachemanager()
+    : m_rawPayloadMode(RawPayloadMode::Discard)
+    , m_memoryBudget(0)
+    , m_memoryUsage(0)
+    , m_nextSequence(0)
 {
     qDebug()<<"Initiate a cache manager";
 }
 
-void weathercachemanager::storeCachedWeather(const QString& cityName, const CurrentWeatherData& data)
+void weathercachemanager::storeCachedWeather(const CityKey& key, CurrentWeatherPtr data,
+                                             const QByteArray& rawPayload)
 {
     CachedWeatherData cached;
-    cached.weatherData = data;
+    cached.weatherData = std::move(data);
+    cached.rawPayload = preparePayload(rawPayload);
     cached.cacheInfo.cachedAt = QDateTime::currentDateTime();
     cached.cacheInfo.validityMinutes = 15; // 15 minutes
+    cached.cacheInfo.sequence = ++m_nextSequence;
 
-    m_weatherCache[cityName] = cached;
+    auto it = m_weatherCache.find(key);
+    if (it != m_weatherCache.end()) {
+        m_memoryUsage -= it.value().memoryFootprint();
+    }
+    m_memoryUsage += cached.memoryFootprint();
+    if (cached.weatherData) {
+        m_spatialIndex.insert(key, cached.weatherData->latitude, cached.weatherData->longitude);
+    } else {
+        m_spatialIndex.remove(key);
+    }
+    m_weatherCache[key] = cached;
+
+    enforceMemoryBudget();
 }
 
-void weathercachemanager::storeCachedForecast(const QString& cityName, const ForecastData& data)
+void weathercachemanager::storeCachedForecast(const CityKey& key, ForecastPtr data,
+                                              const QByteArray& rawPayload)
 {
     CachedForecastData cached;
-    cached.forecastData = data;
+    cached.forecastData = std::move(data);
+    cached.rawPayload = preparePayload(rawPayload);
     cached.cacheInfo.cachedAt = QDateTime::currentDateTime();
     cached.cacheInfo.validityMinutes = 120; // 2 heures
+    cached.cacheInfo.sequence = ++m_nextSequence;
 
-    m_forecastCache[cityName] = cached;
+    auto it = m_forecastCache.find(key);
+    if (it != m_forecastCache.end()) {
+        m_memoryUsage -= releaseForecast(it.value());
+    }
+    m_memoryUsage += chargeForecast(cached);
+    m_forecastCache[key] = cached;
+
+    enforceMemoryBudget();
 }
 
 int weathercachemanager::clear()
@@ -30,12 +61,250 @@ int weathercachemanager::clear()
     int count = m_weatherCache.size() + m_forecastCache.size();
     m_weatherCache.clear();
     m_forecastCache.clear();
+    m_spatialIndex.clear();
+    m_sharedLabels.clear();
+    m_memoryUsage = 0;
     qDebug() << "Cache cleared -" << count << "entries removed";
     return count;
 }
 
-CurrentWeatherData weathercachemanager::getCityweatherInCache(const QString& cityName) const{
-    return m_weatherCache[cityName].weatherData;
+CurrentWeatherPtr weathercachemanager::tryGetWeather(const CityKey& key) const
+{
+    auto it = m_weatherCache.constFind(key);
+    if (it == m_weatherCache.cend() || !it.value().cacheInfo.isValid()) {
+        return nullptr;
+    }
+    return it.value().weatherData;
+}
+
+ForecastPtr weathercachemanager::tryGetForecast(const CityKey& key) const
+{
+    auto it = m_forecastCache.constFind(key);
+    if (it == m_forecastCache.cend() || !it.value().cacheInfo.isValid()) {
+        return nullptr;
+    }
+    return it.value().forecastData;
+}
+
+CurrentWeatherPtr weathercachemanager::peekWeather(const CityKey& key) const
+{
+    auto it = m_weatherCache.constFind(key);
+    return it != m_weatherCache.cend() ? it.value().weatherData : nullptr;
+}
+
+QList<CityKey> weathercachemanager::cachedKeys() const
+{
+    QList<CityKey> keys;
+    keys.reserve(m_weatherCache.size() + m_forecastCache.size());
+    for (auto it = m_weatherCache.cbegin(); it != m_weatherCache.cend(); ++it) {
+        keys.append(it.key());
+    }
+    // Prévisions seules : villes absentes du cache météo
+    for (auto it = m_forecastCache.cbegin(); it != m_forecastCache.cend(); ++it) {
+        if (!m_weatherCache.contains(it.key())) {
+            keys.append(it.key());
+        }
+    }
+    return keys;
+}
+
+QList<CityKey> weathercachemanager::citiesInArea(const QRectF& bounds) const
+{
+    return m_spatialIndex.within(bounds);
+}
+
+QList<CityKey> weathercachemanager::nearestCities(double latitude, double longitude, int count,
+                                                  double maxDistanceKm) const
+{
+    return m_spatialIndex.nearest(latitude, longitude, count, maxDistanceKm);
+}
+
+CurrentWeatherData weathercachemanager::getCityweatherInCache(const CityKey& key) const{
+    auto it = m_weatherCache.constFind(key);
+    return it != m_weatherCache.cend() && it.value().weatherData ? *it.value().weatherData : CurrentWeatherData();
+}
+
+ForecastData weathercachemanager::getCityForecastInCache(const CityKey& key) const
+{
+    auto it = m_forecastCache.constFind(key);
+    return it != m_forecastCache.cend() && it.value().forecastData ? *it.value().forecastData : ForecastData();
+}
+
+DerivedMetricsPtr weathercachemanager::derivedMetrics(const CityKey& key) const
+{
+    auto it = m_weatherCache.constFind(key);
+    if (it == m_weatherCache.cend() || !it.value().weatherData || !it.value().cacheInfo.isValid()) {
+        return nullptr;
+    }
+    const CachedWeatherData& cached = it.value();
+    if (!cached.derived) {
+        cached.derived = std::make_shared<const DerivedMetrics>(WeatherMetrics::compute(*cached.weatherData));
+    }
+    return cached.derived;
+}
+
+ForecastMetricsPtr weathercachemanager::derivedForecastMetrics(const CityKey& key) const
+{
+    auto it = m_forecastCache.constFind(key);
+    if (it == m_forecastCache.cend() || !it.value().forecastData || !it.value().cacheInfo.isValid()) {
+        return nullptr;
+    }
+    const CachedForecastData& cached = it.value();
+    if (!cached.derived) {
+        cached.derived = std::make_shared<const QList<DerivedMetrics>>(WeatherMetrics::compute(*cached.forecastData));
+    }
+    return cached.derived;
+}
+
+QHash<CityKey, DerivedMetricsPtr> weathercachemanager::derivedMetrics(const QList<CityKey>& keys) const
+{
+    QHash<CityKey, DerivedMetricsPtr> result;
+    result.reserve(keys.size());
+
+    // Entrées déjà calculées servies telles quelles, les autres regroupées
+    QList<const CachedWeatherData*> missing;
+    QList<const CurrentWeatherData*> inputs;
+    QList<CityKey> missingKeys;
+    for (const CityKey& key : keys) {
+        auto it = m_weatherCache.constFind(key);
+        if (it == m_weatherCache.cend() || !it.value().weatherData || !it.value().cacheInfo.isValid()) {
+            continue;
+        }
+        const CachedWeatherData& cached = it.value();
+        if (cached.derived) {
+            result.insert(key, cached.derived);
+        } else if (!result.contains(key) && !missingKeys.contains(key)) {
+            missing.append(&cached);
+            inputs.append(cached.weatherData.get());
+            missingKeys.append(key);
+        }
+    }
+
+    const QList<DerivedMetrics> computed = WeatherMetrics::computeBatch(inputs);
+    for (qsizetype i = 0; i < computed.size(); ++i) {
+        missing[i]->derived = std::make_shared<const DerivedMetrics>(computed[i]);
+        result.insert(missingKeys[i], missing[i]->derived);
+    }
+    return result;
+}
+
+QByteArray weathercachemanager::getRawWeatherPayload(const CityKey& key) const
+{
+    auto it = m_weatherCache.constFind(key);
+    return it != m_weatherCache.cend() ? it.value().rawPayload : QByteArray();
+}
+
+QByteArray weathercachemanager::getRawForecastPayload(const CityKey& key) const
+{
+    auto it = m_forecastCache.constFind(key);
+    return it != m_forecastCache.cend() ? it.value().rawPayload : QByteArray();
+}
+
+void weathercachemanager::setRawPayloadMode(RawPayloadMode mode)
+{
+    m_rawPayloadMode = mode;
+}
+
+void weathercachemanager::setMemoryBudget(qint64 bytes)
+{
+    m_memoryBudget = qMax<qint64>(0, bytes);
+    enforceMemoryBudget();
+}
+
+QByteArray weathercachemanager::preparePayload(const QByteArray& rawPayload) const
+{
+    switch (m_rawPayloadMode) {
+    case RawPayloadMode::Original:
+        return rawPayload; // partage implicite, aucune copie
+    case RawPayloadMode::Compact: {
+        QJsonDocument doc = QJsonDocument::fromJson(rawPayload);
+        return doc.isNull() ? rawPayload : doc.toJson(QJsonDocument::Compact);
+    }
+    case RawPayloadMode::Discard:
+        break;
+    }
+    return QByteArray();
+}
+
+void weathercachemanager::enforceMemoryBudget()
+{
+    if (m_memoryBudget <= 0 || m_memoryUsage <= m_memoryBudget) {
+        return;
+    }
+
+    // Entrées triées de la plus ancienne à la plus récente
+    struct Candidate {
+        quint64 sequence;
+        CityKey key;
+        bool isForecast;
+    };
+    QList<Candidate> candidates;
+    candidates.reserve(m_weatherCache.size() + m_forecastCache.size());
+    for (auto it = m_weatherCache.cbegin(); it != m_weatherCache.cend(); ++it) {
+        candidates.append({it.value().cacheInfo.sequence, it.key(), false});
+    }
+    for (auto it = m_forecastCache.cbegin(); it != m_forecastCache.cend(); ++it) {
+        candidates.append({it.value().cacheInfo.sequence, it.key(), true});
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate& a, const Candidate& b) { return a.sequence < b.sequence; });
+
+    // 1. Abandon des réponses brutes, les structures parsées restent utilisables
+    for (const Candidate& candidate : candidates) {
+        if (m_memoryUsage <= m_memoryBudget) return;
+        QByteArray& raw = candidate.isForecast ? m_forecastCache[candidate.key].rawPayload
+                                               : m_weatherCache[candidate.key].rawPayload;
+        m_memoryUsage -= raw.size();
+        raw = QByteArray();
+    }
+
+    // 2. Éviction des entrées les plus anciennes (la plus récente est conservée)
+    int evicted = 0;
+    for (int i = 0; i < candidates.size() - 1 && m_memoryUsage > m_memoryBudget; ++i) {
+        const Candidate& candidate = candidates[i];
+        if (candidate.isForecast) {
+            m_memoryUsage -= releaseForecast(m_forecastCache.value(candidate.key));
+            m_forecastCache.remove(candidate.key);
+        } else {
+            m_memoryUsage -= m_weatherCache.value(candidate.key).memoryFootprint();
+            m_weatherCache.remove(candidate.key);
+            m_spatialIndex.remove(candidate.key);
+        }
+        ++evicted;
+    }
+    qDebug() << "Cache over budget -" << evicted << "entries evicted, usage" << m_memoryUsage;
+}
+
+qint64 weathercachemanager::chargeForecast(const CachedForecastData& cached)
+{
+    if (!cached.forecastData) return cached.rawPayload.size();
+
+    // Libellé déjà tenu par une autre entrée : son tampon est déjà compté
+    qint64 size = cached.forecastData->fixedFootprint() + cached.rawPayload.size();
+    cached.forecastData->forEachDistinctLabel([this, &size](const QString& label) {
+        SharedLabel& shared = m_sharedLabels[label.constData()];
+        if (shared.references++ == 0) {
+            shared.bytes = label.capacity() * sizeof(QChar);
+            size += shared.bytes;
+        }
+    });
+    return size;
+}
+
+qint64 weathercachemanager::releaseForecast(const CachedForecastData& cached)
+{
+    if (!cached.forecastData) return cached.rawPayload.size();
+
+    // Le tampon ne sort du compte qu'avec la dernière entrée qui le partage
+    qint64 size = cached.forecastData->fixedFootprint() + cached.rawPayload.size();
+    cached.forecastData->forEachDistinctLabel([this, &size](const QString& label) {
+        auto it = m_sharedLabels.find(label.constData());
+        if (it != m_sharedLabels.end() && --it.value().references == 0) {
+            size += it.value().bytes;
+            m_sharedLabels.erase(it);
+        }
+    });
+    return size;
 }
 
 void weathercachemanager::signalCacheCleared() {
@@ -49,6 +318,8 @@ int weathercachemanager::cleanExpiredCache()
     auto weatherIt = m_weatherCache.begin();
     while (weatherIt != m_weatherCache.end()) {
         if (!weatherIt.value().cacheInfo.isValid()) {
+            m_memoryUsage -= weatherIt.value().memoryFootprint();
+            m_spatialIndex.remove(weatherIt.key());
             weatherIt = m_weatherCache.erase(weatherIt);
             removed++;
         } else {
@@ -60,6 +331,7 @@ int weathercachemanager::cleanExpiredCache()
     auto forecastIt = m_forecastCache.begin();
     while (forecastIt != m_forecastCache.end()) {
         if (!forecastIt.value().cacheInfo.isValid()) {
+            m_memoryUsage -= releaseForecast(forecastIt.value());
             forecastIt = m_forecastCache.erase(forecastIt);
             removed++;
         } else {
@@ -69,14 +341,35 @@ int weathercachemanager::cleanExpiredCache()
     return removed;
 }
 
-bool weathercachemanager::isValid(const QString& cityName, const QString& dataType) const
+bool weathercachemanager::isValid(const CityKey& key, WeatherDataType dataType) const
 {
-    if (dataType == "weather") {
-        return m_weatherCache.contains(cityName) &&
-               m_weatherCache[cityName].cacheInfo.isValid();
-    } else if (dataType == "forecast") {
-        return m_forecastCache.contains(cityName) &&
-               m_forecastCache[cityName].cacheInfo.isValid();
+    // Une seule recherche par appel
+    switch (dataType) {
+    case WeatherDataType::Weather: {
+        auto it = m_weatherCache.constFind(key);
+        return it != m_weatherCache.cend() && it.value().cacheInfo.isValid();
+    }
+    case WeatherDataType::Forecast: {
+        auto it = m_forecastCache.constFind(key);
+        return it != m_forecastCache.cend() && it.value().cacheInfo.isValid();
+    }
     }
     return false;
 }
+
+CacheInfo weathercachemanager::getCacheInfo(const CityKey& key, WeatherDataType dataType) const
+{
+    switch (dataType) {
+    case WeatherDataType::Weather: {
+        auto it = m_weatherCache.constFind(key);
+        if (it != m_weatherCache.cend()) return it.value().cacheInfo;
+        break;
+    }
+    case WeatherDataType::Forecast: {
+        auto it = m_forecastCache.constFind(key);
+        if (it != m_forecastCache.cend()) return it.value().cacheInfo;
+        break;
+    }
+    }
+    return CacheInfo();
+}
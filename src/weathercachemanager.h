@@ -2,13 +2,14 @@
 #define WEATHERCACHEMANAGER_H
 #include "WeatherData.h"
 #include "ICacheManager.h"
+#include "cityspatialindex.h"
 #include <QObject>
 #include <qstring.h>
 #include <Qlist>
-#include <QMap>
+#include <QHash>
 
-using WeatherCache = QMap<QString, CachedWeatherData>;  // cityName → données+métadata
-using ForecastCache = QMap<QString, CachedForecastData> ;
+using WeatherCache = QHash<CityKey, CachedWeatherData>;  // clé canonique → données+métadata
+using ForecastCache = QHash<CityKey, CachedForecastData>;
 class weathercachemanager:public QObject, public ICacheManager
 {
     Q_OBJECT
@@ -17,7 +18,24 @@ private:
     WeatherCache m_weatherCache;
     //save the forecast
     ForecastCache m_forecastCache;
-    int clear();
+    //raw payload policy and memory budget (0 = unlimited)
+    RawPayloadMode m_rawPayloadMode;
+    qint64 m_memoryBudget;
+    qint64 m_memoryUsage;
+    quint64 m_nextSequence;
+    //positions of the cached weather entries
+    CitySpatialIndex m_spatialIndex;
+    //forecast labels shared between cached entries: buffer -> (references, bytes)
+    struct SharedLabel {
+        int references = 0;
+        qint64 bytes = 0;
+    };
+    QHash<const QChar*, SharedLabel> m_sharedLabels;
+    QByteArray preparePayload(const QByteArray& rawPayload) const;
+    void enforceMemoryBudget();
+    //memory accounting of a forecast entry, shared labels counted once for the whole cache
+    qint64 chargeForecast(const CachedForecastData& cached);
+    qint64 releaseForecast(const CachedForecastData& cached);
 
 public:
     weathercachemanager();
@@ -30,25 +48,114 @@ public:
      * Clean the cache
      */
     int cleanExpiredCache() override;
+    /**
+     * Remove every entry
+     * @return number of removed entries
+     */
+    int clear() override;
     /**
      * check the cache validity
-     * param @cityName : name of the city
+     * param @key : canonical city key
      * param @dataType : weather or forecast
      */
-    bool isValid(const QString& cityName, const QString& dataType) const override;
+    bool isValid(const CityKey& key, WeatherDataType dataType) const override;
+    /**
+     * return the cache metadata of an entry
+     * param @key : canonical city key
+     * param @dataType : weather or forecast
+     */
+    CacheInfo getCacheInfo(const CityKey& key, WeatherDataType dataType) const override;
     /**
      * store the weater
-     * @param cityName
+     * @param key
      * @param CurrentWeatherData
      */
-    void storeCachedWeather(const QString& cityName, const CurrentWeatherData& data) override;
-    void storeCachedForecast(const QString& cityName, const ForecastData& data) override;
+    void storeCachedWeather(const CityKey& key, CurrentWeatherPtr data,
+                            const QByteArray& rawPayload = QByteArray()) override;
+    void storeCachedForecast(const CityKey& key, ForecastPtr data,
+                             const QByteArray& rawPayload = QByteArray()) override;
+    using ICacheManager::storeCachedWeather;
+    using ICacheManager::storeCachedForecast;
     /**
      * return the weather in cache
-     * @param cityName
+     * @param key
      * @param returned weather.
      */
-    CurrentWeatherData getCityweatherInCache(const QString& cityName) const override;
+    /**
+     * get-if-valid in one hashed lookup
+     * The handle shares the cached data (no copy, no allocation);
+     * it stays valid even if the entry is replaced or evicted.
+     * @param key
+     * @return nullptr if absent or expired
+     */
+    CurrentWeatherPtr tryGetWeather(const CityKey& key) const override;
+    ForecastPtr tryGetForecast(const CityKey& key) const override;
+    /**
+     * shared handle even if the entry has expired (stale display)
+     * @param key
+     * @return nullptr if absent
+     */
+    CurrentWeatherPtr peekWeather(const CityKey& key) const override;
+    /**
+     * every cached city, weather or forecast, valid or not
+     */
+    QList<CityKey> cachedKeys() const override;
+    /**
+     * cached weather entries inside an area (map viewport)
+     * The index follows every store, eviction and cleanup.
+     * @param bounds x = longitude (may exceed [-180, 180]), y = latitude
+     */
+    QList<CityKey> citiesInArea(const QRectF& bounds) const override;
+    /**
+     * cached weather entries closest to a position, nearest first
+     * @param maxDistanceKm search radius, negative = unlimited
+     */
+    QList<CityKey> nearestCities(double latitude, double longitude, int count,
+                                 double maxDistanceKm = -1.0) const override;
+    CurrentWeatherData getCityweatherInCache(const CityKey& key) const override;
+    /**
+     * return the forecast in cache (empty ForecastData if absent)
+     * The entries are stored inline and copied; use tryGetForecast to share them.
+     * @param key
+     */
+    ForecastData getCityForecastInCache(const CityKey& key) const override;
+    /**
+     * derived metrics (dew point, heat index, wind chill, daylight...)
+     * Computed on first access and kept with the entry; storing a new
+     * entry for the key drops them with the old one.
+     * @param key
+     * @return nullptr if absent or expired
+     */
+    DerivedMetricsPtr derivedMetrics(const CityKey& key) const override;
+    ForecastMetricsPtr derivedForecastMetrics(const CityKey& key) const override;
+    /**
+     * derived metrics for many cities (dashboards, alerts)
+     * Entries not computed yet go through one columnar pass.
+     * @param keys
+     * @return only valid entries
+     */
+    QHash<CityKey, DerivedMetricsPtr> derivedMetrics(const QList<CityKey>& keys) const override;
+    /**
+     * return the raw API response kept with the entry
+     * The returned QByteArray shares the cached buffer (no copy).
+     * @param key
+     */
+    QByteArray getRawWeatherPayload(const CityKey& key) const override;
+    QByteArray getRawForecastPayload(const CityKey& key) const override;
+
+    /**
+     * choose whether raw responses are kept (default: Discard)
+     */
+    void setRawPayloadMode(RawPayloadMode mode);
+    RawPayloadMode rawPayloadMode() const { return m_rawPayloadMode; }
+    /**
+     * memory budget in bytes for parsed + raw data, 0 = unlimited
+     * Over budget, raw payloads of the oldest entries are dropped first,
+     * then the oldest entries themselves.
+     */
+    void setMemoryBudget(qint64 bytes);
+    qint64 memoryBudget() const { return m_memoryBudget; }
+    qint64 memoryUsage() const { return m_memoryUsage; }
 
 signals:
     /**
@@ -1,4 +1,4 @@
-#include "WeatherChartWidget.h"
+#include "weatherchartwidget.h"
 #include <QDebug>
 #include <QtCharts/QChart>
 #include <QtCharts/QChartView>
@@ -6,12 +6,32 @@
 #include <QtCharts/QSplineSeries>
 #include <QtCharts/QValueAxis>
 #include <QtCharts/QDateTimeAxis>
+#include <QtCharts/QLegendMarker>
+#include <QVarLengthArray>
+#include "weatherstats.h"
+
+namespace {
+// Une grandeur des créneaux en tableau contigu (sur la pile jusqu'à 40 créneaux)
+using ForecastColumn = QVarLengthArray<double, FORECAST_INLINE_ENTRIES>;
+
+ForecastColumn forecastColumn(const ForecastData& data, double ForecastEntry::*field)
+{
+    ForecastColumn column;
+    column.reserve(data.entries.size());
+    for (const ForecastEntry& entry : data.entries) {
+        column.append(entry.*field);
+    }
+    return column;
+}
+}
 
 WeatherChartWidget::WeatherChartWidget(QWidget* parent)
     : QWidget(parent)
     , m_layout(nullptr)
     , m_titleLabel(nullptr)
+    , m_chartStack(nullptr)
     , m_chartView(nullptr)
+    , m_snapshotLabel(nullptr)
     , m_chart(nullptr)
     , m_temperatureSeries(nullptr)
     , m_humiditySeries(nullptr)
@@ -20,8 +40,26 @@ WeatherChartWidget::WeatherChartWidget(QWidget* parent)
     , m_axisHumidity(nullptr)
     , m_temperatureColor(Qt::red)
     , m_humidityColor(Qt::blue)
+    , m_animationsEnabled(true)
+    , m_downsamplingMethod(ChartDownsampling::Method::LargestTriangle)
+    , m_levelOfDetailTimer(nullptr)
 {
     setupChart();
+
+    // Zoom ou redimensionnement en mode comparaison : un seul recalcul de la réduction
+    m_levelOfDetailTimer = new QTimer(this);
+    m_levelOfDetailTimer->setSingleShot(true);
+    m_levelOfDetailTimer->setInterval(0);
+    connect(m_levelOfDetailTimer, &QTimer::timeout, this, &WeatherChartWidget::refreshLevelOfDetail);
+
+    auto scheduleLevelOfDetail = [this]() {
+        if (isComparisonMode()) {
+            m_levelOfDetailTimer->start();
+        }
+    };
+    connect(m_axisX, &QDateTimeAxis::rangeChanged, this, scheduleLevelOfDetail);
+    connect(m_chart, &QChart::plotAreaChanged, this, scheduleLevelOfDetail);
+
     qDebug() << "WeatherChartWidget initialized";
 }
 
@@ -51,7 +89,14 @@ void WeatherChartWidget::setupChart()
     m_chartView->setRenderHint(QPainter::Antialiasing);
     m_chartView->setMinimumHeight(300);
 
-    m_layout->addWidget(m_chartView);
+    // Image d'un rendu précédent, affichée à la place du graphique
+    m_snapshotLabel = new QLabel(this);
+    m_snapshotLabel->setAlignment(Qt::AlignCenter);
+
+    m_chartStack = new QStackedWidget(this);
+    m_chartStack->addWidget(m_chartView);
+    m_chartStack->addWidget(m_snapshotLabel);
+    m_layout->addWidget(m_chartStack);
 
     // Configuration initiale
     setupSeries();
@@ -145,40 +190,144 @@ void WeatherChartWidget::displayForecastData(const ForecastData& forecastData)
         return;
     }
 
-    // Vider les séries existantes
-    m_temperatureSeries->clear();
-    m_humiditySeries->clear();
+    if (isComparisonMode()) {
+        clearComparison();
+    }
+    showLiveChart();
+    m_displayedForecast.reset();
 
     // Stocker le nom de la ville
     m_cityName = forecastData.cityName;
 
     qDebug() << "Displaying chart for" << m_cityName << "with" << forecastData.entries.size() << "entries";
 
-    // Ajouter les points de données
+    // Points préparés d'un bloc : un seul replace() par série au lieu d'un
+    // clear() suivi de 40 append() (une mise à jour interne chacun)
+    QList<QPointF> temperaturePoints;
+    QList<QPointF> humidityPoints;
+    temperaturePoints.reserve(forecastData.entries.size());
+    humidityPoints.reserve(forecastData.entries.size());
     for (const ForecastEntry& entry : forecastData.entries) {
         if (!entry.dateTime.isValid()) {
             continue; // Ignorer entrées invalides
         }
 
         // Convertir QDateTime en timestamp pour QtCharts
-        qint64 timestamp = entry.dateTime.toMSecsSinceEpoch();
-
-        // Ajouter points aux séries
-        m_temperatureSeries->append(timestamp, entry.temperature);
-        m_humiditySeries->append(timestamp, entry.humidity);
+        const qreal timestamp = qreal(entry.dateTime.toMSecsSinceEpoch());
+        temperaturePoints.append(QPointF(timestamp, entry.temperature));
+        humidityPoints.append(QPointF(timestamp, entry.humidity));
     }
 
-    // Mettre à jour les plages d'axes
+    applyAnimationPolicy();
+
+    // Un seul rafraîchissement de la vue pour les axes, les séries et le titre
+    m_chartView->setUpdatesEnabled(false);
+
+    // Plages d'axes d'abord : les séries sont placées directement dans le repère final
     updateAxisRanges(forecastData);
+    m_temperatureSeries->replace(temperaturePoints);
+    m_humiditySeries->replace(humidityPoints);
 
     // Mettre à jour le titre
     setChartTitle(QString("Prévisions pour %1 - %2 créneaux")
                       .arg(m_cityName)
                       .arg(forecastData.entries.size()));
 
+    m_chartView->setUpdatesEnabled(true);
+
     qDebug() << "Chart updated successfully";
 }
 
+void WeatherChartWidget::displayForecast(ForecastPtr forecast)
+{
+    if (!forecast || !forecast->isValid()) {
+        qWarning() << "Invalid forecast data for chart display";
+        return;
+    }
+
+    // Ville déjà rendue avec ces mêmes données : aucune reconstruction du graphique
+    if (!isComparisonMode()) {
+        const QPixmap cached = m_renderCache.find(CityKey(forecast->cityName), forecast, m_chartView->size());
+        if (!cached.isNull()) {
+            m_cityName = forecast->cityName;
+            m_displayedForecast = forecast;
+            m_titleLabel->setText(QString("Prévisions pour %1 - %2 créneaux")
+                                      .arg(m_cityName)
+                                      .arg(forecast->entries.size()));
+            m_snapshotLabel->setPixmap(cached);
+            m_chartStack->setCurrentWidget(m_snapshotLabel);
+            return;
+        }
+    }
+
+    displayForecastData(*forecast);
+    m_displayedForecast = forecast;
+    scheduleSnapshot(forecast);
+}
+
+void WeatherChartWidget::showLiveChart()
+{
+    if (m_chartStack->currentWidget() != m_chartView) {
+        m_chartStack->setCurrentWidget(m_chartView);
+        m_snapshotLabel->clear();
+    }
+}
+
+void WeatherChartWidget::scheduleSnapshot(const ForecastPtr& forecast)
+{
+    // Image prise une fois l'animation terminée
+    const int delay = m_chart->animationOptions() == QChart::NoAnimation
+                          ? 0
+                          : m_chart->animationDuration() + 50;
+    std::weak_ptr<const ForecastData> pending = forecast;
+    QTimer::singleShot(delay, this, [this, pending]() {
+        ForecastPtr forecast = pending.lock();
+        if (!forecast || forecast != m_displayedForecast || isComparisonMode()
+            || m_chartStack->currentWidget() != m_chartView) {
+            return; // Une autre ville est affichée entre-temps
+        }
+        m_renderCache.insert(CityKey(forecast->cityName), forecast, m_chartView->grab());
+    });
+}
+
+bool WeatherChartWidget::isShowingCachedRender() const
+{
+    return m_chartStack->currentWidget() == m_snapshotLabel;
+}
+
+void WeatherChartWidget::invalidateRenderCache(const QString& cityName)
+{
+    m_renderCache.invalidate(CityKey(cityName));
+}
+
+void WeatherChartWidget::resizeEvent(QResizeEvent* event)
+{
+    QWidget::resizeEvent(event);
+
+    // L'image ne correspond plus à la taille : retour au graphique, nouvelle image ensuite
+    if (isShowingCachedRender() && m_displayedForecast) {
+        ForecastPtr forecast = m_displayedForecast;
+        displayForecastData(*forecast);
+        m_displayedForecast = forecast;
+        scheduleSnapshot(forecast);
+    }
+}
+
+void WeatherChartWidget::applyAnimationPolicy()
+{
+    // Changements de ville rapprochés : les animations s'empileraient et
+    // bloqueraient l'interface, on affiche directement l'état final
+    const bool rapid = m_lastUpdate.isValid() && m_lastUpdate.elapsed() < RAPID_UPDATE_MS;
+    m_lastUpdate.start();
+
+    const QChart::AnimationOptions options = (m_animationsEnabled && !rapid)
+                                                 ? QChart::AllAnimations
+                                                 : QChart::NoAnimation;
+    if (m_chart->animationOptions() != options) {
+        m_chart->setAnimationOptions(options);
+    }
+}
+
 void WeatherChartWidget::updateAxisRanges(const ForecastData& data)
 {
     if (data.entries.isEmpty()) return;
@@ -208,30 +357,18 @@ QPair<double, double> WeatherChartWidget::getTemperatureRange(const ForecastData
 {
     if (data.entries.isEmpty()) return {0, 30};
 
-    double minTemp = data.entries.first().temperature;
-    double maxTemp = data.entries.first().temperature;
-
-    for (const ForecastEntry& entry : data.entries) {
-        minTemp = qMin(minTemp, entry.temperature);
-        maxTemp = qMax(maxTemp, entry.temperature);
-    }
-
-    return {minTemp, maxTemp};
+    const ForecastColumn temperatures = forecastColumn(data, &ForecastEntry::temperature);
+    const WeatherStats::Range range = WeatherStats::minMax(temperatures.constData(), temperatures.size());
+    return {range.min, range.max};
 }
 
 QPair<double, double> WeatherChartWidget::getHumidityRange(const ForecastData& data) const
 {
     if (data.entries.isEmpty()) return {0, 100};
 
-    double minHumidity = data.entries.first().humidity;
-    double maxHumidity = data.entries.first().humidity;
-
-    for (const ForecastEntry& entry : data.entries) {
-        minHumidity = qMin(minHumidity, entry.humidity);
-        maxHumidity = qMax(maxHumidity, entry.humidity);
-    }
-
-    return {minHumidity, maxHumidity};
+    const ForecastColumn humidity = forecastColumn(data, &ForecastEntry::humidity);
+    const WeatherStats::Range range = WeatherStats::minMax(humidity.constData(), humidity.size());
+    return {range.min, range.max};
 }
 
 QPair<QDateTime, QDateTime> WeatherChartWidget::getTimeRange(const ForecastData& data) const
@@ -247,14 +384,19 @@ QPair<QDateTime, QDateTime> WeatherChartWidget::getTimeRange(const ForecastData&
     return {start, end};
 }
 
-void WeatherChartWidget::onForecastDataReceived(const QString& cityName, const ForecastData& data)
+void WeatherChartWidget::onForecastDataReceived(const QString& cityName, ForecastPtr data)
 {
     Q_UNUSED(cityName)
-    displayForecastData(data);
+    if (data) {
+        displayForecast(data);
+    }
 }
 
 void WeatherChartWidget::clearChart()
 {
+    clearComparison();
+    showLiveChart();
+    m_displayedForecast.reset();
     if (m_temperatureSeries) {
         m_temperatureSeries->clear();
     }
@@ -297,3 +439,233 @@ void WeatherChartWidget::setHumidityColor(const QColor& color)
         m_axisHumidity->setLabelsColor(color);
     }
 }
+
+void WeatherChartWidget::setAnimationsEnabled(bool enabled)
+{
+    m_animationsEnabled = enabled;
+    if (!enabled && m_chart) {
+        m_chart->setAnimationOptions(QChart::NoAnimation);
+    }
+}
+
+void WeatherChartWidget::setDownsamplingMethod(ChartDownsampling::Method method)
+{
+    m_downsamplingMethod = method;
+    refreshLevelOfDetail();
+}
+
+// =====================================================
+// MODE COMPARAISON
+// =====================================================
+
+void WeatherChartWidget::displayComparison(const QList<ForecastPtr>& forecasts)
+{
+    clearComparison();
+    enterComparisonMode();
+
+    for (const ForecastPtr& forecast : forecasts) {
+        if (!forecast || !forecast->isValid()) {
+            continue;
+        }
+
+        QList<QPointF> points;
+        points.reserve(forecast->entries.size());
+        for (const ForecastEntry& entry : forecast->entries) {
+            if (entry.dateTime.isValid()) {
+                points.append(QPointF(qreal(entry.dateTime.toMSecsSinceEpoch()), entry.temperature));
+            }
+        }
+        appendComparison(forecast->cityName, points);
+    }
+
+    if (m_comparison.isEmpty()) {
+        clearComparison();
+        return;
+    }
+
+    m_cityName.clear();
+    setChartTitle(QString("Comparaison des températures - %1 villes").arg(m_comparison.size()));
+
+    // Plages fixées une fois pour toutes les villes, puis réduction immédiate
+    updateComparisonRanges();
+    refreshLevelOfDetail();
+}
+
+void WeatherChartWidget::addComparisonSeries(const QString& name, const QList<QPointF>& points)
+{
+    if (points.isEmpty()) {
+        return;
+    }
+
+    enterComparisonMode();
+    appendComparison(name, points);
+    updateComparisonRanges();
+
+    // Plusieurs ajouts à la suite : une seule réduction au prochain tour de boucle
+    m_levelOfDetailTimer->start();
+}
+
+void WeatherChartWidget::clearComparison()
+{
+    m_levelOfDetailTimer->stop();
+    for (ComparisonSeries& comparison : m_comparison) {
+        if (comparison.series) {
+            m_chart->removeSeries(comparison.series);
+            delete comparison.series;
+        }
+    }
+    m_comparison.clear();
+
+    // Retour à l'affichage d'une ville
+    setSingleCitySeriesVisible(true);
+    m_axisHumidity->setVisible(true);
+    m_chartView->setRubberBand(QChartView::NoRubberBand);
+}
+
+int WeatherChartWidget::displayedPointCount() const
+{
+    if (!isComparisonMode()) {
+        return int(m_temperatureSeries->count() + m_humiditySeries->count());
+    }
+
+    int total = 0;
+    for (const ComparisonSeries& comparison : m_comparison) {
+        if (comparison.series) {
+            total += comparison.series->count();
+        }
+    }
+    return total;
+}
+
+void WeatherChartWidget::refreshLevelOfDetail()
+{
+    m_levelOfDetailTimer->stop();
+    if (m_comparison.isEmpty()) {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Un point par pixel de large au plus, dans la limite du budget global
+    const int plotWidth = qMax(100, int(m_chart->plotArea().width()));
+    const int perSeries = qMax(16, qMin(plotWidth, COMPARISON_POINT_BUDGET / int(m_comparison.size())));
+    const qreal xMin = qreal(m_axisX->min().toMSecsSinceEpoch());
+    const qreal xMax = qreal(m_axisX->max().toMSecsSinceEpoch());
+
+    // Réduction depuis les points d'origine : le zoom fait réapparaître le détail
+    QList<QList<QPointF>> reduced;
+    reduced.reserve(m_comparison.size());
+    qsizetype total = 0;
+    for (const ComparisonSeries& comparison : m_comparison) {
+        const QPair<qsizetype, qsizetype> visible = ChartDownsampling::visibleRange(comparison.points, xMin, xMax);
+        reduced.append(ChartDownsampling::downsample(comparison.points.constData() + visible.first,
+                                                     visible.second - visible.first,
+                                                     perSeries, m_downsamplingMethod));
+        total += reduced.last().size();
+    }
+
+    // Splines seulement pour peu de points : leur lissage coûte cher au rendu
+    const bool spline = total <= SPLINE_POINT_LIMIT;
+
+    m_chartView->setUpdatesEnabled(false);
+    for (int i = 0; i < m_comparison.size(); ++i) {
+        ComparisonSeries& comparison = m_comparison[i];
+        const bool isSpline = comparison.series
+                              && comparison.series->type() == QAbstractSeries::SeriesTypeSpline;
+        if (!comparison.series || isSpline != spline) {
+            if (comparison.series) {
+                m_chart->removeSeries(comparison.series);
+                delete comparison.series;
+            }
+            comparison.series = createComparisonSeries(comparison, i, spline);
+        }
+        comparison.series->replace(reduced.at(i));
+    }
+    m_chartView->setUpdatesEnabled(true);
+
+    if (timer.elapsed() > 16) {
+        qDebug() << "Comparison level of detail over frame budget:" << timer.elapsed() << "ms for"
+                 << total << "points";
+    }
+}
+
+void WeatherChartWidget::appendComparison(const QString& name, const QList<QPointF>& points)
+{
+    if (points.isEmpty()) {
+        return;
+    }
+
+    ComparisonSeries comparison;
+    comparison.name = name;
+    comparison.points = points;
+    comparison.minValue = points.first().y();
+    comparison.maxValue = points.first().y();
+    for (const QPointF& point : points) {
+        comparison.minValue = qMin(comparison.minValue, point.y());
+        comparison.maxValue = qMax(comparison.maxValue, point.y());
+    }
+    m_comparison.append(comparison);
+}
+
+void WeatherChartWidget::enterComparisonMode()
+{
+    showLiveChart();
+    m_displayedForecast.reset();
+
+    // Pas d'animation : des dizaines de courbes animées bloqueraient l'interface
+    m_chart->setAnimationOptions(QChart::NoAnimation);
+    setSingleCitySeriesVisible(false);
+    m_axisHumidity->setVisible(false);
+
+    // Sélection horizontale pour zoomer, clic droit pour revenir
+    m_chartView->setRubberBand(QChartView::HorizontalRubberBand);
+}
+
+void WeatherChartWidget::setSingleCitySeriesVisible(bool visible)
+{
+    for (QXYSeries* series : {static_cast<QXYSeries*>(m_temperatureSeries),
+                              static_cast<QXYSeries*>(m_humiditySeries)}) {
+        series->setVisible(visible);
+        for (QLegendMarker* marker : m_chart->legend()->markers(series)) {
+            marker->setVisible(visible);
+        }
+    }
+}
+
+void WeatherChartWidget::updateComparisonRanges()
+{
+    if (m_comparison.isEmpty()) return;
+
+    qreal xMin = m_comparison.first().points.first().x();
+    qreal xMax = m_comparison.first().points.last().x();
+    double valueMin = m_comparison.first().minValue;
+    double valueMax = m_comparison.first().maxValue;
+    for (const ComparisonSeries& comparison : m_comparison) {
+        xMin = qMin(xMin, comparison.points.first().x());
+        xMax = qMax(xMax, comparison.points.last().x());
+        valueMin = qMin(valueMin, comparison.minValue);
+        valueMax = qMax(valueMax, comparison.maxValue);
+    }
+
+    m_axisX->setRange(QDateTime::fromMSecsSinceEpoch(qint64(xMin)),
+                      QDateTime::fromMSecsSinceEpoch(qint64(xMax)));
+    const double margin = qMax((valueMax - valueMin) * 0.1, 1.0);
+    m_axisTemperature->setRange(valueMin - margin, valueMax + margin);
+}
+
+QXYSeries* WeatherChartWidget::createComparisonSeries(const ComparisonSeries& source, int index, bool spline)
+{
+    QLineSeries* series = spline ? new QSplineSeries() : new QLineSeries();
+    series->setName(source.name);
+
+    // Teintes réparties par l'angle d'or : voisines bien distinctes
+    QPen pen(QColor::fromHsv((index * 137) % 360, 200, 210));
+    pen.setWidth(2);
+    series->setPen(pen);
+
+    m_chart->addSeries(series);
+    series->attachAxis(m_axisX);
+    series->attachAxis(m_axisTemperature);
+    return series;
+}
@@ -11,8 +11,13 @@
 #include <QWidget>
 #include <QVBoxLayout>
 #include <QLabel>
+#include <QStackedWidget>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QTimer>
 #include "WeatherData.h"
+#include "chartdownsampling.h"
+#include "rendercache.h"
 
 
 
@@ -26,6 +31,18 @@
  * - Timeline sur 5 jours avec les 40 créneaux
  * - Légende et couleurs différenciées
  * - Responsive et intégré dans l'interface
+ *
+ * Mise à jour en bloc : un replace() par série, plages d'axes fixées une
+ * fois, animations coupées quand les villes s'enchaînent rapidement.
+ *
+ * Mode comparaison : une courbe de température par ville (prévisions ou
+ * historiques longs), réduite à la largeur en pixels de la zone de tracé et
+ * recalculée à chaque zoom ; lignes droites au lieu de splines au-delà de
+ * SPLINE_POINT_LIMIT points affichés.
+ *
+ * Cache de rendu : l'image du graphique est conservée par ville et par
+ * version des données ; revenir sur une ville déjà affichée (mêmes données
+ * du cache, même taille) montre cette image sans recalculer le graphique.
  */
     class WeatherChartWidget : public QWidget
 {
@@ -37,6 +54,8 @@ public:
 
     // Affichage des données
     void displayForecastData(const ForecastData& forecastData);
+    // Données du cache météo : image réutilisée si la ville a déjà été rendue
+    void displayForecast(ForecastPtr forecast);
     void clearChart();
 
     // Configuration
@@ -44,14 +63,51 @@ public:
     void setTemperatureColor(const QColor& color);
     void setHumidityColor(const QColor& color);
 
+    // Animations pour les mises à jour isolées (jamais pendant un enchaînement rapide)
+    void setAnimationsEnabled(bool enabled);
+    bool animationsEnabled() const { return m_animationsEnabled; }
+
+    // Deux mises à jour plus rapprochées que ce délai : pas d'animation
+    static constexpr int RAPID_UPDATE_MS = 500;
+
+    // === MODE COMPARAISON ===
+    // Remplace les courbes de la ville courante ; displayForecastData() en sort
+    void displayComparison(const QList<ForecastPtr>& forecasts);
+    // x : ms depuis l'epoch, y : °C, points triés par x
+    void addComparisonSeries(const QString& name, const QList<QPointF>& points);
+    void clearComparison();
+    bool isComparisonMode() const { return !m_comparison.isEmpty(); }
+
+    void setDownsamplingMethod(ChartDownsampling::Method method);
+    int displayedPointCount() const;   // Points réellement tracés (après réduction)
+
+    // === CACHE DE RENDU ===
+    // Entrée du cache météo modifiée : l'image de la ville est libérée
+    void invalidateRenderCache(const QString& cityName);
+    const RenderCache& renderCache() const { return m_renderCache; }
+    bool isShowingCachedRender() const;
+
+    // Au-delà (points tracés, toutes courbes) : QLineSeries au lieu de QSplineSeries
+    static constexpr int SPLINE_POINT_LIMIT = 500;
+    // Plafond de points tracés, toutes courbes confondues (rendu sous ~16 ms)
+    static constexpr int COMPARISON_POINT_BUDGET = 20000;
+
+protected:
+    void resizeEvent(QResizeEvent* event) override;
+
 public slots:
-    void onForecastDataReceived(const QString& cityName, const ForecastData& data);
+    void onForecastDataReceived(const QString& cityName, ForecastPtr data);
+
+    // Réduction recalculée pour la plage visible (appelé après zoom ou redimensionnement)
+    void refreshLevelOfDetail();
 
 private:
     // Interface
     QVBoxLayout* m_layout;
     QLabel* m_titleLabel;
+    QStackedWidget* m_chartStack;    // Graphique interactif ou image en cache
     QChartView* m_chartView;
+    QLabel* m_snapshotLabel;
     QChart* m_chart;
 
     // Séries de données
@@ -67,6 +123,24 @@ private:
     QString m_cityName;
     QColor m_temperatureColor;
     QColor m_humidityColor;
+    bool m_animationsEnabled;
+    QElapsedTimer m_lastUpdate;      // Détection des changements de ville rapides
+
+    // Mode comparaison : points d'origine conservés, seule la vue est réduite
+    struct ComparisonSeries {
+        QString name;
+        QList<QPointF> points;
+        double minValue = 0.0;
+        double maxValue = 0.0;
+        QXYSeries* series = nullptr;
+    };
+    QList<ComparisonSeries> m_comparison;
+    ChartDownsampling::Method m_downsamplingMethod;
+    QTimer* m_levelOfDetailTimer;    // Regroupe zoom et redimensionnement en un seul recalcul
+
+    // Cache de rendu
+    RenderCache m_renderCache;
+    ForecastPtr m_displayedForecast; // Données affichées (nul hors cache météo)
 
     // Méthodes privées
     void setupChart();
@@ -74,6 +148,16 @@ private:
     void setupSeries();
     void configureAppearance();
     void updateAxisRanges(const ForecastData& data);
+    void applyAnimationPolicy();
+    void showLiveChart();
+    void scheduleSnapshot(const ForecastPtr& forecast);
+
+    // Mode comparaison
+    void appendComparison(const QString& name, const QList<QPointF>& points);
+    void enterComparisonMode();
+    void setSingleCitySeriesVisible(bool visible);
+    void updateComparisonRanges();
+    QXYSeries* createComparisonSeries(const ComparisonSeries& source, int index, bool spline);
 
     // Utilitaires données
     QPair<double, double> getTemperatureRange(const ForecastData& data) const;
@@ -0,0 +1,178 @@
+#include "weatherjsonparser.h"
+#include "parsearena.h"
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QJsonValue>
+
+namespace {
+// Accès en lecture seule avec une clé Latin-1 littérale : ni QString
+// temporaire pour la clé, ni détachement de l'objet (operator[] non const)
+template <size_t N>
+inline QJsonValue field(const QJsonObject& object, const char (&key)[N])
+{
+    return object.value(QLatin1String(key, int(N - 1)));
+}
+
+// Les sous-objets sont des vues partagées sur le document (pas de copie)
+template <size_t N>
+inline QJsonObject child(const QJsonObject& object, const char (&key)[N])
+{
+    return field(object, key).toObject();
+}
+
+// Premier élément de "weather" (objet vide si absent)
+inline QJsonObject firstCondition(const QJsonObject& object)
+{
+    const QJsonArray weather = field(object, "weather").toArray();
+    return weather.isEmpty() ? QJsonObject() : weather.first().toObject();
+}
+}
+
+// =====================================================
+// MÉTÉO ACTUELLE
+// =====================================================
+
+CurrentWeatherData WeatherJsonParser::parseCurrentWeather(const QJsonObject& json)
+{
+    CurrentWeatherData data;
+
+    // Informations ville
+    data.cityName = field(json, "name").toString();
+    data.cityId = field(json, "id").toInteger();
+    const QJsonObject sys = child(json, "sys");
+    data.countryCode = field(sys, "country").toString();
+    if (sys.contains(QLatin1String("sunrise"))) {
+        data.sunrise = QDateTime::fromSecsSinceEpoch(field(sys, "sunrise").toInteger());
+        data.sunset = QDateTime::fromSecsSinceEpoch(field(sys, "sunset").toInteger());
+    }
+
+    // Coordonnées
+    const QJsonObject coord = child(json, "coord");
+    data.latitude = field(coord, "lat").toDouble();
+    data.longitude = field(coord, "lon").toDouble();
+
+    // Données principales
+    const QJsonObject main = child(json, "main");
+    data.temperature = field(main, "temp").toDouble();
+    data.feelsLike = field(main, "feels_like").toDouble();
+    data.temperatureMin = field(main, "temp_min").toDouble();
+    data.temperatureMax = field(main, "temp_max").toDouble();
+    data.humidity = field(main, "humidity").toDouble();
+    data.pressure = field(main, "pressure").toDouble();
+
+    // Conditions météo
+    const QJsonObject condition = firstCondition(json);
+    data.mainCondition = field(condition, "main").toString();
+    data.description = field(condition, "description").toString();
+    data.iconCode = field(condition, "icon").toString();
+    data.conditionId = field(condition, "id").toInt();
+
+    // Vent
+    const QJsonObject wind = child(json, "wind");
+    data.windSpeed = field(wind, "speed").toDouble();
+    data.windDirection = field(wind, "deg").toInt();
+
+    // Autres
+    data.visibility = field(json, "visibility").toDouble();
+    data.cloudiness = field(child(json, "clouds"), "all").toInt();
+
+    // Timestamp et fuseau de la ville
+    data.timestamp = QDateTime::fromSecsSinceEpoch(field(json, "dt").toInteger());
+    data.timezone = field(json, "timezone").toInt();
+
+    return data;
+}
+
+// =====================================================
+// PRÉVISIONS
+// =====================================================
+
+ForecastData WeatherJsonParser::parseForecast(const QJsonObject& json, ParseArena* arena)
+{
+    // Sans lot fourni, la réponse forme son propre lot (40 créneaux)
+    if (!arena) {
+        ParseArena local;
+        return parseForecast(json, &local);
+    }
+
+    ForecastData data;
+
+    // Informations ville
+    const QJsonObject city = child(json, "city");
+    data.cityName = field(city, "name").toString();
+    const QJsonObject coord = child(city, "coord");
+    data.latitude = field(coord, "lat").toDouble();
+    data.longitude = field(coord, "lon").toDouble();
+    data.timezoneOffset = field(city, "timezone").toInt();
+
+    // Parsing des entrées
+    const QJsonArray list = field(json, "list").toArray();
+
+    // Taille connue d'avance : stockage intégré jusqu'à 40, sinon une seule réservation
+    data.entries.reserve(list.size());
+    for (const QJsonValue& value : list) {
+        data.entries.append(parseForecastEntry(value.toObject(), *arena));
+    }
+
+    // Résumés quotidiens calculés une fois, partagés avec la prévision en cache
+    data.updateDailySummaries();
+
+    data.retrievedAt = QDateTime::currentDateTime();
+    return data;
+}
+
+QList<ForecastData> WeatherJsonParser::parseForecastBatch(const QList<QByteArray>& payloads)
+{
+    QList<ForecastData> result;
+    result.reserve(payloads.size());
+
+    // Un seul arena pour tout le lot, rendu d'un coup en sortie
+    ParseArena arena;
+    for (const QByteArray& payload : payloads) {
+        result.append(parseForecast(QJsonDocument::fromJson(payload).object(), &arena));
+    }
+    return result;
+}
+
+ForecastEntry WeatherJsonParser::parseForecastEntry(const QJsonObject& entryJson, ParseArena& arena)
+{
+    ForecastEntry entry;
+
+    // Timestamp : "dt" est déjà en secondes UTC, "dt_txt" (UTC aussi) seulement en secours
+    const QJsonValue dt = field(entryJson, "dt");
+    if (dt.isDouble()) {
+        entry.dateTime = QDateTime::fromSecsSinceEpoch(dt.toInteger());
+    } else {
+        QDateTime utc = QDateTime::fromString(field(entryJson, "dt_txt").toString(), "yyyy-MM-dd hh:mm:ss");
+        utc.setTimeSpec(Qt::UTC);
+        entry.dateTime = utc.toLocalTime();
+    }
+
+    // Données principales
+    const QJsonObject main = child(entryJson, "main");
+    entry.temperature = field(main, "temp").toDouble();
+    entry.feelsLike = field(main, "feels_like").toDouble();
+    entry.humidity = field(main, "humidity").toDouble();
+    entry.pressure = field(main, "pressure").toDouble();
+
+    // Conditions météo : libellés répétés d'un créneau à l'autre → internés
+    const QJsonObject condition = firstCondition(entryJson);
+    entry.mainCondition = arena.intern(field(condition, "main").toString());
+    entry.description = arena.intern(field(condition, "description").toString());
+    entry.iconCode = arena.intern(field(condition, "icon").toString());
+    entry.conditionId = field(condition, "id").toInt();
+
+    // Vent
+    const QJsonObject wind = child(entryJson, "wind");
+    entry.windSpeed = field(wind, "speed").toDouble();
+    entry.windDirection = field(wind, "deg").toInt();
+    entry.windGust = field(wind, "gust").toDouble();
+
+    // Nuages
+    entry.cloudiness = field(child(entryJson, "clouds"), "all").toInt();
+
+    // Probabilité précipitations
+    entry.precipitationProbability = field(entryJson, "pop").toDouble() * 100; // 0.0-1.0 → 0-100%
+
+    return entry;
+}
@@ -0,0 +1,36 @@
+#ifndef WEATHERJSONPARSER_H
+#define WEATHERJSONPARSER_H
+
+#include "WeatherData.h"
+#include <QByteArray>
+#include <QJsonObject>
+#include <QList>
+
+class ParseArena;
+
+/**
+ * Conversion des réponses OpenWeatherMap en structures typées
+ *
+ * Sans état ni dépendance réseau : utilisé par WeatherService et
+ * directement par les benchmarks de parsing.
+ */
+class WeatherJsonParser
+{
+public:
+    // Réponse /weather
+    static CurrentWeatherData parseCurrentWeather(const QJsonObject& json);
+
+    /**
+     * Réponse /forecast (créneaux stockés dans ForecastData, voir ForecastEntryList)
+     * @param arena Lot en cours (libellés internés entre réponses) ; nullptr = lot d'une réponse
+     */
+    static ForecastData parseForecast(const QJsonObject& json, ParseArena* arena = nullptr);
+
+    // Plusieurs réponses /forecast avec un seul arena, libéré en fin de lot
+    static QList<ForecastData> parseForecastBatch(const QList<QByteArray>& payloads);
+
+    // Un élément du tableau "list" de /forecast
+    static ForecastEntry parseForecastEntry(const QJsonObject& entryJson, ParseArena& arena);
+};
+
+#endif // WEATHERJSONPARSER_H
@@ -0,0 +1,172 @@
+#include "weatherprefetcher.h"
+#include "WeatherService.h"
+#include "SearchHistory.h"
+#include <QDateTime>
+#include <QDebug>
+
+WeatherPrefetcher::WeatherPrefetcher(WeatherService* service, SearchHistory* history, QObject* parent)
+    : QObject(parent)
+    , m_weatherService(service)
+    , m_history(history)
+    , m_periodicTimer(nullptr)
+    , m_spacingTimer(nullptr)
+    , m_topN(8)
+{
+    m_periodicTimer = new QTimer(this);
+    m_periodicTimer->setInterval(30 * 60 * 1000); // 30 minutes
+    connect(m_periodicTimer, &QTimer::timeout, this, &WeatherPrefetcher::prefetchNow);
+
+    m_spacingTimer = new QTimer(this);
+    m_spacingTimer->setInterval(1500);
+    connect(m_spacingTimer, &QTimer::timeout, this, &WeatherPrefetcher::onSpacingTick);
+
+    connect(m_weatherService, &WeatherService::backgroundRefreshCompleted,
+            this, &WeatherPrefetcher::onBackgroundRefreshCompleted);
+    connect(m_weatherService, &WeatherService::backgroundRefreshFailed,
+            this, &WeatherPrefetcher::onBackgroundRefreshFailed);
+    connect(m_weatherService, &WeatherService::cacheHit,
+            this, &WeatherPrefetcher::onCacheHit);
+}
+
+void WeatherPrefetcher::setTopN(int count)
+{
+    m_topN = qMax(0, count);
+}
+
+void WeatherPrefetcher::setIntervalMinutes(int minutes)
+{
+    m_periodicTimer->setInterval(qMax(1, minutes) * 60 * 1000);
+}
+
+void WeatherPrefetcher::setSpacingMs(int ms)
+{
+    m_spacingTimer->setInterval(qMax(0, ms));
+}
+
+void WeatherPrefetcher::start()
+{
+    prefetchNow();
+    m_periodicTimer->start();
+}
+
+void WeatherPrefetcher::stop()
+{
+    m_periodicTimer->stop();
+    m_spacingTimer->stop();
+    m_queue.clear();
+}
+
+void WeatherPrefetcher::prefetchNow()
+{
+    expireStaleEntries();
+
+    m_queue = selectCandidates();
+    qDebug() << "Prefetch candidates:" << m_queue;
+    if (!m_queue.isEmpty()) {
+        m_spacingTimer->start();
+    }
+}
+
+QStringList WeatherPrefetcher::selectCandidates() const
+{
+    QStringList candidates;
+    auto addUnique = [&](const QStringList& cities) {
+        for (const QString& city : cities) {
+            if (candidates.size() >= m_topN) return;
+            bool known = false;
+            for (const QString& existing : candidates) {
+                if (existing.compare(city, Qt::CaseInsensitive) == 0) {
+                    known = true;
+                    break;
+                }
+            }
+            if (!known) candidates.append(city);
+        }
+    };
+
+    const int hour = QTime::currentTime().hour();
+    addUnique(m_history->getFavorites());
+    addUnique(m_history->getSearchesForHour(hour, m_topN));
+    addUnique(m_history->getSearchesForHour((hour + 1) % 24, m_topN));
+    addUnique(m_history->getFrequentSearches(m_topN));
+    return candidates;
+}
+
+void WeatherPrefetcher::onSpacingTick()
+{
+    if (m_queue.isEmpty()) {
+        m_spacingTimer->stop();
+        return;
+    }
+
+    // Seuls les types réellement demandés attendent un remplissage : un type sauté
+    // resterait à 0 et un rafraîchissement planifié ultérieur passerait pour un préchargement
+    QString city = m_queue.takeFirst();
+    const QList<WeatherDataType> issued = m_weatherService->prefetch(city);
+    if (issued.isEmpty()) {
+        return;
+    }
+    m_stats.issued++;
+    for (WeatherDataType dataType : issued) {
+        m_prefetched.insert(entryKey(city, dataTypeName(dataType)), 0);
+    }
+    emit statsChanged(m_stats);
+}
+
+void WeatherPrefetcher::onBackgroundRefreshCompleted(const QString& cityName, const QString& dataType)
+{
+    auto it = m_prefetched.find(entryKey(cityName, dataType));
+    if (it == m_prefetched.end() || it.value() != 0) {
+        return; // Rafraîchissement planifié, pas un préchargement
+    }
+
+    it.value() = QDateTime::currentMSecsSinceEpoch();
+    m_stats.completed++;
+    emit statsChanged(m_stats);
+}
+
+void WeatherPrefetcher::onBackgroundRefreshFailed(const QString& cityName, const QString& dataType)
+{
+    // Préchargement en échec : ne plus attendre de remplissage
+    auto it = m_prefetched.find(entryKey(cityName, dataType));
+    if (it != m_prefetched.end() && it.value() == 0) {
+        m_prefetched.erase(it);
+    }
+}
+
+void WeatherPrefetcher::onCacheHit(const QString& cityName, const QString& dataType)
+{
+    auto it = m_prefetched.find(entryKey(cityName, dataType));
+    if (it == m_prefetched.end() || it.value() == 0) {
+        return;
+    }
+
+    // Premier accès à une entrée préchargée : succès attribuable
+    m_prefetched.erase(it);
+    m_stats.attributableHits++;
+    emit statsChanged(m_stats);
+}
+
+QString WeatherPrefetcher::entryKey(const QString& cityName, const QString& dataType) const
+{
+    // Même clé que le cache : "Paris" préchargé puis "paris,fr" consulté = un succès
+    return m_weatherService->cityKey(cityName).toString() + '|' + dataType;
+}
+
+void WeatherPrefetcher::expireStaleEntries()
+{
+    // Une entrée préchargée non consultée avant la durée de validité
+    // maximale du cache (2h) est comptée comme gaspillée
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const qint64 maxAgeMs = 120 * 60 * 1000;
+
+    auto it = m_prefetched.begin();
+    while (it != m_prefetched.end()) {
+        if (it.value() != 0 && now - it.value() > maxAgeMs) {
+            m_stats.wasted++;
+            it = m_prefetched.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
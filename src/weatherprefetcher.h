@@ -0,0 +1,83 @@
+#ifndef WEATHERPREFETCHER_H
+#define WEATHERPREFETCHER_H
+
+#include <QObject>
+#include <QStringList>
+#include <QHash>
+#include <QTimer>
+
+class WeatherService;
+class SearchHistory;
+
+/**
+ * Statistiques de préchargement
+ */
+struct PrefetchStats {
+    int issued = 0;             // Villes préchargées (au moins une requête)
+    int completed = 0;          // Entrées de cache remplies par préchargement
+    int attributableHits = 0;   // Recherches servies grâce au préchargement
+    int wasted = 0;             // Entrées préchargées jamais consultées
+
+    double hitRate() const {
+        return completed > 0 ? double(attributableHits) / completed : 0.0;
+    }
+};
+
+/**
+ * Préchargement prédictif du cache à partir de l'historique
+ *
+ * Candidats (dans cet ordre, sans doublon, limités à topN) :
+ * - Favoris
+ * - Villes habituellement recherchées à l'heure courante, puis à l'heure suivante
+ * - Villes les plus recherchées (getFrequentSearches)
+ *
+ * Les requêtes sont espacées (une ville par tick) et passent par
+ * WeatherService::prefetch() qui respecte le budget de requêtes.
+ */
+class WeatherPrefetcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    WeatherPrefetcher(WeatherService* service, SearchHistory* history, QObject* parent = nullptr);
+
+    // Configuration
+    void setTopN(int count);                 // Défaut: 8 villes
+    void setIntervalMinutes(int minutes);    // Défaut: 30 min
+    void setSpacingMs(int ms);               // Délai entre deux villes (défaut: 1500 ms)
+
+    // Démarrage : préchargement immédiat puis périodique
+    void start();
+    void stop();
+    void prefetchNow();
+
+    QStringList selectCandidates() const;
+    PrefetchStats stats() const { return m_stats; }
+
+signals:
+    void statsChanged(const PrefetchStats& stats);
+
+private slots:
+    void onSpacingTick();
+    void onBackgroundRefreshCompleted(const QString& cityName, const QString& dataType);
+    void onBackgroundRefreshFailed(const QString& cityName, const QString& dataType);
+    void onCacheHit(const QString& cityName, const QString& dataType);
+
+private:
+    WeatherService* m_weatherService;
+    SearchHistory* m_history;
+
+    QTimer* m_periodicTimer;
+    QTimer* m_spacingTimer;
+    QStringList m_queue;                     // Villes en attente de préchargement
+
+    int m_topN;
+    PrefetchStats m_stats;
+
+    // "ville|type" → moment du remplissage (0 = requête en cours)
+    QHash<QString, qint64> m_prefetched;
+    QString entryKey(const QString& cityName, const QString& dataType) const;
+    void expireStaleEntries();
+};
+
+#endif // WEATHERPREFETCHER_H
@@ -4,14 +4,22 @@
 #include <QJsonValue>
 #include <QNetworkRequest>
 #include <QTimer>
+#include <algorithm>
+#include <utility>
 
 WeatherService::WeatherService(std::unique_ptr<ICacheManager> cacheManager, QObject* parent)
     : QObject(parent)
     , m_baseUrl("https://api.openweathermap.org/data/2.5")
     , m_requestTimeoutMs(10000)
     , m_networkManager(nullptr)
+    , m_maxRequestsPerMinute(60)
+    , m_interactiveReserve(15)
+    , m_queueTimer(nullptr)
+    , m_backgroundMaxWaitSecs(BACKGROUND_MAX_WAIT_SECS)
     , m_cacheCleanupTimer(nullptr)
     , cacheMgrPtr(std::move(cacheManager))
+    , m_refreshScheduler(nullptr)
+    , m_gazetteer(std::make_unique<CityGazetteer>())
 {
     // Initialisation du gestionnaire réseau
     m_networkManager = new QNetworkAccessManager(this);
@@ -22,6 +30,15 @@ WeatherService::WeatherService(std::unique_ptr<ICacheManager> cacheManager, QObj
     connect(m_cacheCleanupTimer, &QTimer::timeout, this, &WeatherService::onCacheCleanupTimer);
     m_cacheCleanupTimer->start();
 
+    // Rafraîchissement proactif des villes consultées
+    m_refreshScheduler = new RefreshScheduler(this);
+    connect(m_refreshScheduler, &RefreshScheduler::refreshDue, this, &WeatherService::onRefreshDue);
+
+    // File des requêtes d'arrière-plan en attente de budget
+    m_queueTimer = new QTimer(this);
+    m_queueTimer->setSingleShot(true);
+    connect(m_queueTimer, &QTimer::timeout, this, &WeatherService::drainBackgroundQueue);
+
     qDebug() << "WeatherService initialized";
 }
 
@@ -40,11 +57,42 @@ void WeatherService::setApiKey(const QString& apiKey)
     qDebug() << "API Key set";
 }
 
+void WeatherService::setNetworkAccessManager(QNetworkAccessManager* manager)
+{
+    if (!manager || manager == m_networkManager) return;
+
+    if (m_networkManager && m_networkManager->parent() == this) {
+        m_networkManager->deleteLater();
+    }
+    m_networkManager = manager;
+}
+
 bool WeatherService::isApiKeyValid() const
 {
     return !m_apiKey.isEmpty() && m_apiKey.length() > 20;
 }
 
+bool WeatherService::loadGazetteer(const QString& path)
+{
+    return m_gazetteer->open(path);
+}
+
+CityKey WeatherService::cityKey(const QString& cityName) const
+{
+    GazetteerCity city = m_gazetteer->resolve(cityName);
+    if (city.isValid()) {
+        return CityKey::fromId(city.cityId);
+    }
+    // Ville inconnue localement : géocodage côté serveur, saisie normalisée
+    return CityKey(cityName);
+}
+
+QString WeatherService::displayName(const CityKey& key) const
+{
+    auto it = m_displayNames.constFind(key);
+    return it != m_displayNames.cend() ? it.value() : key.toString();
+}
+
 void WeatherService::requestCurrentWeather(const QString& cityName)
 {
     if (cityName.trimmed().isEmpty()) {
@@ -56,33 +104,26 @@ void WeatherService::requestCurrentWeather(const QString& cityName)
         emitErrorSafely(cityName, "Clé API manquante ou invalide", "configuration");
         return;
     }
-    qDebug()<<"Nom de la ville333 : "<<cityName<<"\n";
-    // Vérification cache d'abord
-    if (cacheMgrPtr->isValid(cityName, "weather")) {
-        qDebug() << "Cache hit for" << cityName;
-        emit currentWeatherReady(cityName, m_weatherCache[cityName].weatherData);
+    const CityKey key = cityKey(cityName);
+    m_displayNames[key] = cityName;
+    m_refreshScheduler->markViewed(key);
+
+    // Vérification cache d'abord (une recherche, aucune copie)
+    if (CurrentWeatherPtr cached = cacheMgrPtr->tryGetWeather(key)) {
+        qDebug() << "Cache hit for" << cityName << "(" << key.toString() << ")";
+        scheduleRefresh(key, WeatherDataType::Weather);
+        emit cacheHit(cityName, "weather");
+        emit currentWeatherReady(cityName, cached);
         return;
     }
 
     // Cache manquant/expiré → appel API
-    qDebug() << "Cache miss for" << cityName << "- calling API";
+    qDebug() << "Cache miss for" << cityName << "(" << key.toString() << ") - calling API";
     emit loadingStarted(cityName, "weather");
 
-    QUrl url = buildWeatherUrl(cityName);
-    QNetworkRequest request(url);
-    request.setRawHeader("User-Agent", "WeatherApp/1.0");
-    request.setTransferTimeout(m_requestTimeoutMs);
-
-    QNetworkReply* reply = m_networkManager->get(request);
-
-    // Enregistrement de la requête
-    m_pendingRequests[reply] = cityName;
-    m_requestTypes[reply] = "weather";
-
-    // Connexions pour cette requête
-    connect(reply, &QNetworkReply::finished, this, &WeatherService::onCurrentWeatherReceived);
-    connect(reply, QOverload<QNetworkReply::NetworkError>::of(&QNetworkReply::errorOccurred),
-            this, &WeatherService::onNetworkError);
+    if (!isRequestPending(key, WeatherDataType::Weather)) {
+        sendRequest(key, WeatherDataType::Weather, false);
+    }
 }
 
 void WeatherService::requestForecast(const QString& cityName)
@@ -97,41 +138,339 @@ void WeatherService::requestForecast(const QString& cityName)
         return;
     }
 
+    const CityKey key = cityKey(cityName);
+    m_displayNames[key] = cityName;
+    m_refreshScheduler->markViewed(key);
+
     // Vérification cache forecast
-    if (isCacheValid(cityName, "forecast")) {
-        qDebug() << "Forecast cache hit for" << cityName;
-        emit forecastReady(cityName, m_forecastCache[cityName].forecastData);
+    if (ForecastPtr cached = cacheMgrPtr->tryGetForecast(key)) {
+        qDebug() << "Forecast cache hit for" << cityName << "(" << key.toString() << ")";
+        scheduleRefresh(key, WeatherDataType::Forecast);
+        emit cacheHit(cityName, "forecast");
+        emit forecastReady(cityName, cached);
         return;
     }
 
-    qDebug() << "Forecast cache miss for" << cityName << "- calling API";
+    qDebug() << "Forecast cache miss for" << cityName << "(" << key.toString() << ") - calling API";
     emit loadingStarted(cityName, "forecast");
 
-    QUrl url = buildForecastUrl(cityName);
+    if (!isRequestPending(key, WeatherDataType::Forecast)) {
+        sendRequest(key, WeatherDataType::Forecast, false);
+    }
+}
+
+void WeatherService::refreshWeatherData(const QString& cityName)
+{
+    if (cityName.trimmed().isEmpty() || !isApiKeyValid()) {
+        return;
+    }
+
+    const CityKey key = cityKey(cityName);
+    m_displayNames[key] = cityName;
+    m_refreshScheduler->markViewed(key);
+    for (WeatherDataType dataType : {WeatherDataType::Weather, WeatherDataType::Forecast}) {
+        if (!isRequestPending(key, dataType)) {
+            emit loadingStarted(cityName, dataTypeName(dataType));
+            sendRequest(key, dataType, false);
+        }
+    }
+}
+
+QList<WeatherDataType> WeatherService::prefetch(const QString& cityName)
+{
+    QList<WeatherDataType> issued;
+    if (cityName.trimmed().isEmpty() || !isApiKeyValid()) {
+        return issued;
+    }
+
+    const CityKey key = cityKey(cityName);
+    if (!m_displayNames.contains(key)) {
+        m_displayNames.insert(key, cityName);
+    }
+
+    for (WeatherDataType dataType : {WeatherDataType::Weather, WeatherDataType::Forecast}) {
+        if (cacheMgrPtr->isValid(key, dataType) || isRequestPending(key, dataType)) {
+            continue;
+        }
+        // Priorité basse : jamais en dessous de la moitié du budget
+        if (remainingRequestBudget() <= m_maxRequestsPerMinute / 2) {
+            break;
+        }
+        sendRequest(key, dataType, true);
+        issued.append(dataType);
+    }
+    return issued;
+}
+
+void WeatherService::onRefreshDue(const CityKey& key, WeatherDataType dataType)
+{
+    if (!isApiKeyValid() || isRequestPending(key, dataType)) {
+        return;
+    }
+
+    // Passage par la file : les villes à l'écran sont servies en premier
+    enqueueBackground(key, dataType, true);
+    drainBackgroundQueue();
+}
+
+// =====================================================
+// PRIORITÉ AUX VILLES VISIBLES
+// =====================================================
+
+void WeatherService::setVisibleCities(const QString& viewId, const QStringList& cityNames)
+{
+    QSet<CityKey> keys;
+    keys.reserve(cityNames.size());
+    for (const QString& cityName : cityNames) {
+        if (cityName.trimmed().isEmpty()) continue;
+        const CityKey key = cityKey(cityName);
+        keys.insert(key);
+        if (!m_displayNames.contains(key)) {
+            m_displayNames.insert(key, cityName);
+        }
+    }
+
+    const QSet<CityKey> previous = m_visibleByView.value(viewId);
+    if (keys == previous) return;
+    if (keys.isEmpty()) {
+        m_visibleByView.remove(viewId);
+    } else {
+        m_visibleByView.insert(viewId, keys);
+    }
+
+    m_visibleKeys.clear();
+    for (auto it = m_visibleByView.cbegin(); it != m_visibleByView.cend(); ++it) {
+        m_visibleKeys.unite(it.value());
+    }
+
+    // Villes nouvellement affichées : entrées en cache mais expirées relancées
+    if (isApiKeyValid()) {
+        for (const CityKey& key : keys) {
+            if (previous.contains(key)) continue;
+            for (WeatherDataType dataType : {WeatherDataType::Weather, WeatherDataType::Forecast}) {
+                const CacheInfo info = cacheMgrPtr->getCacheInfo(key, dataType);
+                if (info.cachedAt.isValid() && !info.isValid()) {
+                    enqueueBackground(key, dataType, false);
+                }
+            }
+        }
+    }
+    drainBackgroundQueue();
+}
+
+bool WeatherService::isCityVisible(const QString& cityName) const
+{
+    return m_visibleKeys.contains(cityKey(cityName));
+}
+
+void WeatherService::enqueueBackground(const CityKey& key, WeatherDataType dataType, bool scheduled)
+{
+    for (QueuedRequest& queued : m_backgroundQueue) {
+        if (queued.key == key && queued.dataType == dataType) {
+            queued.scheduled = queued.scheduled || scheduled;
+            return;
+        }
+    }
+    m_backgroundQueue.append({key, dataType, QDateTime::currentMSecsSinceEpoch(), scheduled});
+}
+
+bool WeatherService::isQueueEntryObsolete(const QueuedRequest& request) const
+{
+    if (isRequestPending(request.key, request.dataType)) {
+        return true;
+    }
+    // Entrée rafraîchie depuis la mise en file (recherche de l'utilisateur...)
+    const CacheInfo info = cacheMgrPtr->getCacheInfo(request.key, request.dataType);
+    if (info.cachedAt.isValid() && info.cachedAt.toMSecsSinceEpoch() >= request.queuedAt) {
+        return true;
+    }
+    // Relance d'une ville qui n'est plus à l'écran : inutile
+    return !request.scheduled && !m_visibleKeys.contains(request.key);
+}
+
+void WeatherService::drainBackgroundQueue()
+{
+    m_queueTimer->stop();
+    if (m_backgroundQueue.isEmpty()) return;
+
+    // Villes visibles en tête, ordre d'arrivée conservé dans chaque groupe
+    std::stable_partition(m_backgroundQueue.begin(), m_backgroundQueue.end(),
+                          [this](const QueuedRequest& request) {
+                              return m_visibleKeys.contains(request.key);
+                          });
+
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const int offscreenFloor = m_maxRequestsPerMinute / 2;
+    QList<QueuedRequest> waiting;
+    for (const QueuedRequest& request : std::as_const(m_backgroundQueue)) {
+        if (!isApiKeyValid() || isQueueEntryObsolete(request)) {
+            continue;
+        }
+
+        // À l'écran : jusqu'à la réserve interactive ; hors écran : moitié haute seulement
+        const bool visible = m_visibleKeys.contains(request.key);
+        if (remainingRequestBudget() > (visible ? m_interactiveReserve : offscreenFloor)) {
+            qDebug() << "Background refresh for" << displayName(request.key)
+                     << "(" << dataTypeName(request.dataType) << ")" << (visible ? "[visible]" : "");
+            sendRequest(request.key, request.dataType, true);
+            continue;
+        }
+
+        // Budget serré trop longtemps pour une ville hors écran : abandon
+        if (!visible && now - request.queuedAt > qint64(m_backgroundMaxWaitSecs) * 1000) {
+            qDebug() << "Refresh of" << displayName(request.key) << dataTypeName(request.dataType)
+                     << "dropped - off screen and request budget low";
+            if (request.scheduled) {
+                m_refreshScheduler->postpone(request.key, request.dataType, m_backgroundMaxWaitSecs);
+            }
+            continue;
+        }
+        waiting.append(request);
+    }
+
+    m_backgroundQueue = waiting;
+    if (!m_backgroundQueue.isEmpty()) {
+        m_queueTimer->start(msUntilBudgetFrees());
+    }
+}
+
+void WeatherService::setBackgroundMaxWait(int seconds)
+{
+    m_backgroundMaxWaitSecs = qMax(0, seconds);
+}
+
+int WeatherService::msUntilBudgetFrees() const
+{
+    // Le plus ancien envoi de la fenêtre libère une place en sortant
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    for (qint64 sentAt : m_requestTimestamps) {
+        if (now - sentAt <= 60 * 1000) {
+            return int(qBound<qint64>(1000, sentAt + 60 * 1000 - now + 50, 60 * 1000));
+        }
+    }
+    return 1000;
+}
+
+void WeatherService::scheduleRefresh(const CityKey& key, WeatherDataType dataType)
+{
+    m_refreshScheduler->scheduleRefresh(key, dataType, cacheMgrPtr->getCacheInfo(key, dataType));
+}
+
+QNetworkReply* WeatherService::sendRequest(const CityKey& key, WeatherDataType dataType, bool background)
+{
+    const bool isForecast = dataType == WeatherDataType::Forecast;
+    QUrl url = isForecast ? buildForecastUrl(key) : buildWeatherUrl(key);
     QNetworkRequest request(url);
     request.setRawHeader("User-Agent", "WeatherApp/1.0");
     request.setTransferTimeout(m_requestTimeoutMs);
 
     QNetworkReply* reply = m_networkManager->get(request);
+    recordRequest();
 
-    m_pendingRequests[reply] = cityName;
-    m_requestTypes[reply] = "forecast";
+    // Enregistrement de la requête
+    m_pendingRequests[reply] = key;
+    m_requestTypes[reply] = dataType;
+    if (background) {
+        m_backgroundRequests.insert(reply);
+    }
 
-    connect(reply, &QNetworkReply::finished, this, &WeatherService::onForecastReceived);
+    // Connexions pour cette requête
+    if (isForecast) {
+        connect(reply, &QNetworkReply::finished, this, &WeatherService::onForecastReceived);
+    } else {
+        connect(reply, &QNetworkReply::finished, this, &WeatherService::onCurrentWeatherReceived);
+    }
     connect(reply, QOverload<QNetworkReply::NetworkError>::of(&QNetworkReply::errorOccurred),
             this, &WeatherService::onNetworkError);
+    return reply;
+}
+
+bool WeatherService::isRequestPending(const CityKey& key, WeatherDataType dataType) const
+{
+    for (auto it = m_pendingRequests.cbegin(); it != m_pendingRequests.cend(); ++it) {
+        if (it.value() == key && m_requestTypes.value(it.key()) == dataType) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WeatherService::recordRequest()
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    m_requestTimestamps.append(now);
+    while (!m_requestTimestamps.isEmpty() && now - m_requestTimestamps.first() > 60 * 1000) {
+        m_requestTimestamps.removeFirst();
+    }
+}
+
+void WeatherService::setMaxRequestsPerMinute(int maxRequests)
+{
+    m_maxRequestsPerMinute = qMax(1, maxRequests);
+    m_interactiveReserve = m_maxRequestsPerMinute / 4;
+}
+
+int WeatherService::remainingRequestBudget() const
+{
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    int used = 0;
+    for (qint64 sentAt : m_requestTimestamps) {
+        if (now - sentAt <= 60 * 1000) ++used;
+    }
+    return qMax(0, m_maxRequestsPerMinute - used);
+}
+
+int WeatherService::getCacheAge(const QString& cityName) const
+{
+    CacheInfo info = cacheMgrPtr->getCacheInfo(cityKey(cityName), WeatherDataType::Weather);
+    return info.cachedAt.isValid() ? qAbs(info.ageMinutes()) : -1;
+}
+
+QStringList WeatherService::getCachedCities() const
+{
+    QStringList cities;
+    const QList<CityKey> keys = cacheMgrPtr->cachedKeys();
+    cities.reserve(keys.size());
+    for (const CityKey& key : keys) {
+        cities.append(displayName(key));
+    }
+    return cities;
+}
+
+QStringList WeatherService::nearestCachedCities(double latitude, double longitude, int count,
+                                                double maxDistanceKm) const
+{
+    QStringList cities;
+    const QList<CityKey> keys = cacheMgrPtr->nearestCities(latitude, longitude, count, maxDistanceKm);
+    cities.reserve(keys.size());
+    for (const CityKey& key : keys) {
+        cities.append(displayName(key));
+    }
+    return cities;
 }
 
 bool WeatherService::hasValidCache(const QString& cityName) const
 {
-    return isCacheValid(cityName, "weather");
+    return cacheMgrPtr->isValid(cityKey(cityName), WeatherDataType::Weather);
+}
+
+DerivedMetricsPtr WeatherService::derivedMetrics(const QString& cityName) const
+{
+    return cacheMgrPtr->derivedMetrics(cityKey(cityName));
+}
+
+QByteArray WeatherService::getRawPayload(const QString& cityName, const QString& dataType) const
+{
+    const CityKey key = cityKey(cityName);
+    if (dataTypeFromName(dataType) == WeatherDataType::Forecast) {
+        return cacheMgrPtr->getRawForecastPayload(key);
+    }
+    return cacheMgrPtr->getRawWeatherPayload(key);
 }
 
 void WeatherService::clearCache()
 {
-    int count = m_weatherCache.size() + m_forecastCache.size();
-    m_weatherCache.clear();
-    m_forecastCache.clear();
+    int count = cacheMgrPtr->clear();
     emit cacheCleanedUp(count);
     qDebug() << "Cache cleared -" << count << "entries removed";
 }
@@ -143,11 +482,12 @@ void WeatherService::onCurrentWeatherReceived()
         return;
     }
 
-    QString cityName = m_pendingRequests[reply];
+    const CityKey key = m_pendingRequests[reply];
+    const QString cityName = displayName(key);
+    const bool background = m_backgroundRequests.contains(reply);
 
     if (reply->error() != QNetworkReply::NoError) {
-        emitErrorSafely(cityName, getErrorMessage(reply->error()), "network");
-        cleanupRequest(reply);
+        failRequest(reply, getErrorMessage(reply->error()), "network");
         return;
     }
 
@@ -155,8 +495,7 @@ void WeatherService::onCurrentWeatherReceived()
     QJsonDocument doc = QJsonDocument::fromJson(data);
 
     if (doc.isNull()) {
-        emitErrorSafely(cityName, "Réponse API invalide", "parsing");
-        cleanupRequest(reply);
+        failRequest(reply, "Réponse API invalide", "parsing");
         return;
     }
 
@@ -165,23 +504,28 @@ void WeatherService::onCurrentWeatherReceived()
     // Vérification erreur API
     if (json.contains("cod") && json["cod"].toInt() != 200) {
         QString apiError = getApiErrorMessage(json);
-        emitErrorSafely(cityName, apiError, "api");
-        cleanupRequest(reply);
+        failRequest(reply, apiError, "api");
         return;
     }
 
     // Parsing des données
-    CurrentWeatherData weatherData = parseCurrentWeatherJson(json);
+    CurrentWeatherData weatherData = WeatherJsonParser::parseCurrentWeather(json);
 
     if (!weatherData.isValid()) {
-        emitErrorSafely(cityName, "Données météo invalides", "validation");
-        cleanupRequest(reply);
+        failRequest(reply, "Données météo invalides", "validation");
         return;
     }
 
-    // Mise en cache et émission signal
-    cacheMgrPtr->storeCachedWeather(cityName, weatherData);
-    emit currentWeatherReady(cityName, weatherData);
+    // Mise en cache et émission signal : le cache et les abonnés partagent la même instance
+    CurrentWeatherPtr shared = std::make_shared<const CurrentWeatherData>(std::move(weatherData));
+    cacheMgrPtr->storeCachedWeather(key, shared, data);
+    scheduleRefresh(key, WeatherDataType::Weather);
+    if (background) {
+        m_backgroundRequests.remove(reply);
+        emit backgroundRefreshCompleted(cityName, "weather");
+    } else {
+        emit currentWeatherReady(cityName, shared);
+    }
     emit cacheUpdated(cityName, "weather");
 
     qDebug() << "Weather data received and cached for" << cityName;
@@ -195,11 +539,12 @@ void WeatherService::onForecastReceived()
         return;
     }
 
-    QString cityName = m_pendingRequests[reply];
+    const CityKey key = m_pendingRequests[reply];
+    const QString cityName = displayName(key);
+    const bool background = m_backgroundRequests.contains(reply);
 
     if (reply->error() != QNetworkReply::NoError) {
-        emitErrorSafely(cityName, getErrorMessage(reply->error()), "network");
-        cleanupRequest(reply);
+        failRequest(reply, getErrorMessage(reply->error()), "network");
         return;
     }
 
@@ -207,23 +552,28 @@ void WeatherService::onForecastReceived()
     QJsonDocument doc = QJsonDocument::fromJson(data);
 
     if (doc.isNull()) {
-        emitErrorSafely(cityName, "Réponse API forecast invalide", "parsing");
-        cleanupRequest(reply);
+        failRequest(reply, "Réponse API forecast invalide", "parsing");
         return;
     }
 
     QJsonObject json = doc.object();
 
-    ForecastData forecastData = parseForecastJson(json);
+    ForecastData forecastData = WeatherJsonParser::parseForecast(json, &m_parseArena);
 
     if (!forecastData.isValid()) {
-        emitErrorSafely(cityName, "Données prévisions invalides", "validation");
-        cleanupRequest(reply);
+        failRequest(reply, "Données prévisions invalides", "validation");
         return;
     }
 
-    cacheMgrPtr->storeCachedForecast(cityName, forecastData);
-    emit forecastReady(cityName, forecastData);
+    ForecastPtr shared = std::make_shared<const ForecastData>(std::move(forecastData));
+    cacheMgrPtr->storeCachedForecast(key, shared, data);
+    scheduleRefresh(key, WeatherDataType::Forecast);
+    if (background) {
+        m_backgroundRequests.remove(reply);
+        emit backgroundRefreshCompleted(cityName, "forecast");
+    } else {
+        emit forecastReady(cityName, shared);
+    }
     emit cacheUpdated(cityName, "forecast");
 
     qDebug() << "Forecast data received and cached for" << cityName;
@@ -235,208 +585,37 @@ void WeatherService::onNetworkError(QNetworkReply::NetworkError error)
     QNetworkReply* reply = qobject_cast<QNetworkReply*>(sender());
     if (!reply) return;
 
-    QString cityName = m_pendingRequests.value(reply, "Unknown");
-    emitErrorSafely(cityName, getErrorMessage(error), "network");
-    cleanupRequest(reply);
+    failRequest(reply, getErrorMessage(error), "network");
 }
 
-QUrl WeatherService::buildWeatherUrl(const QString& cityName) const
+QUrl WeatherService::buildWeatherUrl(const CityKey& key) const
 {
     QUrl url(m_baseUrl + "/weather");
-    QUrlQuery query;
-    query.addQueryItem("q", cityName);
-    query.addQueryItem("appid", m_apiKey);
-    query.addQueryItem("units", "metric");
-    query.addQueryItem("lang", "fr");
-    url.setQuery(query);
+    url.setQuery(locationQuery(key));
     return url;
 }
 
-QUrl WeatherService::buildForecastUrl(const QString& cityName) const
+QUrl WeatherService::buildForecastUrl(const CityKey& key) const
 {
     QUrl url(m_baseUrl + "/forecast");
-    QUrlQuery query;
-    query.addQueryItem("q", cityName);
-    query.addQueryItem("appid", m_apiKey);
-    query.addQueryItem("units", "metric");
-    query.addQueryItem("lang", "fr");
-    url.setQuery(query);
+    url.setQuery(locationQuery(key));
     return url;
 }
 
-bool WeatherService::isCacheValid(const QString& cityName, const QString& dataType) const
+QUrlQuery WeatherService::locationQuery(const CityKey& key) const
 {
-    if (dataType == "weather") {
-        return m_weatherCache.contains(cityName) &&
-               m_weatherCache[cityName].cacheInfo.isValid();
-    } else if (dataType == "forecast") {
-        return m_forecastCache.contains(cityName) &&
-               m_forecastCache[cityName].cacheInfo.isValid();
-    }
-    return false;
-}
-
-void WeatherService::storeCachedWeather(const QString& cityName, const CurrentWeatherData& data)
-{
-    CachedWeatherData cached;
-    cached.weatherData = data;
-    cached.cacheInfo.cachedAt = QDateTime::currentDateTime();
-    cached.cacheInfo.validityMinutes = 15; // 15 minutes
-
-    m_weatherCache[cityName] = cached;
-}
-
-void WeatherService::storeCachedForecast(const QString& cityName, const ForecastData& data)
-{
-    CachedForecastData cached;
-    cached.forecastData = data;
-    cached.cacheInfo.cachedAt = QDateTime::currentDateTime();
-    cached.cacheInfo.validityMinutes = 120; // 2 heures
-
-    m_forecastCache[cityName] = cached;
-}
-
-CurrentWeatherData WeatherService::parseCurrentWeatherJson(const QJsonObject& json) const
-{
-    CurrentWeatherData data;
-
-    // Informations ville
-    data.cityName = json["name"].toString();
-    data.cityId = json["id"].toInteger();
-
-    if (json.contains("sys")) {
-        QJsonObject sys = json["sys"].toObject();
-        data.countryCode = sys["country"].toString();
-    }
-
-    // Coordonnées
-    if (json.contains("coord")) {
-        QJsonObject coord = json["coord"].toObject();
-        data.latitude = coord["lat"].toDouble();
-        data.longitude = coord["lon"].toDouble();
-    }
-
-    // Données principales
-    if (json.contains("main")) {
-        QJsonObject main = json["main"].toObject();
-        data.temperature = main["temp"].toDouble();
-        data.feelsLike = main["feels_like"].toDouble();
-        data.temperatureMin = main["temp_min"].toDouble();
-        data.temperatureMax = main["temp_max"].toDouble();
-        data.humidity = main["humidity"].toDouble();
-        data.pressure = main["pressure"].toDouble();
-    }
-
-    // Conditions météo
-    if (json.contains("weather") && json["weather"].isArray()) {
-        QJsonArray weather = json["weather"].toArray();
-        if (!weather.isEmpty()) {
-            QJsonObject weatherObj = weather[0].toObject();
-            data.mainCondition = weatherObj["main"].toString();
-            data.description = weatherObj["description"].toString();
-            data.iconCode = weatherObj["icon"].toString();
-            data.conditionId = weatherObj["id"].toInt();
-        }
-    }
-
-    // Vent
-    if (json.contains("wind")) {
-        QJsonObject wind = json["wind"].toObject();
-        data.windSpeed = wind["speed"].toDouble();
-        data.windDirection = wind["deg"].toInt();
-    }
-
-    // Autres
-    data.visibility = json["visibility"].toDouble();
-    if (json.contains("clouds")) {
-        data.cloudiness = json["clouds"].toObject()["all"].toInt();
-    }
-
-    // Timestamp
-    data.timestamp = QDateTime::fromSecsSinceEpoch(json["dt"].toInteger());
-
-    return data;
-}
-
-ForecastData WeatherService::parseForecastJson(const QJsonObject& json) const
-{
-    ForecastData data;
-
-    // Informations ville
-    if (json.contains("city")) {
-        QJsonObject city = json["city"].toObject();
-        data.cityName = city["name"].toString();
-
-        if (city.contains("coord")) {
-            QJsonObject coord = city["coord"].toObject();
-            data.latitude = coord["lat"].toDouble();
-            data.longitude = coord["lon"].toDouble();
-        }
-    }
-
-    // Parsing des entrées
-    if (json.contains("list") && json["list"].isArray()) {
-        QJsonArray list = json["list"].toArray();
-
-        for (const QJsonValue& value : list) {
-            QJsonObject entryJson = value.toObject();
-            ForecastEntry entry = parseForecastEntry(entryJson);
-            data.entries.append(entry);
-        }
-    }
-
-    data.retrievedAt = QDateTime::currentDateTime();
-    return data;
-}
-
-ForecastEntry WeatherService::parseForecastEntry(const QJsonObject& entryJson) const
-{
-    ForecastEntry entry;
-
-    // Timestamp
-    entry.dateTime = QDateTime::fromString(entryJson["dt_txt"].toString(),
-                                           "yyyy-MM-dd hh:mm:ss");
-
-    // Données principales
-    if (entryJson.contains("main")) {
-        QJsonObject main = entryJson["main"].toObject();
-        entry.temperature = main["temp"].toDouble();
-        entry.feelsLike = main["feels_like"].toDouble();
-        entry.humidity = main["humidity"].toDouble();
-        entry.pressure = main["pressure"].toDouble();
-    }
-
-    // Conditions météo
-    if (entryJson.contains("weather") && entryJson["weather"].isArray()) {
-        QJsonArray weather = entryJson["weather"].toArray();
-        if (!weather.isEmpty()) {
-            QJsonObject weatherObj = weather[0].toObject();
-            entry.mainCondition = weatherObj["main"].toString();
-            entry.description = weatherObj["description"].toString();
-            entry.iconCode = weatherObj["icon"].toString();
-            entry.conditionId = weatherObj["id"].toInt();
-        }
-    }
-
-    // Vent
-    if (entryJson.contains("wind")) {
-        QJsonObject wind = entryJson["wind"].toObject();
-        entry.windSpeed = wind["speed"].toDouble();
-        entry.windDirection = wind["deg"].toInt();
-        if (wind.contains("gust")) {
-            entry.windGust = wind["gust"].toDouble();
-        }
-    }
-
-    // Nuages
-    if (entryJson.contains("clouds")) {
-        entry.cloudiness = entryJson["clouds"].toObject()["all"].toInt();
+    // Identifiant résolu localement : pas de géocodage ni d'ambiguïté côté serveur.
+    // Sinon la saisie d'origine (accents, casse) : la clé normalisée géocode moins bien
+    QUrlQuery query;
+    if (key.isId()) {
+        query.addQueryItem("id", key.toString());
+    } else {
+        query.addQueryItem("q", displayName(key).trimmed());
     }
-
-    // Probabilité précipitations
-    entry.precipitationProbability = entryJson["pop"].toDouble() * 100; // 0.0-1.0 → 0-100%
-
-    return entry;
+    query.addQueryItem("appid", m_apiKey);
+    query.addQueryItem("units", "metric");
+    query.addQueryItem("lang", "fr");
+    return query;
 }
 
 QString WeatherService::getErrorMessage(QNetworkReply::NetworkError error) const
@@ -478,13 +657,36 @@ QString WeatherService::getApiErrorMessage(const QJsonObject& json) const
     }
 }
 
+void WeatherService::failRequest(QNetworkReply* reply, const QString& message, const QString& type)
+{
+    const CityKey key = m_pendingRequests.value(reply);
+    if (m_backgroundRequests.contains(reply)) {
+        // Rafraîchissement en tâche de fond : rien à montrer, nouvel essai dans 5 min
+        qDebug() << "Background refresh failed for" << displayName(key) << type << message;
+        m_refreshScheduler->postpone(key, m_requestTypes.value(reply), 5 * 60);
+    } else {
+        emitErrorSafely(displayName(key), message, type);
+    }
+    cleanupRequest(reply);
+}
+
 void WeatherService::cleanupRequest(QNetworkReply* reply)
 {
     if (!reply) return;
 
-    m_pendingRequests.remove(reply);
-    m_requestTypes.remove(reply);
+    const CityKey key = m_pendingRequests.take(reply);
+    const WeatherDataType dataType = m_requestTypes.take(reply);
     reply->deleteLater();
+
+    // Requête d'arrière-plan encore marquée : elle n'a pas abouti
+    if (m_backgroundRequests.remove(reply)) {
+        emit backgroundRefreshFailed(displayName(key), dataTypeName(dataType));
+    }
+
+    // Fin du lot (plus aucune réponse attendue) : temporaires de parsing rendus d'un coup
+    if (m_pendingRequests.isEmpty()) {
+        m_parseArena.release();
+    }
 }
 
 void WeatherService::emitErrorSafely(const QString& cityName, const QString& message, const QString& type)
@@ -495,7 +697,11 @@ void WeatherService::emitErrorSafely(const QString& cityName, const QString& mes
 
 void WeatherService::onCacheCleanupTimer()
 {
-    cacheMgrPtr->cleanExpiredCache();
+    // Les vues multi-villes relisent le cache après un nettoyage effectif
+    const int removed = cacheMgrPtr->cleanExpiredCache();
+    if (removed > 0) {
+        emit cacheCleanedUp(removed);
+    }
 }
 
 
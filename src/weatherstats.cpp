@@ -0,0 +1,340 @@
+#include "weatherstats.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define WEATHERSTATS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define WEATHERSTATS_TARGET_SSE2
+#define WEATHERSTATS_TARGET_AVX2
+#else
+// Seules ces fonctions sont compilées pour SSE2/AVX2 : le reste du binaire reste portable
+// (SSE2 n'est pas implicite en 32 bits sans -msse2)
+#define WEATHERSTATS_TARGET_SSE2 __attribute__((target("sse2")))
+#define WEATHERSTATS_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace WeatherStats {
+
+namespace {
+
+// =====================================================
+// NOYAUX SCALAIRES (référence, toutes plateformes)
+// =====================================================
+
+Range minMaxScalar(const double* values, qsizetype count)
+{
+    Range range{values[0], values[0]};
+    for (qsizetype i = 1; i < count; ++i) {
+        range.min = std::min(range.min, values[i]);
+        range.max = std::max(range.max, values[i]);
+    }
+    return range;
+}
+
+double sumScalar(const double* values, qsizetype count)
+{
+    double total = 0.0;
+    for (qsizetype i = 0; i < count; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+#ifdef WEATHERSTATS_X86
+
+// =====================================================
+// NOYAUX SSE2 (2 doubles par registre)
+// =====================================================
+
+WEATHERSTATS_TARGET_SSE2 Range minMaxSse2(const double* values, qsizetype count)
+{
+    __m128d lo = _mm_set1_pd(values[0]);
+    __m128d hi = lo;
+    qsizetype i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128d x = _mm_loadu_pd(values + i);
+        lo = _mm_min_pd(lo, x);
+        hi = _mm_max_pd(hi, x);
+    }
+
+    alignas(16) double l[2];
+    alignas(16) double h[2];
+    _mm_store_pd(l, lo);
+    _mm_store_pd(h, hi);
+    Range range{std::min(l[0], l[1]), std::max(h[0], h[1])};
+    for (; i < count; ++i) {
+        range.min = std::min(range.min, values[i]);
+        range.max = std::max(range.max, values[i]);
+    }
+    return range;
+}
+
+WEATHERSTATS_TARGET_SSE2 double sumSse2(const double* values, qsizetype count)
+{
+    // Deux accumulateurs : masque la latence de l'addition
+    __m128d acc0 = _mm_setzero_pd();
+    __m128d acc1 = _mm_setzero_pd();
+    qsizetype i = 0;
+    for (; i + 4 <= count; i += 4) {
+        acc0 = _mm_add_pd(acc0, _mm_loadu_pd(values + i));
+        acc1 = _mm_add_pd(acc1, _mm_loadu_pd(values + i + 2));
+    }
+
+    alignas(16) double lanes[2];
+    _mm_store_pd(lanes, _mm_add_pd(acc0, acc1));
+    double total = lanes[0] + lanes[1];
+    for (; i < count; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+// =====================================================
+// NOYAUX AVX2 (4 doubles par registre)
+// =====================================================
+
+WEATHERSTATS_TARGET_AVX2 Range minMaxAvx2(const double* values, qsizetype count)
+{
+    __m256d lo0 = _mm256_set1_pd(values[0]);
+    __m256d hi0 = lo0;
+    __m256d lo1 = lo0;
+    __m256d hi1 = lo0;
+    qsizetype i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256d a = _mm256_loadu_pd(values + i);
+        __m256d b = _mm256_loadu_pd(values + i + 4);
+        lo0 = _mm256_min_pd(lo0, a);
+        hi0 = _mm256_max_pd(hi0, a);
+        lo1 = _mm256_min_pd(lo1, b);
+        hi1 = _mm256_max_pd(hi1, b);
+    }
+
+    alignas(32) double l[4];
+    alignas(32) double h[4];
+    _mm256_store_pd(l, _mm256_min_pd(lo0, lo1));
+    _mm256_store_pd(h, _mm256_max_pd(hi0, hi1));
+    Range range{std::min(std::min(l[0], l[1]), std::min(l[2], l[3])),
+                std::max(std::max(h[0], h[1]), std::max(h[2], h[3]))};
+    for (; i < count; ++i) {
+        range.min = std::min(range.min, values[i]);
+        range.max = std::max(range.max, values[i]);
+    }
+    return range;
+}
+
+WEATHERSTATS_TARGET_AVX2 double sumAvx2(const double* values, qsizetype count)
+{
+    __m256d acc0 = _mm256_setzero_pd();
+    __m256d acc1 = _mm256_setzero_pd();
+    qsizetype i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc0 = _mm256_add_pd(acc0, _mm256_loadu_pd(values + i));
+        acc1 = _mm256_add_pd(acc1, _mm256_loadu_pd(values + i + 4));
+    }
+
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, _mm256_add_pd(acc0, acc1));
+    double total = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < count; ++i) {
+        total += values[i];
+    }
+    return total;
+}
+
+// =====================================================
+// DÉTECTION PROCESSEUR
+// =====================================================
+
+bool cpuHasSse2()
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    return true; // Garanti par l'ABI x86-64
+#elif defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+bool cpuHasAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+
+    // AVX activé par le système (registres YMM sauvegardés) + AVX2 présent
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // WEATHERSTATS_X86
+
+// =====================================================
+// TABLE DE DISPATCH
+// =====================================================
+
+struct Kernels {
+    Range (*minMax)(const double*, qsizetype);
+    double (*sum)(const double*, qsizetype);
+};
+
+Kernels kernelsFor(Backend backend)
+{
+#ifdef WEATHERSTATS_X86
+    switch (backend) {
+    case Backend::AVX2:
+        return {minMaxAvx2, sumAvx2};
+    case Backend::SSE2:
+        return {minMaxSse2, sumSse2};
+    case Backend::Scalar:
+        break;
+    }
+#else
+    Q_UNUSED(backend);
+#endif
+    return {minMaxScalar, sumScalar};
+}
+
+Backend detectBackend()
+{
+#ifdef WEATHERSTATS_X86
+    if (cpuHasAvx2()) return Backend::AVX2;
+    if (cpuHasSse2()) return Backend::SSE2;
+#endif
+    return Backend::Scalar;
+}
+
+// Choisi au premier appel ; setBackend() le remplace (lectures concurrentes sûres)
+std::atomic<int>& activeBackendSlot()
+{
+    static std::atomic<int> slot{int(bestAvailableBackend())};
+    return slot;
+}
+
+Kernels activeKernels()
+{
+    return kernelsFor(Backend(activeBackendSlot().load(std::memory_order_relaxed)));
+}
+
+} // namespace
+
+// =====================================================
+// API
+// =====================================================
+
+Range minMax(const double* values, qsizetype count)
+{
+    if (count <= 0) return Range();
+    return activeKernels().minMax(values, count);
+}
+
+double sum(const double* values, qsizetype count)
+{
+    if (count <= 0) return 0.0;
+    return activeKernels().sum(values, count);
+}
+
+double mean(const double* values, qsizetype count)
+{
+    if (count <= 0) return 0.0;
+    return sum(values, count) / double(count);
+}
+
+double percentile(const double* values, qsizetype count, double p)
+{
+    if (count <= 0) return 0.0;
+
+    // Sélection partielle sur une copie : O(n), la série d'origine est intacte
+    std::vector<double> scratch(values, values + count);
+    const double rank = std::clamp(p, 0.0, 100.0) / 100.0 * double(count - 1);
+    const auto lower = qsizetype(std::floor(rank));
+    const double fraction = rank - double(lower);
+
+    std::nth_element(scratch.begin(), scratch.begin() + lower, scratch.end());
+    const double lowerValue = scratch[size_t(lower)];
+    if (fraction == 0.0 || lower + 1 >= count) {
+        return lowerValue;
+    }
+    // Le rang suivant est le minimum de la partie droite
+    const double upperValue = *std::min_element(scratch.begin() + lower + 1, scratch.end());
+    return lowerValue + fraction * (upperValue - lowerValue);
+}
+
+qsizetype movingAverage(const double* values, qsizetype count, int window, double* out)
+{
+    if (window < 1 || window > count) return 0;
+
+    // Somme glissante : une addition et une soustraction par point
+    double windowSum = sum(values, window);
+    out[0] = windowSum / window;
+    for (qsizetype i = window; i < count; ++i) {
+        windowSum += values[i] - values[i - window];
+        out[i - window + 1] = windowSum / window;
+    }
+    return count - window + 1;
+}
+
+QList<double> movingAverage(const QList<double>& values, int window)
+{
+    QList<double> result;
+    if (window < 1 || window > values.size()) return result;
+
+    result.resize(values.size() - window + 1);
+    movingAverage(values.constData(), values.size(), window, result.data());
+    return result;
+}
+
+Backend bestAvailableBackend()
+{
+    static const Backend best = detectBackend();
+    return best;
+}
+
+Backend activeBackend()
+{
+    return Backend(activeBackendSlot().load(std::memory_order_relaxed));
+}
+
+bool isBackendAvailable(Backend backend)
+{
+    return int(backend) <= int(bestAvailableBackend());
+}
+
+bool setBackend(Backend backend)
+{
+    if (!isBackendAvailable(backend)) return false;
+    activeBackendSlot().store(int(backend), std::memory_order_relaxed);
+    return true;
+}
+
+QString backendName(Backend backend)
+{
+    switch (backend) {
+    case Backend::AVX2:
+        return QStringLiteral("AVX2");
+    case Backend::SSE2:
+        return QStringLiteral("SSE2");
+    case Backend::Scalar:
+        break;
+    }
+    return QStringLiteral("scalar");
+}
+
+} // namespace WeatherStats
@@ -0,0 +1,68 @@
+#ifndef WEATHERSTATS_H
+#define WEATHERSTATS_H
+
+#include <QString>
+#include <QList>
+#include <QtGlobal>
+
+/**
+ * Statistiques sur des séries de doubles contiguës (températures, humidité...)
+ *
+ * - min/max, somme et moyenne vectorisées : AVX2 ou SSE2 sur x86, boucle
+ *   scalaire ailleurs ; le jeu d'instructions est choisi une fois, à l'exécution
+ * - percentile et moyenne glissante en O(n), sans vectorisation
+ *
+ * Les valeurs NaN ne sont pas prises en charge (résultat non défini).
+ * La somme vectorisée additionne dans un ordre différent de la boucle
+ * scalaire : écart de l'ordre de l'arrondi.
+ */
+namespace WeatherStats {
+
+enum class Backend {
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+struct Range {
+    double min = 0.0;
+    double max = 0.0;
+};
+
+// Série vide : {0, 0}
+Range minMax(const double* values, qsizetype count);
+
+double sum(const double* values, qsizetype count);
+
+// Série vide : 0
+double mean(const double* values, qsizetype count);
+
+/**
+ * Percentile par interpolation linéaire entre rangs (p = 50 → médiane)
+ * @param p Borné à [0, 100]
+ */
+double percentile(const double* values, qsizetype count, double p);
+
+/**
+ * Moyenne glissante sur `window` valeurs
+ * @param out count - window + 1 valeurs (rien si window > count ou window < 1)
+ * @return Nombre de valeurs écrites
+ */
+qsizetype movingAverage(const double* values, qsizetype count, int window, double* out);
+QList<double> movingAverage(const QList<double>& values, int window);
+
+// === CHOIX DU JEU D'INSTRUCTIONS ===
+
+// Meilleur backend supporté par le processeur
+Backend bestAvailableBackend();
+Backend activeBackend();
+bool isBackendAvailable(Backend backend);
+
+// Force un backend (tests, benchmarks) ; false s'il n'est pas disponible
+bool setBackend(Backend backend);
+
+QString backendName(Backend backend);
+
+} // namespace WeatherStats
+
+#endif // WEATHERSTATS_H
@@ -0,0 +1,42 @@
+# tests/benchmarks/benchmarks.pro
+QT += testlib core
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+CONFIG += c++17
+
+TEMPLATE = app
+TARGET = tst_parsebenchmark
+
+# Chemin vers le code source
+INCLUDEPATH += ../../src
+
+# Benchmarks (QBENCHMARK) : lancer en Release, ex. ./tst_parsebenchmark -iterations 50
+SOURCES += \
+    tst_parsebenchmark.cpp
+
+# Code source mesuré
+SOURCES += \
+    ../../src/weatherjsonparser.cpp \
+    ../../src/parsearena.cpp \
+    ../../src/cityspatialindex.cpp \
+    ../../src/weathercachemanager.cpp \
+    ../../src/derivedmetrics.cpp
+
+HEADERS += \
+    ../../src/weatherjsonparser.h \
+    ../../src/cityspatialindex.h \
+    ../../src/weathercachemanager.h \
+    ../../src/ICacheManager.h \
+    ../../src/citykey.h \
+    ../../src/derivedmetrics.h \
+    ../../src/inlinelist.h \
+    ../../src/parsearena.h \
+    ../../src/WeatherData.h
+
+# Définir les mêmes deprecated warnings
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
+
+# Sortie dans un dossier séparé
+DESTDIR = $$OUT_PWD/bin
@@ -0,0 +1,272 @@
+#include <QtTest>
+#include <QJsonDocument>
+#include <QElapsedTimer>
+#include <QFile>
+#include <memory_resource>
+#include "../../src/weatherjsonparser.h"
+#include "../../src/parsearena.h"
+#include "../../src/weathercachemanager.h"
+
+// ===== COMPTAGE DES ALLOCATIONS =====
+// Ressource pmr comptant les blocs demandés par les arenas de parsing ;
+// installée comme ressource par défaut le temps d'une mesure seulement
+namespace {
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    qint64 allocations() const { return m_allocations; }
+    qint64 bytes() const { return m_bytes; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        ++m_allocations;
+        m_bytes += qint64(bytes);
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+    void do_deallocate(void* ptr, size_t bytes, size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    qint64 m_allocations = 0;
+    qint64 m_bytes = 0;
+};
+
+// Ressource par défaut remplacée dans la portée, restaurée à la sortie
+class ScopedDefaultResource
+{
+public:
+    explicit ScopedDefaultResource(std::pmr::memory_resource* resource)
+        : m_previous(std::pmr::set_default_resource(resource)) {}
+    ~ScopedDefaultResource() { std::pmr::set_default_resource(m_previous); }
+
+private:
+    std::pmr::memory_resource* m_previous;
+};
+}
+
+/**
+ * Mesures du parsing et de l'empreinte mémoire des prévisions
+ *
+ * Les fonctions benchmark* utilisent QBENCHMARK (temps par itération) ;
+ * les autres vérifient que les mesures portent sur des données correctes.
+ */
+class TestParseBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    QByteArray m_forecastPayload;
+    QByteArray m_weatherPayload;
+
+    // Réponse /forecast réaliste : `count` créneaux de 3 h
+    static QByteArray forecastJson(int count) {
+        QByteArray list;
+        for (int i = 0; i < count; ++i) {
+            if (i > 0) list += ",";
+            const qint64 dt = 1700000000 + qint64(i) * 10800;
+            list += QString(R"({"dt": %1, "dt_txt": "%2",
+                               "main": {"temp": %3, "feels_like": 15.0, "temp_min": 14.0, "temp_max": 18.0,
+                                        "humidity": %4, "pressure": 1012},
+                               "weather": [{"id": 500, "main": "Rain", "description": "pluie modérée", "icon": "10d"}],
+                               "wind": {"speed": 4.0, "deg": 180, "gust": 7.5}, "clouds": {"all": 75},
+                               "visibility": 10000, "pop": 0.4, "sys": {"pod": "d"}})")
+                        .arg(dt)
+                        .arg(QDateTime::fromSecsSinceEpoch(dt).toUTC().toString("yyyy-MM-dd hh:mm:ss"))
+                        .arg(15.0 + i % 8)
+                        .arg(50 + i % 30)
+                        .toUtf8();
+        }
+        return R"({"cod": "200", "message": 0, "cnt": )" + QByteArray::number(count)
+               + R"(, "city": {"id": 2988507, "name": "Paris", "country": "FR",
+                    "coord": {"lat": 48.8534, "lon": 2.3488}, "timezone": 3600}, "list": [)" + list + "]}";
+    }
+
+    static QByteArray weatherJson() {
+        return R"({"cod": 200, "id": 2988507, "name": "Paris", "dt": 1700000000, "timezone": 3600,
+                   "sys": {"country": "FR", "sunrise": 1699988000, "sunset": 1700022000},
+                   "coord": {"lat": 48.85, "lon": 2.35},
+                   "main": {"temp": 21.5, "feels_like": 20.9, "temp_min": 19.0, "temp_max": 23.0,
+                            "humidity": 55, "pressure": 1015},
+                   "weather": [{"id": 800, "main": "Clear", "description": "ciel dégagé", "icon": "01d"}],
+                   "wind": {"speed": 3.1, "deg": 200}, "clouds": {"all": 0}, "visibility": 10000})";
+    }
+
+    static ForecastData parseForecast(const QByteArray& payload) {
+        return WeatherJsonParser::parseForecast(QJsonDocument::fromJson(payload).object());
+    }
+
+    // Mémoire résidente du processus (Linux), -1 si indisponible
+    static qint64 residentSetBytes() {
+        QFile status("/proc/self/status");
+        if (!status.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            return -1;
+        }
+        while (!status.atEnd()) {
+            QByteArray line = status.readLine();
+            if (line.startsWith("VmRSS:")) {
+                return line.mid(6).simplified().split(' ').first().toLongLong() * 1024;
+            }
+        }
+        return -1;
+    }
+
+private slots:
+    void initTestCase() {
+        m_forecastPayload = forecastJson(FORECAST_INLINE_ENTRIES);
+        m_weatherPayload = weatherJson();
+    }
+
+    // ========================================
+    // VALIDITÉ DES DONNÉES MESURÉES
+    // ========================================
+
+    void testForecastEntriesStayInline() {
+        // ACT
+        ForecastData data = parseForecast(m_forecastPayload);
+
+        // ASSERT : 40 créneaux sans bloc séparé
+        QCOMPARE(data.entries.size(), FORECAST_INLINE_ENTRIES);
+        QVERIFY(data.entries.isInline());
+        QCOMPARE(data.entries.heapBytes(), qint64(0));
+        QCOMPARE(data.cityName, QString("Paris"));
+        QCOMPARE(data.entries.first().mainCondition, QString("Rain"));
+        QCOMPARE(data.entries.last().precipitationProbability, 40.0);
+    }
+
+    void testLongForecastReservesOnce() {
+        // ACT : réponse plus longue que la capacité intégrée
+        ForecastData data = parseForecast(forecastJson(56));
+
+        // ASSERT : repli sur un seul bloc à la taille exacte
+        QCOMPARE(data.entries.size(), 56);
+        QVERIFY(!data.entries.isInline());
+        QCOMPARE(data.entries.capacity(), 56);
+        QCOMPARE(data.entries.at(55).temperature, 15.0 + 55 % 8);
+    }
+
+    void testArenaInternsRepeatedLabels() {
+        // ARRANGE
+        ParseArena arena;
+        QJsonObject json = QJsonDocument::fromJson(m_forecastPayload).object();
+
+        // ACT : deux réponses du même lot
+        ForecastData first = WeatherJsonParser::parseForecast(json, &arena);
+        ForecastData second = WeatherJsonParser::parseForecast(json, &arena);
+        arena.release();
+
+        // ASSERT : un seul exemplaire de chaque libellé, toujours valide après release()
+        QCOMPARE(first.entries.at(0).description.constData(), first.entries.at(39).description.constData());
+        QCOMPARE(first.entries.at(0).iconCode.constData(), second.entries.at(0).iconCode.constData());
+        QCOMPARE(second.entries.at(12).description, QString("pluie modérée"));
+        QCOMPARE(arena.internedCount(), 0);
+    }
+
+    void testEntryTimeFromUtcSeconds() {
+        // ACT
+        ForecastData data = parseForecast(m_forecastPayload);
+
+        // ASSERT : "dt" (UTC) fait foi, indépendamment du fuseau local
+        QCOMPARE(data.entries.at(1).dateTime.toSecsSinceEpoch(), qint64(1700000000 + 10800));
+        QCOMPARE(data.entries.at(1).dateTime.toUTC().toString("yyyy-MM-dd hh:mm:ss"),
+                 QDateTime::fromSecsSinceEpoch(1700000000 + 10800).toUTC().toString("yyyy-MM-dd hh:mm:ss"));
+    }
+
+    // ========================================
+    // BENCHMARKS
+    // ========================================
+
+    void benchmarkParseForecast() {
+        ForecastData data;
+        QBENCHMARK {
+            data = parseForecast(m_forecastPayload);
+        }
+        QCOMPARE(data.entries.size(), FORECAST_INLINE_ENTRIES);
+    }
+
+    void benchmarkParseForecastBatch() {
+        const QList<QByteArray> payloads(100, m_forecastPayload);
+        QList<ForecastData> parsed;
+        QBENCHMARK {
+            parsed = WeatherJsonParser::parseForecastBatch(payloads);
+        }
+        QCOMPARE(parsed.size(), 100);
+    }
+
+    void benchmarkAllocationsPerForecast() {
+        // ARRANGE
+        constexpr int BATCH = 100;
+        const QList<QByteArray> payloads(BATCH, m_forecastPayload);
+
+        // ACT 1 : réponses parsées une par une (un arena par réponse)
+        CountingResource perResponse;
+        {
+            ScopedDefaultResource scope(&perResponse);
+            for (const QByteArray& payload : payloads) {
+                ForecastData data = parseForecast(payload);
+                Q_UNUSED(data);
+            }
+        }
+
+        // ACT 2 : un seul lot, un seul arena
+        CountingResource batched;
+        QList<ForecastData> batch;
+        {
+            ScopedDefaultResource scope(&batched);
+            batch = WeatherJsonParser::parseForecastBatch(payloads);
+        }
+
+        // ASSERT + rapport (blocs d'arena par prévision de 40 créneaux)
+        QCOMPARE(batch.size(), BATCH);
+        QVERIFY(batched.allocations() < perResponse.allocations());
+        qInfo().noquote() << QString("arena blocks/forecast: per response %1 (%2 bytes), batched %3 (%4 bytes)")
+                                 .arg(double(perResponse.allocations()) / BATCH, 0, 'f', 2)
+                                 .arg(perResponse.bytes() / BATCH)
+                                 .arg(double(batched.allocations()) / BATCH, 0, 'f', 2)
+                                 .arg(batched.bytes() / BATCH);
+    }
+
+    void benchmarkParseCurrentWeather() {
+        CurrentWeatherData data;
+        QBENCHMARK {
+            data = WeatherJsonParser::parseCurrentWeather(QJsonDocument::fromJson(m_weatherPayload).object());
+        }
+        QVERIFY(data.isValid());
+    }
+
+    void benchmarkCacheFootprint10k() {
+        // ARRANGE
+        constexpr int FORECAST_COUNT = 10000;
+        weathercachemanager cache;
+        const qint64 rssBefore = residentSetBytes();
+
+        // ACT : 10k prévisions parsées séparément (aucune chaîne partagée entre elles)
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < FORECAST_COUNT; ++i) {
+            cache.storeCachedForecast(CityKey::fromId(i + 1),
+                                      std::make_shared<const ForecastData>(parseForecast(m_forecastPayload)));
+        }
+        const qint64 elapsedMs = timer.elapsed();
+        const qint64 rssAfter = residentSetBytes();
+
+        // ASSERT + rapport
+        QVERIFY(cache.tryGetForecast(CityKey::fromId(FORECAST_COUNT)));
+        qInfo().noquote() << QString("%1 forecasts: parse+store %2 ms (%3 us/forecast), cache estimate %4 KiB")
+                                 .arg(FORECAST_COUNT)
+                                 .arg(elapsedMs)
+                                 .arg(elapsedMs * 1000.0 / FORECAST_COUNT, 0, 'f', 1)
+                                 .arg(cache.memoryUsage() / 1024);
+        if (rssBefore < 0 || rssAfter < 0) {
+            QSKIP("RSS unavailable on this platform (/proc/self/status)");
+        }
+        qInfo().noquote() << QString("RSS delta %1 KiB (%2 bytes/forecast)")
+                                 .arg((rssAfter - rssBefore) / 1024)
+                                 .arg((rssAfter - rssBefore) / FORECAST_COUNT);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestParseBenchmark)
+#include "tst_parsebenchmark.moc"
@@ -0,0 +1,40 @@
+# tests/chartbenchmark/chartbenchmark.pro
+QT += testlib core gui widgets charts
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+CONFIG += c++17
+
+TEMPLATE = app
+TARGET = tst_chartbenchmark
+
+# Chemin vers le code source
+INCLUDEPATH += ../../src
+
+# Benchmarks (QBENCHMARK) : lancer en Release ; sans affichage : QT_QPA_PLATFORM=offscreen
+SOURCES += \
+    tst_chartbenchmark.cpp
+
+# Code source mesuré
+SOURCES += \
+    ../../src/weatherchartwidget.cpp \
+    ../../src/chartdownsampling.cpp \
+    ../../src/rendercache.cpp \
+    ../../src/weatherstats.cpp \
+    ../../src/derivedmetrics.cpp
+
+HEADERS += \
+    ../../src/weatherchartwidget.h \
+    ../../src/chartdownsampling.h \
+    ../../src/rendercache.h \
+    ../../src/citykey.h \
+    ../../src/weatherstats.h \
+    ../../src/derivedmetrics.h \
+    ../../src/inlinelist.h \
+    ../../src/WeatherData.h
+
+# Définir les mêmes deprecated warnings
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
+
+# Sortie dans un dossier séparé
+DESTDIR = $$OUT_PWD/bin
@@ -0,0 +1,386 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QtCharts/QChartView>
+#include <QtCharts/QXYSeries>
+#include <QtCharts/QDateTimeAxis>
+#include <cmath>
+#include "../../src/weatherchartwidget.h"
+#include "../../src/chartdownsampling.h"
+#include "../../src/rendercache.h"
+
+/**
+ * Coût d'un changement de ville sur le graphique de prévisions
+ *
+ * Le temps mesuré couvre la mise à jour des séries et des axes puis un
+ * rendu complet du widget (grab), soit le délai avant l'image suivante.
+ */
+class TestChartBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    QList<ForecastData> m_cities;
+
+    // Prévision synthétique de 40 créneaux, décalée par ville
+    static ForecastData forecastFor(int city) {
+        ForecastData data;
+        data.cityName = QString("Ville %1").arg(city);
+        const qint64 start = 1700000000 + qint64(city) * 3600;
+        for (int i = 0; i < FORECAST_INLINE_ENTRIES; ++i) {
+            ForecastEntry entry;
+            entry.dateTime = QDateTime::fromSecsSinceEpoch(start + qint64(i) * 10800);
+            entry.temperature = 5.0 + city % 20 + (i % 8) * 1.5;
+            entry.humidity = 40 + (city * 7 + i * 3) % 50;
+            data.entries.append(entry);
+        }
+        return data;
+    }
+
+    // Historique horaire d'une ville : `count` points, un pic isolé au milieu
+    static QList<QPointF> historyFor(int city, int count) {
+        QList<QPointF> points;
+        points.reserve(count);
+        const qreal start = 1700000000000.0;
+        for (int i = 0; i < count; ++i) {
+            qreal value = 10.0 + city % 10 + 8.0 * std::sin(i * 0.01 + city);
+            if (i == count / 2) value += 30.0;
+            points.append(QPointF(start + qreal(i) * 3600000.0, value));
+        }
+        return points;
+    }
+
+    static QChart* chartOf(WeatherChartWidget& widget) {
+        QChartView* view = widget.findChild<QChartView*>();
+        return view ? view->chart() : nullptr;
+    }
+
+    static QXYSeries* seriesAt(WeatherChartWidget& widget, int index) {
+        return qobject_cast<QXYSeries*>(chartOf(widget)->series().at(index));
+    }
+
+private slots:
+    void initTestCase() {
+        for (int i = 0; i < 50; ++i) {
+            m_cities.append(forecastFor(i));
+        }
+    }
+
+    // ========================================
+    // VALIDITÉ DES DONNÉES MESURÉES
+    // ========================================
+
+    void testBulkUpdateReplacesAllPoints() {
+        // ARRANGE
+        WeatherChartWidget widget;
+        widget.displayForecastData(m_cities.at(0));
+
+        // ACT
+        widget.displayForecastData(m_cities.at(1));
+
+        // ASSERT : points de la seconde ville uniquement, dans l'ordre
+        QXYSeries* temperature = seriesAt(widget, 0);
+        QXYSeries* humidity = seriesAt(widget, 1);
+        QCOMPARE(temperature->count(), FORECAST_INLINE_ENTRIES);
+        QCOMPARE(humidity->count(), FORECAST_INLINE_ENTRIES);
+        QCOMPARE(temperature->at(0).x(), qreal(m_cities.at(1).entries.first().dateTime.toMSecsSinceEpoch()));
+        QCOMPARE(temperature->at(39).y(), m_cities.at(1).entries.last().temperature);
+        QCOMPARE(humidity->at(5).y(), m_cities.at(1).entries.at(5).humidity);
+    }
+
+    void testRapidSwitchDisablesAnimations() {
+        // ARRANGE
+        WeatherChartWidget widget;
+
+        // ACT 1 : mise à jour isolée
+        widget.displayForecastData(m_cities.at(0));
+        const QChart::AnimationOptions isolated = chartOf(widget)->animationOptions();
+
+        // ACT 2 : ville suivante aussitôt
+        widget.displayForecastData(m_cities.at(1));
+
+        // ASSERT
+        QCOMPARE(isolated, QChart::AnimationOptions(QChart::AllAnimations));
+        QCOMPARE(chartOf(widget)->animationOptions(), QChart::AnimationOptions(QChart::NoAnimation));
+    }
+
+    void testAnimationsCanBeDisabled() {
+        // ARRANGE
+        WeatherChartWidget widget;
+        widget.setAnimationsEnabled(false);
+
+        // ACT
+        widget.displayForecastData(m_cities.at(0));
+
+        // ASSERT
+        QVERIFY(!widget.animationsEnabled());
+        QCOMPARE(chartOf(widget)->animationOptions(), QChart::AnimationOptions(QChart::NoAnimation));
+    }
+
+    // ========================================
+    // RÉDUCTION ET MODE COMPARAISON
+    // ========================================
+
+    void testDownsamplingKeepsEndsAndPeak() {
+        // ARRANGE
+        const QList<QPointF> history = historyFor(0, 10000);
+
+        for (ChartDownsampling::Method method : {ChartDownsampling::Method::LargestTriangle,
+                                                  ChartDownsampling::Method::MinMax}) {
+            // ACT
+            const QList<QPointF> reduced = ChartDownsampling::downsample(history, 800, method);
+
+            // ASSERT : taille bornée, extrémités et pic conservés, x croissants
+            QVERIFY(reduced.size() <= 800);
+            QCOMPARE(reduced.first(), history.first());
+            QCOMPARE(reduced.last(), history.last());
+            QVERIFY(reduced.contains(history.at(5000)));
+            for (int i = 1; i < reduced.size(); ++i) {
+                QVERIFY(reduced.at(i).x() > reduced.at(i - 1).x());
+            }
+        }
+    }
+
+    void testDownsamplingShortSeriesUnchanged() {
+        // ARRANGE
+        const QList<QPointF> history = historyFor(0, 40);
+
+        // ACT + ASSERT
+        QCOMPARE(ChartDownsampling::downsample(history, 800), history);
+        QCOMPARE(ChartDownsampling::downsample(history, 800, ChartDownsampling::Method::MinMax), history);
+    }
+
+    void testVisibleRangeIncludesNeighbours() {
+        // ARRANGE
+        const QList<QPointF> history = historyFor(0, 100);
+
+        // ACT : plage entre les points 10 et 20
+        const auto range = ChartDownsampling::visibleRange(history, history.at(10).x() - 1, history.at(20).x() + 1);
+
+        // ASSERT
+        QCOMPARE(range.first, qsizetype(9));
+        QCOMPARE(range.second, qsizetype(22));
+    }
+
+    void testComparisonUsesLinesForManyPoints() {
+        // ARRANGE
+        WeatherChartWidget widget;
+        widget.resize(900, 400);
+
+        // ACT 1 : deux villes de 40 créneaux → splines
+        widget.displayComparison({std::make_shared<const ForecastData>(m_cities.at(0)),
+                                  std::make_shared<const ForecastData>(m_cities.at(1))});
+        const int splineCount = int(chartOf(widget)->series().size());
+        const QAbstractSeries::SeriesType smallType = chartOf(widget)->series().last()->type();
+
+        // ACT 2 : 30 historiques de 10 000 points
+        widget.clearComparison();
+        for (int i = 0; i < 30; ++i) {
+            widget.addComparisonSeries(QString("Ville %1").arg(i), historyFor(i, 10000));
+        }
+        widget.refreshLevelOfDetail();
+
+        // ASSERT : lignes droites, points bornés par la largeur et le budget
+        QVERIFY(widget.isComparisonMode());
+        QCOMPARE(splineCount, 2 + 2); // + courbes de la ville courante (masquées)
+        QCOMPARE(smallType, QAbstractSeries::SeriesTypeSpline);
+        QCOMPARE(chartOf(widget)->series().last()->type(), QAbstractSeries::SeriesTypeLine);
+        QVERIFY(widget.displayedPointCount() <= WeatherChartWidget::COMPARISON_POINT_BUDGET);
+        QVERIFY(widget.displayedPointCount() < 30 * 10000 / 10);
+    }
+
+    void testComparisonZoomRestoresDetail() {
+        // ARRANGE
+        WeatherChartWidget widget;
+        widget.resize(900, 400);
+        const QList<QPointF> history = historyFor(0, 20000);
+        widget.addComparisonSeries("Paris", history);
+        widget.refreshLevelOfDetail();
+        const int reducedCount = seriesAt(widget, 2)->count();
+
+        // ACT : zoom sur les 50 premières heures (même chemin que la sélection à la souris)
+        auto* axisX = qobject_cast<QDateTimeAxis*>(chartOf(widget)->axes(Qt::Horizontal).first());
+        axisX->setRange(QDateTime::fromMSecsSinceEpoch(qint64(history.at(0).x())),
+                        QDateTime::fromMSecsSinceEpoch(qint64(history.at(49).x())));
+        widget.refreshLevelOfDetail();
+
+        // ASSERT : tous les points de la plage (et un voisin), à pleine résolution
+        QXYSeries* zoomed = seriesAt(widget, 2);
+        QVERIFY(reducedCount < 20000 / 10);
+        QCOMPARE(zoomed->count(), 51);
+        QCOMPARE(zoomed->at(1).x() - zoomed->at(0).x(), 3600000.0);
+    }
+
+    void testForecastDisplayLeavesComparison() {
+        // ARRANGE
+        WeatherChartWidget widget;
+        widget.addComparisonSeries("Paris", historyFor(0, 1000));
+
+        // ACT
+        widget.displayForecastData(m_cities.at(0));
+
+        // ASSERT
+        QVERIFY(!widget.isComparisonMode());
+        QCOMPARE(chartOf(widget)->series().size(), qsizetype(2));
+        QVERIFY(seriesAt(widget, 0)->isVisible());
+        QCOMPARE(widget.displayedPointCount(), 2 * FORECAST_INLINE_ENTRIES);
+    }
+
+    // ========================================
+    // CACHE DE RENDU
+    // ========================================
+
+    void testRenderCacheMatchesDataVersion() {
+        // ARRANGE
+        RenderCache cache;
+        const CityKey paris("Paris");
+        auto version1 = std::make_shared<const ForecastData>(m_cities.at(0));
+        auto version2 = std::make_shared<const ForecastData>(m_cities.at(0)); // même contenu, autre entrée
+        QPixmap pixmap(100, 50);
+        pixmap.fill(Qt::white);
+
+        // ACT
+        cache.insert(paris, version1, pixmap);
+
+        // ASSERT : seulement les mêmes données, à la même taille
+        QVERIFY(!cache.find(paris, version1, QSize(100, 50)).isNull());
+        QVERIFY(cache.find(paris, version2, QSize(100, 50)).isNull());
+        QVERIFY(cache.find(paris, version1, QSize(200, 50)).isNull());
+        QVERIFY(cache.find(CityKey("Lyon"), version1, QSize(100, 50)).isNull());
+        QCOMPARE(cache.hits(), qint64(1));
+        QCOMPARE(cache.misses(), qint64(3));
+
+        cache.invalidate(CityKey("  PARIS "));
+        QVERIFY(cache.find(paris, version1, QSize(100, 50)).isNull());
+        QCOMPARE(cache.count(), 0);
+    }
+
+    void testRevisitShowsCachedRender() {
+        // ARRANGE
+        WeatherChartWidget widget;
+        widget.resize(900, 400);
+        widget.setAnimationsEnabled(false);
+        ForecastPtr paris = std::make_shared<const ForecastData>(m_cities.at(0));
+        ForecastPtr lyon = std::make_shared<const ForecastData>(m_cities.at(1));
+        widget.displayForecast(paris);
+        QTRY_COMPARE(widget.renderCache().count(), 1);
+        widget.displayForecast(lyon);
+        QTRY_COMPARE(widget.renderCache().count(), 2);
+
+        // ACT 1 : retour sur une ville déjà rendue
+        widget.displayForecast(paris);
+        const bool revisitCached = widget.isShowingCachedRender();
+
+        // ACT 2 : nouvelle entrée du cache météo pour cette ville
+        widget.displayForecast(std::make_shared<const ForecastData>(m_cities.at(0)));
+
+        // ASSERT
+        QVERIFY(revisitCached);
+        QCOMPARE(widget.renderCache().hits(), qint64(1));
+        QVERIFY(!widget.isShowingCachedRender());
+        QCOMPARE(seriesAt(widget, 0)->count(), FORECAST_INLINE_ENTRIES);
+    }
+
+    // ========================================
+    // BENCHMARKS
+    // ========================================
+
+    void benchmarkCitySwitchRepaint() {
+        // ARRANGE
+        WeatherChartWidget widget;
+        widget.resize(900, 400);
+        widget.displayForecastData(m_cities.at(0));
+        widget.grab();
+
+        // ACT : une ville différente à chaque itération, rendu compris
+        int next = 1;
+        QBENCHMARK {
+            widget.displayForecastData(m_cities.at(next++ % m_cities.size()));
+            QCoreApplication::sendPostedEvents();
+            widget.grab();
+        }
+
+        QCOMPARE(seriesAt(widget, 0)->count(), FORECAST_INLINE_ENTRIES);
+    }
+
+    void benchmarkCitySwitchBurst() {
+        // ARRANGE
+        WeatherChartWidget widget;
+        widget.resize(900, 400);
+        widget.grab();
+
+        // ACT : toutes les villes enchaînées, une image par ville
+        QElapsedTimer timer;
+        timer.start();
+        for (const ForecastData& city : m_cities) {
+            widget.displayForecastData(city);
+            QCoreApplication::sendPostedEvents();
+            widget.grab();
+        }
+        const qint64 elapsedUs = timer.nsecsElapsed() / 1000;
+
+        // ASSERT + rapport
+        QCOMPARE(chartOf(widget)->animationOptions(), QChart::AnimationOptions(QChart::NoAnimation));
+        qInfo().noquote() << QString("%1 city switches: %2 us/switch (update + repaint)")
+                                 .arg(m_cities.size())
+                                 .arg(elapsedUs / m_cities.size());
+    }
+
+    void benchmarkRevisitCachedCity() {
+        // ARRANGE : 20 villes affichées une fois (images en cache)
+        WeatherChartWidget widget;
+        widget.resize(900, 400);
+        widget.setAnimationsEnabled(false);
+        QList<ForecastPtr> forecasts;
+        for (int i = 0; i < 20; ++i) {
+            forecasts.append(std::make_shared<const ForecastData>(m_cities.at(i)));
+            widget.displayForecast(forecasts.last());
+            QCoreApplication::processEvents();
+        }
+        QTRY_COMPARE(widget.renderCache().count(), 20);
+
+        // ACT : affichage mural, villes revisitées en boucle
+        int next = 0;
+        QBENCHMARK {
+            widget.displayForecast(forecasts.at(next++ % forecasts.size()));
+            QCoreApplication::sendPostedEvents();
+            widget.grab();
+        }
+
+        QVERIFY(widget.isShowingCachedRender());
+    }
+
+    void benchmarkComparisonRepaint_data() {
+        QTest::addColumn<int>("cities");
+        QTest::addColumn<int>("points");
+        QTest::newRow("10x40") << 10 << 40;
+        QTest::newRow("50x2000") << 50 << 2000;
+        QTest::newRow("50x20000") << 50 << 20000;
+    }
+
+    void benchmarkComparisonRepaint() {
+        QFETCH(int, cities);
+        QFETCH(int, points);
+
+        // ARRANGE
+        WeatherChartWidget widget;
+        widget.resize(1200, 500);
+        for (int i = 0; i < cities; ++i) {
+            widget.addComparisonSeries(QString("Ville %1").arg(i), historyFor(i, points));
+        }
+        widget.refreshLevelOfDetail();
+        widget.grab();
+
+        // ACT : recalcul de la réduction (comme après un zoom) et rendu complet
+        QBENCHMARK {
+            widget.refreshLevelOfDetail();
+            QCoreApplication::sendPostedEvents();
+            widget.grab();
+        }
+
+        qInfo().noquote() << QString("%1 series x %2 points: %3 points drawn")
+                                 .arg(cities).arg(points).arg(widget.displayedPointCount());
+    }
+};
+
+QTEST_MAIN(TestChartBenchmark)
+#include "tst_chartbenchmark.moc"
@@ -0,0 +1,30 @@
+# tests/statsbenchmark/statsbenchmark.pro
+QT += testlib core
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+CONFIG += c++17
+
+TEMPLATE = app
+TARGET = tst_statsbenchmark
+
+# Chemin vers le code source
+INCLUDEPATH += ../../src
+
+# Benchmarks (QBENCHMARK) : lancer en Release
+SOURCES += \
+    tst_statsbenchmark.cpp
+
+# Code source mesuré
+SOURCES += \
+    ../../src/weatherstats.cpp
+
+HEADERS += \
+    ../../src/weatherstats.h
+
+# Définir les mêmes deprecated warnings
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
+
+# Sortie dans un dossier séparé
+DESTDIR = $$OUT_PWD/bin
@@ -0,0 +1,182 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include <algorithm>
+#include <numeric>
+#include "../../src/weatherstats.h"
+
+using WeatherStats::Backend;
+
+Q_DECLARE_METATYPE(WeatherStats::Backend)
+
+/**
+ * Noyaux statistiques : exactitude de chaque backend et mesures 1k → 100k
+ */
+class TestStatsBenchmark : public QObject
+{
+    Q_OBJECT
+
+private:
+    // Série de températures plausible, reproductible
+    static QList<double> makeSeries(qsizetype count, quint32 seed = 42) {
+        QRandomGenerator generator(seed);
+        QList<double> series(count);
+        for (double& value : series) {
+            value = -30.0 + generator.generateDouble() * 75.0;
+        }
+        return series;
+    }
+
+    static QList<Backend> availableBackends() {
+        QList<Backend> backends;
+        for (Backend backend : {Backend::Scalar, Backend::SSE2, Backend::AVX2}) {
+            if (WeatherStats::isBackendAvailable(backend)) {
+                backends.append(backend);
+            }
+        }
+        return backends;
+    }
+
+    // Lignes backend × taille pour les benchmarks vectorisés
+    static void addBackendRows() {
+        QTest::addColumn<Backend>("backend");
+        QTest::addColumn<qsizetype>("count");
+        for (Backend backend : availableBackends()) {
+            for (qsizetype count : {qsizetype(1000), qsizetype(10000), qsizetype(100000)}) {
+                QTest::addRow("%s/%lld", qPrintable(WeatherStats::backendName(backend)), qint64(count))
+                    << backend << count;
+            }
+        }
+    }
+
+    static void addSizeRows() {
+        QTest::addColumn<qsizetype>("count");
+        for (qsizetype count : {qsizetype(1000), qsizetype(10000), qsizetype(100000)}) {
+            QTest::addRow("%lld", qint64(count)) << count;
+        }
+    }
+
+private slots:
+    void initTestCase() {
+        qInfo().noquote() << "Best backend:" << WeatherStats::backendName(WeatherStats::bestAvailableBackend());
+    }
+
+    void cleanup() {
+        WeatherStats::setBackend(WeatherStats::bestAvailableBackend());
+    }
+
+    // ========================================
+    // EXACTITUDE
+    // ========================================
+
+    void testBackendsMatchScalar() {
+        // Tailles autour des largeurs de registre (restes de boucle)
+        for (qsizetype count : {1, 2, 3, 7, 8, 9, 15, 16, 17, 40, 1001}) {
+            // ARRANGE
+            const QList<double> series = makeSeries(count, quint32(count));
+            QVERIFY(WeatherStats::setBackend(Backend::Scalar));
+            const WeatherStats::Range expected = WeatherStats::minMax(series.constData(), count);
+            const double expectedSum = WeatherStats::sum(series.constData(), count);
+
+            for (Backend backend : availableBackends()) {
+                // ACT
+                QVERIFY(WeatherStats::setBackend(backend));
+                const WeatherStats::Range range = WeatherStats::minMax(series.constData(), count);
+                const double total = WeatherStats::sum(series.constData(), count);
+
+                // ASSERT : min/max exacts, somme à l'arrondi près
+                QCOMPARE(range.min, expected.min);
+                QCOMPARE(range.max, expected.max);
+                QVERIFY(qAbs(total - expectedSum) <= 1e-9 * qMax(1.0, qAbs(expectedSum)));
+            }
+        }
+    }
+
+    void testEmptySeries() {
+        QCOMPARE(WeatherStats::minMax(nullptr, 0).min, 0.0);
+        QCOMPARE(WeatherStats::mean(nullptr, 0), 0.0);
+        QCOMPARE(WeatherStats::percentile(nullptr, 0, 50), 0.0);
+        QVERIFY(WeatherStats::movingAverage(QList<double>{1.0, 2.0}, 3).isEmpty());
+    }
+
+    void testPercentileInterpolates() {
+        // ARRANGE
+        const QList<double> odd{5.0, 1.0, 4.0, 2.0, 3.0};
+        const QList<double> even{4.0, 1.0, 3.0, 2.0};
+
+        // ASSERT
+        QCOMPARE(WeatherStats::percentile(odd.constData(), odd.size(), 50), 3.0);
+        QCOMPARE(WeatherStats::percentile(odd.constData(), odd.size(), 0), 1.0);
+        QCOMPARE(WeatherStats::percentile(odd.constData(), odd.size(), 100), 5.0);
+        QCOMPARE(WeatherStats::percentile(odd.constData(), odd.size(), 25), 2.0);
+        QCOMPARE(WeatherStats::percentile(even.constData(), even.size(), 50), 2.5);
+        QCOMPARE(odd.first(), 5.0); // Série d'origine intacte
+    }
+
+    void testMovingAverage() {
+        // ACT
+        const QList<double> averages = WeatherStats::movingAverage(QList<double>{1, 2, 3, 4, 5}, 2);
+
+        // ASSERT
+        QCOMPARE(averages, (QList<double>{1.5, 2.5, 3.5, 4.5}));
+    }
+
+    // ========================================
+    // BENCHMARKS
+    // ========================================
+
+    void benchmarkMinMax_data() { addBackendRows(); }
+    void benchmarkMinMax() {
+        QFETCH(Backend, backend);
+        QFETCH(qsizetype, count);
+        const QList<double> series = makeSeries(count);
+        QVERIFY(WeatherStats::setBackend(backend));
+
+        WeatherStats::Range range;
+        QBENCHMARK {
+            range = WeatherStats::minMax(series.constData(), count);
+        }
+        QCOMPARE(range.min, *std::min_element(series.cbegin(), series.cend()));
+    }
+
+    void benchmarkMean_data() { addBackendRows(); }
+    void benchmarkMean() {
+        QFETCH(Backend, backend);
+        QFETCH(qsizetype, count);
+        const QList<double> series = makeSeries(count);
+        QVERIFY(WeatherStats::setBackend(backend));
+
+        double average = 0.0;
+        QBENCHMARK {
+            average = WeatherStats::mean(series.constData(), count);
+        }
+        QVERIFY(average > -30.0 && average < 45.0);
+    }
+
+    void benchmarkPercentile_data() { addSizeRows(); }
+    void benchmarkPercentile() {
+        QFETCH(qsizetype, count);
+        const QList<double> series = makeSeries(count);
+
+        double p95 = 0.0;
+        QBENCHMARK {
+            p95 = WeatherStats::percentile(series.constData(), count, 95.0);
+        }
+        QVERIFY(p95 > 0.0);
+    }
+
+    void benchmarkMovingAverage_data() { addSizeRows(); }
+    void benchmarkMovingAverage() {
+        QFETCH(qsizetype, count);
+        const QList<double> series = makeSeries(count);
+        QList<double> output(count);
+
+        qsizetype written = 0;
+        QBENCHMARK {
+            written = WeatherStats::movingAverage(series.constData(), count, 8, output.data());
+        }
+        QCOMPARE(written, count - 7);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestStatsBenchmark)
+#include "tst_statsbenchmark.moc"
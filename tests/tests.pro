@@ -19,14 +19,20 @@ SOURCES += \
 # Code source à tester
 # ✅ NE PAS inclure weatherservice.cpp si vous ne testez que le cache
 SOURCES += \
-    ../src/weathercachemanager.cpp
+    ../src/cityspatialindex.cpp \
+    ../src/weathercachemanager.cpp \
+    ../src/derivedmetrics.cpp
 
 # Si WeatherData.cpp existe, ajoutez-le
 # SOURCES += ../src/WeatherData.cpp
 
 HEADERS += \
+    ../src/cityspatialindex.h \
     ../src/weathercachemanager.h \
     ../src/ICacheManager.h \
+    ../src/citykey.h \
+    ../src/derivedmetrics.h \
+    ../src/inlinelist.h \
     ../src/WeatherData.h \
     ../src/weathererrors.h
 
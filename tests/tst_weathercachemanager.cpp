@@ -27,6 +27,13 @@ private:
         return data;
     }
 
+    CurrentWeatherData located(const QString& city, double latitude, double longitude) {
+        CurrentWeatherData data = createTestWeather(city);
+        data.latitude = latitude;
+        data.longitude = longitude;
+        return data;
+    }
+
     ForecastData createTestForecast(const QString& city) {
         ForecastData data;
         data.cityName = city;
@@ -74,14 +81,14 @@ private slots:
         CurrentWeatherData testData = createTestWeather(city, 22.5);
 
         // ACT
-        m_cache->storeCachedWeather(city, testData);
-        CurrentWeatherData retrieved = m_cache->getCityweatherInCache(city);
+        m_cache->storeCachedWeather(CityKey(city), testData);
+        CurrentWeatherData retrieved = m_cache->getCityweatherInCache(CityKey(city));
 
         // ASSERT
         QCOMPARE(retrieved.cityName, city);
         QCOMPARE(retrieved.temperature, 22.5);
         QCOMPARE(retrieved.countryCode, QString("FR"));
-        QVERIFY(m_cache->isValid(city, "weather"));
+        QVERIFY(m_cache->isValid(CityKey(city), WeatherDataType::Weather));
     }
 
     void testStoreAndRetrieveForecast() {
@@ -90,10 +97,10 @@ private slots:
         ForecastData testData = createTestForecast(city);
 
         // ACT
-        m_cache->storeCachedForecast(city, testData);
+        m_cache->storeCachedForecast(CityKey(city), testData);
 
         // ASSERT
-        QVERIFY(m_cache->isValid(city, "forecast"));
+        QVERIFY(m_cache->isValid(CityKey(city), WeatherDataType::Forecast));
     }
 
     void testStoreMultipleCities() {
@@ -102,12 +109,12 @@ private slots:
 
         // ACT
         for (const QString& city : cities) {
-            m_cache->storeCachedWeather(city, createTestWeather(city));
+            m_cache->storeCachedWeather(CityKey(city), createTestWeather(city));
         }
 
         // ASSERT
         for (const QString& city : cities) {
-            QVERIFY2(m_cache->isValid(city, "weather"), 
+            QVERIFY2(m_cache->isValid(CityKey(city), WeatherDataType::Weather), 
                      qPrintable(QString("Cache invalide pour %1").arg(city)));
         }
     }
@@ -115,11 +122,11 @@ private slots:
     void testOverwriteCache() {
         // ARRANGE
         QString city = "Paris";
-        m_cache->storeCachedWeather(city, createTestWeather(city, 15.0));
+        m_cache->storeCachedWeather(CityKey(city), createTestWeather(city, 15.0));
         
         // ACT
-        m_cache->storeCachedWeather(city, createTestWeather(city, 25.0));
-        CurrentWeatherData retrieved = m_cache->getCityweatherInCache(city);
+        m_cache->storeCachedWeather(CityKey(city), createTestWeather(city, 25.0));
+        CurrentWeatherData retrieved = m_cache->getCityweatherInCache(CityKey(city));
 
         // ASSERT
         QCOMPARE(retrieved.temperature, 25.0);
@@ -131,24 +138,233 @@ private slots:
 
     void testIsValid_ValidCache() {
         // ARRANGE
-        m_cache->storeCachedWeather("Paris", createTestWeather("Paris"));
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris"));
 
         // ACT & ASSERT
-        QVERIFY(m_cache->isValid("Paris", "weather"));
+        QVERIFY(m_cache->isValid(CityKey("Paris"), WeatherDataType::Weather));
     }
 
     void testIsValid_NonExistent() {
         // ACT & ASSERT
-        QVERIFY(!m_cache->isValid("NonExistentCity", "weather"));
+        QVERIFY(!m_cache->isValid(CityKey("NonExistentCity"), WeatherDataType::Weather));
     }
 
     void testIsValid_WrongDataType() {
         // ARRANGE
-        m_cache->storeCachedWeather("Paris", createTestWeather("Paris"));
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris"));
+
+        // ACT & ASSERT
+        QVERIFY(m_cache->isValid(CityKey("Paris"), WeatherDataType::Weather));
+        QVERIFY(!m_cache->isValid(CityKey("Paris"), WeatherDataType::Forecast));
+    }
+
+    void testCacheInfo() {
+        // ARRANGE
+        m_cache->storeCachedForecast(CityKey("London"), createTestForecast("London"));
+
+        // ACT
+        CacheInfo forecastInfo = m_cache->getCacheInfo(CityKey("London"), WeatherDataType::Forecast);
+        CacheInfo missingInfo = m_cache->getCacheInfo(CityKey("London"), WeatherDataType::Weather);
+
+        // ASSERT
+        QVERIFY(forecastInfo.cachedAt.isValid());
+        QCOMPARE(forecastInfo.validityMinutes, 120);
+        QVERIFY(!missingInfo.cachedAt.isValid());
+    }
+
+    // ========================================
+    // TESTS D'ACCÈS PARTAGÉ (tryGet)
+    // ========================================
+
+    void testTryGetSharesCachedData() {
+        // ARRANGE
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris", 22.5));
+        m_cache->storeCachedForecast(CityKey("London"), createTestForecast("London"));
+
+        // ACT
+        CurrentWeatherPtr first = m_cache->tryGetWeather(CityKey("Paris"));
+        CurrentWeatherPtr second = m_cache->tryGetWeather(CityKey("paris"));
+        ForecastPtr forecast = m_cache->tryGetForecast(CityKey("London"));
+
+        // ASSERT : même objet, aucune copie
+        QVERIFY(first);
+        QCOMPARE(first.get(), second.get());
+        QCOMPARE(first->temperature, 22.5);
+        QVERIFY(forecast);
+        QCOMPARE(forecast->entries.size(), 5);
+    }
+
+    void testTryGetMissing() {
+        // ARRANGE
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris"));
+
+        // ACT & ASSERT
+        QVERIFY(!m_cache->tryGetWeather(CityKey("London")));
+        QVERIFY(!m_cache->tryGetForecast(CityKey("Paris")));
+    }
+
+    void testCachedKeysListsEachCityOnce() {
+        // ARRANGE : une ville avec météo et prévisions, une avec prévisions seules
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris"));
+        m_cache->storeCachedForecast(CityKey("Paris"), createTestForecast("Paris"));
+        m_cache->storeCachedForecast(CityKey("London"), createTestForecast("London"));
+
+        // ACT
+        const QList<CityKey> keys = m_cache->cachedKeys();
+
+        // ASSERT
+        QCOMPARE(keys.size(), 2);
+        QVERIFY(keys.contains(CityKey("paris")));
+        QVERIFY(keys.contains(CityKey("london")));
+    }
+
+    void testPeekWeatherIgnoresValidity() {
+        // ARRANGE
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris", 12.0));
+
+        // ACT
+        CurrentWeatherPtr peeked = m_cache->peekWeather(CityKey("Paris"));
+
+        // ASSERT : même poignée que tryGet, nullptr si absente
+        QVERIFY(peeked);
+        QCOMPARE(peeked.get(), m_cache->tryGetWeather(CityKey("Paris")).get());
+        QVERIFY(!m_cache->peekWeather(CityKey("London")));
+    }
+
+    void testTryGetHandleSurvivesReplacement() {
+        // ARRANGE
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris", 15.0));
+        CurrentWeatherPtr before = m_cache->tryGetWeather(CityKey("Paris"));
+
+        // ACT
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris", 25.0));
+        m_cache->signalCacheCleared();
+
+        // ASSERT : la poignée détenue reste intacte et immuable
+        QVERIFY(before);
+        QCOMPARE(before->temperature, 15.0);
+        QVERIFY(!m_cache->tryGetWeather(CityKey("Paris")));
+    }
+
+    // ========================================
+    // TESTS DES GRANDEURS DÉRIVÉES
+    // ========================================
+
+    void testDerivedMetricsValues() {
+        // ARRANGE : 30 °C / 70 % (chaleur), -5 °C / 5 m/s (froid venteux)
+        CurrentWeatherData hot = createTestWeather("Paris", 30.0);
+        hot.humidity = 70.0;
+        hot.sunrise = QDateTime::currentDateTime();
+        hot.sunset = hot.sunrise.addSecs(9 * 3600 + 30 * 60);
+        CurrentWeatherData cold = createTestWeather("Oslo", -5.0);
+        cold.windSpeed = 5.0;
+        m_cache->storeCachedWeather(CityKey("Paris"), hot);
+        m_cache->storeCachedWeather(CityKey("Oslo"), cold);
+
+        // ACT
+        DerivedMetricsPtr paris = m_cache->derivedMetrics(CityKey("Paris"));
+        DerivedMetricsPtr oslo = m_cache->derivedMetrics(CityKey("Oslo"));
+
+        // ASSERT
+        QVERIFY(paris && oslo);
+        QVERIFY(qAbs(paris->dewPoint - 23.93) < 0.01);
+        QVERIFY(qAbs(paris->heatIndex - 35.04) < 0.01);
+        QCOMPARE(paris->windChill, 30.0);
+        QCOMPARE(paris->feelsLikeDelta, -1.0);
+        QCOMPARE(paris->daylightSeconds, qint64(9 * 3600 + 30 * 60));
+        QVERIFY(qAbs(oslo->windChill - (-11.19)) < 0.01);
+        QCOMPARE(oslo->heatIndex, -5.0);
+        QCOMPARE(oslo->daylightSeconds, qint64(-1));
+    }
+
+    void testDerivedMetricsMemoized() {
+        // ARRANGE
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris"));
+        m_cache->storeCachedForecast(CityKey("London"), createTestForecast("London"));
+
+        // ACT
+        DerivedMetricsPtr first = m_cache->derivedMetrics(CityKey("Paris"));
+        DerivedMetricsPtr second = m_cache->derivedMetrics(CityKey("paris"));
+        ForecastMetricsPtr forecast = m_cache->derivedForecastMetrics(CityKey("London"));
+
+        // ASSERT : calculé une fois, puis partagé
+        QVERIFY(first);
+        QCOMPARE(first.get(), second.get());
+        QVERIFY(forecast);
+        QCOMPARE(forecast->size(), 5);
+        QCOMPARE(forecast.get(), m_cache->derivedForecastMetrics(CityKey("London")).get());
+        QVERIFY(!m_cache->derivedMetrics(CityKey("London")));
+    }
+
+    void testDerivedMetricsDroppedOnReplace() {
+        // ARRANGE
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris", 15.0));
+        DerivedMetricsPtr before = m_cache->derivedMetrics(CityKey("Paris"));
+
+        // ACT : nouvelle réponse pour la même ville
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris", 25.0));
+        DerivedMetricsPtr after = m_cache->derivedMetrics(CityKey("Paris"));
+
+        // ASSERT : recalculé sur les nouvelles données, l'ancienne poignée reste lisible
+        QVERIFY(before && after);
+        QVERIFY(before.get() != after.get());
+        QVERIFY(after->dewPoint > before->dewPoint);
+    }
+
+    void testDerivedMetricsBatch() {
+        // ARRANGE : une ville déjà calculée, deux à calculer, une absente
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris", 10.0));
+        m_cache->storeCachedWeather(CityKey("London"), createTestWeather("London", 20.0));
+        m_cache->storeCachedWeather(CityKey("Tokyo"), createTestWeather("Tokyo", 30.0));
+        DerivedMetricsPtr paris = m_cache->derivedMetrics(CityKey("Paris"));
+
+        // ACT
+        QHash<CityKey, DerivedMetricsPtr> batch = m_cache->derivedMetrics(
+            QList<CityKey>{CityKey("Paris"), CityKey("London"), CityKey("Tokyo"), CityKey("Berlin")});
+
+        // ASSERT : mêmes valeurs qu'à l'unité, mémorisées pour les accès suivants
+        QCOMPARE(batch.size(), 3);
+        QCOMPARE(batch.value(CityKey("Paris")).get(), paris.get());
+        QCOMPARE(batch.value(CityKey("Tokyo")).get(), m_cache->derivedMetrics(CityKey("Tokyo")).get());
+        QCOMPARE(batch.value(CityKey("London"))->dewPoint,
+                 WeatherMetrics::compute(createTestWeather("London", 20.0)).dewPoint);
+    }
+
+    // ========================================
+    // TESTS DE CLÉS CANONIQUES
+    // ========================================
+
+    void testKeyVariantsShareEntry() {
+        // ARRANGE
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris", 21.0));
 
         // ACT & ASSERT
-        QVERIFY(m_cache->isValid("Paris", "weather"));
-        QVERIFY(!m_cache->isValid("Paris", "forecast"));
+        QVERIFY(m_cache->isValid(CityKey("  paris "), WeatherDataType::Weather));
+        QVERIFY(m_cache->isValid(CityKey("PARIS"), WeatherDataType::Weather));
+        QCOMPARE(m_cache->getCityweatherInCache(CityKey("Paris ")).temperature, 21.0);
+        QCOMPARE(CityKey("Saint-Étienne"), CityKey("saint-etienne"));
+        QCOMPARE(CityKey("Paris , FR"), CityKey("paris,fr"));
+    }
+
+    void testIdKeyDistinctFromName() {
+        // ARRANGE
+        CityKey byId = CityKey::fromId(2988507);
+        m_cache->storeCachedWeather(byId, createTestWeather("Paris"));
+
+        // ACT & ASSERT
+        QVERIFY(byId.isId());
+        QVERIFY(m_cache->isValid(CityKey::fromId(2988507), WeatherDataType::Weather));
+        QVERIFY(!m_cache->isValid(CityKey("Paris"), WeatherDataType::Weather));
+    }
+
+    void testNumericInputIsNameKey() {
+        // ACT : un code postal saisi n'est pas un identifiant de ville
+        CityKey postalCode("75001");
+
+        // ASSERT
+        QVERIFY(!postalCode.isId());
+        QCOMPARE(postalCode.name(), QString("75001"));
+        QVERIFY(postalCode != CityKey::fromId(75001));
     }
 
     // ========================================
@@ -157,15 +373,15 @@ private slots:
 
     void testClearCache() {
         // ARRANGE
-        m_cache->storeCachedWeather("Paris", createTestWeather("Paris"));
-        m_cache->storeCachedWeather("London", createTestWeather("London"));
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris"));
+        m_cache->storeCachedWeather(CityKey("London"), createTestWeather("London"));
 
         // ACT
         m_cache->signalCacheCleared();
 
         // ASSERT
-        QVERIFY(!m_cache->isValid("Paris", "weather"));
-        QVERIFY(!m_cache->isValid("London", "weather"));
+        QVERIFY(!m_cache->isValid(CityKey("Paris"), WeatherDataType::Weather));
+        QVERIFY(!m_cache->isValid(CityKey("London"), WeatherDataType::Weather));
     }
 
     void testClearCacheSignal() {
@@ -173,7 +389,7 @@ private slots:
         QSignalSpy spy(m_cache, &weathercachemanager::cacheCleanedUp);
         QVERIFY(spy.isValid());
         
-        m_cache->storeCachedWeather("Paris", createTestWeather("Paris"));
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris"));
 
         // ACT
         m_cache->signalCacheCleared();
@@ -185,14 +401,167 @@ private slots:
 
     void testCleanExpiredCache() {
         // ARRANGE
-        m_cache->storeCachedWeather("Paris", createTestWeather("Paris"));
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris"));
         
         // ACT
         int removed = m_cache->cleanExpiredCache();
 
         // ASSERT
         QCOMPARE(removed, 0); // Rien d'expiré
-        QVERIFY(m_cache->isValid("Paris", "weather"));
+        QVERIFY(m_cache->isValid(CityKey("Paris"), WeatherDataType::Weather));
+    }
+
+    // ========================================
+    // TESTS DE RÉPONSE BRUTE ET BUDGET MÉMOIRE
+    // ========================================
+
+    void testRawPayloadDiscardedByDefault() {
+        // ARRANGE
+        QByteArray raw = R"({"name": "Paris", "id": 2988507})";
+
+        // ACT
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris"), raw);
+
+        // ASSERT
+        QVERIFY(m_cache->getRawWeatherPayload(CityKey("Paris")).isEmpty());
+    }
+
+    void testRawPayloadSharedWithoutCopy() {
+        // ARRANGE
+        m_cache->setRawPayloadMode(RawPayloadMode::Original);
+        QByteArray raw = R"({"name": "Paris", "id": 2988507})";
+
+        // ACT
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris"), raw);
+        QByteArray retrieved = m_cache->getRawWeatherPayload(CityKey("Paris"));
+
+        // ASSERT
+        QCOMPARE(retrieved, raw);
+        QCOMPARE(retrieved.constData(), raw.constData()); // même tampon
+    }
+
+    void testRawPayloadCompacted() {
+        // ARRANGE
+        m_cache->setRawPayloadMode(RawPayloadMode::Compact);
+        QByteArray raw = "{\n  \"city\": { \"name\": \"London\" },\n  \"list\": []\n}";
+
+        // ACT
+        m_cache->storeCachedForecast(CityKey("London"), createTestForecast("London"), raw);
+        QByteArray retrieved = m_cache->getRawForecastPayload(CityKey("London"));
+
+        // ASSERT
+        QVERIFY(!retrieved.contains(' '));
+        QVERIFY(retrieved.size() < raw.size());
+    }
+
+    void testMemoryUsageAccountsBothRepresentations() {
+        // ARRANGE
+        m_cache->setRawPayloadMode(RawPayloadMode::Original);
+        QByteArray raw(4096, 'x');
+
+        // ACT
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris"));
+        qint64 parsedOnly = m_cache->memoryUsage();
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris"), raw);
+
+        // ASSERT
+        QCOMPARE(m_cache->memoryUsage(), parsedOnly + raw.size());
+    }
+
+    void testMemoryBudgetEvictsOldest() {
+        // ARRANGE
+        m_cache->setRawPayloadMode(RawPayloadMode::Original);
+        QByteArray raw(4096, 'x');
+        m_cache->storeCachedWeather(CityKey("Paris"), createTestWeather("Paris"), raw);
+        m_cache->storeCachedWeather(CityKey("London"), createTestWeather("London"), raw);
+        m_cache->storeCachedWeather(CityKey("Tokyo"), createTestWeather("Tokyo"), raw);
+
+        // ACT
+        m_cache->setMemoryBudget(createTestWeather("Tokyo").memoryFootprint() + 100);
+
+        // ASSERT
+        QVERIFY(m_cache->memoryUsage() <= m_cache->memoryBudget());
+        QVERIFY(!m_cache->isValid(CityKey("Paris"), WeatherDataType::Weather));
+        QVERIFY(m_cache->isValid(CityKey("Tokyo"), WeatherDataType::Weather));
+        QVERIFY(m_cache->getRawWeatherPayload(CityKey("Tokyo")).isEmpty());
+    }
+
+    void testSharedForecastLabelsCountedOnce() {
+        // ARRANGE : libellés internés, partagés entre créneaux et entre deux villes
+        const QString clouds = QString("Clouds");
+        const QString description = QString("partiellement nuageux");
+        ForecastData paris = createTestForecast("Paris");
+        for (ForecastEntry& entry : paris.entries) {
+            entry.mainCondition = clouds;
+            entry.description = description;
+        }
+        ForecastData london = paris;
+        london.cityName = "London";
+        const qint64 labelBytes = (clouds.capacity() + description.capacity()) * qint64(sizeof(QChar));
+
+        // ACT
+        m_cache->storeCachedForecast(CityKey("Paris"), paris);
+        const qint64 afterParis = m_cache->memoryUsage();
+        m_cache->storeCachedForecast(CityKey("London"), london);
+
+        // ASSERT : une copie de chaque libellé pour tous les créneaux et toutes les villes
+        QCOMPARE(paris.memoryFootprint(), paris.fixedFootprint() + labelBytes);
+        QCOMPARE(afterParis, paris.memoryFootprint());
+        QCOMPARE(m_cache->memoryUsage() - afterParis, london.fixedFootprint());
+    }
+
+    // ========================================
+    // TESTS DE L'INDEX SPATIAL
+    // ========================================
+
+    void testNearestCitiesSortedByDistance() {
+        // ARRANGE
+        m_cache->storeCachedWeather(CityKey("Tokyo"), located("Tokyo", 35.6762, 139.6503));
+        m_cache->storeCachedWeather(CityKey("Lyon"), located("Lyon", 45.7640, 4.8357));
+        m_cache->storeCachedWeather(CityKey("Paris"), located("Paris", 48.8566, 2.3522));
+        m_cache->storeCachedWeather(CityKey("London"), located("London", 51.5074, -0.1278));
+
+        // ACT : depuis Versailles
+        const QList<CityKey> nearest = m_cache->nearestCities(48.8049, 2.1204, 3);
+        const QList<CityKey> withinRadius = m_cache->nearestCities(48.8049, 2.1204, 3, 100.0);
+
+        // ASSERT : Paris (17 km), Londres (~340 km), Lyon (~400 km) ; Tokyo écarté
+        QCOMPARE(nearest, QList<CityKey>({CityKey("paris"), CityKey("london"), CityKey("lyon")}));
+        QCOMPARE(withinRadius, QList<CityKey>({CityKey("paris")}));
+    }
+
+    void testCitiesInAreaAcrossAntimeridian() {
+        // ARRANGE
+        m_cache->storeCachedWeather(CityKey("Auckland"), located("Auckland", -36.8485, 174.7633));
+        m_cache->storeCachedWeather(CityKey("Suva"), located("Suva", -18.1248, 178.4501));
+        m_cache->storeCachedWeather(CityKey("Apia"), located("Apia", -13.8333, -171.7667));
+        m_cache->storeCachedWeather(CityKey("Honolulu"), located("Honolulu", 21.3069, -157.8583));
+        m_cache->storeCachedWeather(CityKey("Paris"), located("Paris", 48.8566, 2.3522));
+
+        // ACT : vue de carte non ramenée dans [-180, 180] (170°E → 170°O)
+        const QList<CityKey> found = m_cache->citiesInArea(QRectF(QPointF(170.0, -40.0), QPointF(190.0, 0.0)));
+
+        // ASSERT
+        const QSet<CityKey> expected{CityKey("auckland"), CityKey("suva"), CityKey("apia")};
+        QCOMPARE(QSet<CityKey>(found.cbegin(), found.cend()), expected);
+        QCOMPARE(found.size(), 3);
+    }
+
+    void testSpatialIndexFollowsCacheEntries() {
+        // ARRANGE
+        const QRectF france(QPointF(-5.0, 42.0), QPointF(8.0, 51.0));
+        m_cache->storeCachedWeather(CityKey("Paris"), located("Paris", 48.8566, 2.3522));
+        m_cache->storeCachedWeather(CityKey("Lyon"), located("Lyon", 45.7640, 4.8357));
+
+        // ACT : entrée remplacée avec une autre position, puis retrait du cache
+        m_cache->storeCachedWeather(CityKey("Lyon"), located("Lyon", 35.6762, 139.6503));
+        const int afterMove = m_cache->citiesInArea(france).size();
+        m_cache->clear();
+
+        // ASSERT : l'index suit les stockages et le vidage
+        QCOMPARE(afterMove, 1);
+        QVERIFY(m_cache->citiesInArea(france).isEmpty());
+        QVERIFY(m_cache->nearestCities(48.8566, 2.3522, 1).isEmpty());
     }
 
     // ========================================
@@ -204,10 +573,10 @@ private slots:
         CurrentWeatherData data = createTestWeather("");
 
         // ACT
-        m_cache->storeCachedWeather("", data);
+        m_cache->storeCachedWeather(CityKey(""), data);
 
         // ASSERT
-        QVERIFY(m_cache->isValid("", "weather"));
+        QVERIFY(m_cache->isValid(CityKey(""), WeatherDataType::Weather));
     }
 
     void testSpecialCharacters() {
@@ -215,10 +584,10 @@ private slots:
         QString specialCity = "Saint-Étienne";
 
         // ACT
-        m_cache->storeCachedWeather(specialCity, createTestWeather(specialCity));
+        m_cache->storeCachedWeather(CityKey(specialCity), createTestWeather(specialCity));
 
         // ASSERT
-        QVERIFY(m_cache->isValid(specialCity, "weather"));
+        QVERIFY(m_cache->isValid(CityKey(specialCity), WeatherDataType::Weather));
     }
 };
 
@@ -0,0 +1,1096 @@
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include "../../src/logpanel.h"
+#include "../../src/searchhistorymodel.h"
+#include "../../src/SearchHistory.h"
+#include "../../src/citytrie.h"
+#include "../../src/historyjournal.h"
+#include "../../src/dashboardmodel.h"
+#include "../../src/dashboardwidget.h"
+#include "../../src/weathercachemanager.h"
+#include "../../src/maptilecache.h"
+#include "../../src/mapcanvas.h"
+#include "../../src/simplemapwidget.h"
+#include "../../src/heatmapgrid.h"
+#include <QPushButton>
+#include <QSortFilterProxyModel>
+#include <QTableView>
+#include <QTemporaryDir>
+#include <QtConcurrent>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <cmath>
+
+/**
+ * Composants d'interface à coût borné (journal, listes, tableaux)
+ */
+class TestUiComponents : public QObject
+{
+    Q_OBJECT
+
+private:
+    SearchHistory* m_history = nullptr;
+
+    static CurrentWeatherData weather(const QString& city, double temperature) {
+        CurrentWeatherData data;
+        data.cityName = city;
+        data.countryCode = "FR";
+        data.temperature = temperature;
+        data.windSpeed = 3.0;
+        data.description = "ciel dégagé";
+        data.timestamp = QDateTime::currentDateTime();
+        return data;
+    }
+
+    // Entrée d'historique à date fixe : classement décidé par favori puis fréquence
+    static SearchHistoryEntry historyEntry(const QString& city, int searchCount, bool favorite = false) {
+        SearchHistoryEntry entry(city);
+        entry.searchCount = searchCount;
+        entry.isFavorite = favorite;
+        entry.lastAccess = QDateTime(QDate(2024, 1, 1), QTime(12, 0));
+        return entry;
+    }
+
+    static HistoryMutation mutation(HistoryMutation::Type type, const QString& city, bool favorite = false) {
+        HistoryMutation result;
+        result.type = type;
+        result.cityName = city;
+        result.time = QDateTime(QDate(2024, 1, 1), QTime(12, 0));
+        result.favorite = favorite;
+        return result;
+    }
+
+    // Fichiers de l'historique (dossier de test de QStandardPaths)
+    static QString historyPath(const QString& suffix) {
+        return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/search_history" + suffix;
+    }
+
+    // Redémarrage : le journal est vidé sur disque puis relu
+    void reloadHistory() {
+        delete m_history;
+        m_history = new SearchHistory();
+    }
+
+    static QStringList rows(const SearchHistoryModel& model) {
+        QStringList names;
+        for (int i = 0; i < model.rowCount(); ++i) {
+            names.append(model.cityAt(i));
+        }
+        return names;
+    }
+
+private slots:
+    void initTestCase() {
+        // Fichiers d'historique dans un dossier de test, pas celui de l'utilisateur
+        QStandardPaths::setTestModeEnabled(true);
+    }
+
+    void init() {
+        m_history = new SearchHistory();
+        m_history->clearHistory();
+    }
+
+    void cleanup() {
+        if (m_history) {
+            m_history->clearHistory();
+        }
+        delete m_history;
+        m_history = nullptr;
+    }
+
+    // ========================================
+    // TESTS DU JOURNAL
+    // ========================================
+
+    void testLogAppendsCoalescedPerFrame() {
+        // ARRANGE
+        LogPanel log;
+
+        // ACT : rafale de 100 lignes dans la même image
+        for (int i = 0; i < 100; ++i) {
+            log.append(QString("ligne %1").arg(i));
+        }
+        const int documentBefore = log.document()->blockCount();
+        QTRY_COMPARE(log.pendingCount(), 0);
+
+        // ASSERT : rien avant l'image, puis un seul ajout au document
+        QCOMPARE(documentBefore, 1); // Document vide : un bloc
+        QCOMPARE(log.flushCount(), qint64(1));
+        QCOMPARE(log.document()->blockCount(), 100);
+        QCOMPARE(log.document()->lastBlock().text(), QString("ligne 99"));
+    }
+
+    void testLogKeepsOnlyCapacityLines() {
+        // ARRANGE
+        LogPanel log(nullptr, 50);
+
+        // ACT : deux rafales, la seconde plus grande que la capacité
+        for (int i = 0; i < 30; ++i) log.append(QString("a%1").arg(i));
+        log.flush();
+        for (int i = 0; i < 80; ++i) log.append(QString("b%1").arg(i));
+        log.flush();
+
+        // ASSERT : les 50 lignes les plus récentes, dans l'ordre
+        QCOMPARE(log.document()->blockCount(), 50);
+        QCOMPARE(log.document()->firstBlock().text(), QString("b30"));
+        QCOMPARE(log.document()->lastBlock().text(), QString("b79"));
+        QCOMPARE(log.droppedCount(), qint64(30));
+    }
+
+    void testLogCapacityChangeFlushesPending() {
+        // ARRANGE
+        LogPanel log;
+        log.append("en attente");
+
+        // ACT
+        log.setCapacity(10);
+
+        // ASSERT
+        QCOMPARE(log.pendingCount(), 0);
+        QCOMPARE(log.capacity(), 10);
+        QCOMPARE(log.document()->lastBlock().text(), QString("en attente"));
+    }
+
+    // ========================================
+    // TESTS DES MODÈLES D'HISTORIQUE
+    // ========================================
+
+    void testRecentModelMovesRepeatedSearchToTop() {
+        // ARRANGE
+        SearchHistoryModel model(m_history, SearchHistoryModel::Mode::Recent);
+        m_history->addSearch("Paris");
+        m_history->addSearch("Lyon");
+        m_history->addSearch("Nice");
+        QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+        QSignalSpy moved(&model, &QAbstractItemModel::rowsMoved);
+        QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+
+        // ACT : même ville, autre graphie
+        m_history->addSearch("  PARIS ");
+
+        // ASSERT : un seul déplacement, pas de rechargement
+        QCOMPARE(rows(model), QStringList({"Paris", "Nice", "Lyon"}));
+        QCOMPARE(moved.count(), 1);
+        QCOMPARE(inserted.count(), 0);
+        QCOMPARE(reset.count(), 0);
+        QCOMPARE(model.index(0).data(SearchHistoryModel::SearchCountRole).toInt(), 2);
+    }
+
+    void testFavoritesModelInsertsInOrder() {
+        // ARRANGE
+        SearchHistoryModel model(m_history, SearchHistoryModel::Mode::Favorites);
+        QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+
+        // ACT
+        m_history->addToFavorites("Nice");
+        m_history->addToFavorites("bordeaux");
+        m_history->addToFavorites("Lyon");
+        m_history->removeFromFavorites("Nice");
+
+        // ASSERT
+        QCOMPARE(rows(model), QStringList({"bordeaux", "Lyon"}));
+        QCOMPARE(inserted.count(), 3);
+        QCOMPARE(inserted.at(2).at(1).toInt(), 1); // Lyon entre bordeaux et Nice
+    }
+
+    void testRecentModelFollowsRemovalAndEviction() {
+        // ARRANGE : dates de recherche distinctes (ordre d'éviction déterministe)
+        SearchHistoryModel model(m_history, SearchHistoryModel::Mode::Recent);
+        m_history->setMaxHistorySize(3);
+        for (const QString& city : {"Paris", "Lyon", "Nice"}) {
+            m_history->addSearch(city);
+            QTest::qWait(5);
+        }
+        QSignalSpy removed(&model, &QAbstractItemModel::rowsRemoved);
+
+        // ACT : suppression, puis quatrième ville au-delà de la limite (Paris évincée)
+        m_history->removeSearch("lyon");
+        m_history->addSearch("Lille");
+        QTest::qWait(5);
+        m_history->addSearch("Brest");
+
+        // ASSERT
+        QCOMPARE(rows(model), QStringList({"Brest", "Lille", "Nice"}));
+        QCOMPARE(model.rowOf("Paris"), -1);
+        QCOMPARE(removed.count(), 2);
+    }
+
+    void testNewSearchSurvivesFullHistoryOfFrequentCities() {
+        // ARRANGE : historique plein, chaque ville recherchée deux fois
+        SearchHistoryModel model(m_history, SearchHistoryModel::Mode::Recent);
+        m_history->setMaxHistorySize(3);
+        for (int pass = 0; pass < 2; ++pass) {
+            for (const QString& city : {"Paris", "Lyon", "Nice"}) {
+                m_history->addSearch(city);
+                QTest::qWait(5);
+            }
+        }
+        QSignalSpy recorded(m_history, &SearchHistory::searchRecorded);
+
+        // ACT : nouvelle ville (1 recherche, la moins bien classée)
+        m_history->addSearch("Brest");
+
+        // ASSERT : elle reste, la moins bien classée des anciennes part ; aucune ligne vide
+        QCOMPARE(recorded.count(), 1);
+        QCOMPARE(recorded.first().at(0).toString(), QString("Brest"));
+        QCOMPARE(rows(model), QStringList({"Brest", "Nice", "Lyon"}));
+        QCOMPARE(model.rowOf(""), -1);
+        QCOMPARE(rows(model), m_history->getRecentSearches());
+    }
+
+    void testClearResetsModels() {
+        // ARRANGE
+        SearchHistoryModel recent(m_history, SearchHistoryModel::Mode::Recent);
+        SearchHistoryModel favorites(m_history, SearchHistoryModel::Mode::Favorites);
+        m_history->addSearch("Paris");
+        m_history->addToFavorites("Paris");
+
+        // ACT
+        m_history->clearHistory();
+
+        // ASSERT
+        QCOMPARE(recent.rowCount(), 0);
+        QCOMPARE(favorites.rowCount(), 0);
+    }
+
+    // ========================================
+    // TESTS DE LA PERSISTANCE DE L'HISTORIQUE
+    // ========================================
+
+    void testJournalReplaysLogAfterSnapshot() {
+        // ARRANGE
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString snapshotPath = dir.filePath("history.snapshot");
+        const QString logPath = dir.filePath("history.log");
+        {
+            HistoryJournal journal(snapshotPath, logPath);
+            journal.compact({historyEntry("Paris", 2)});
+            journal.append({mutation(HistoryMutation::Search, "Lyon"),
+                            mutation(HistoryMutation::Favorite, "Paris", true)});
+            journal.append({mutation(HistoryMutation::Remove, "Lyon")});
+        }
+
+        // ACT
+        QList<SearchHistoryEntry> entries;
+        quint64 generation = 0;
+        const bool hasSnapshot = HistoryJournal::readSnapshot(snapshotPath, entries, &generation);
+        const QList<HistoryMutation> log = HistoryJournal::readLog(logPath, generation);
+
+        // ASSERT : snapshot intact (génération 1 après un compactage), lots ajoutés dans l'ordre
+        QVERIFY(hasSnapshot);
+        QCOMPARE(generation, quint64(1));
+        QCOMPARE(entries.size(), 1);
+        QCOMPARE(entries.first().cityName, QString("Paris"));
+        QCOMPARE(entries.first().searchCount, 2);
+        QCOMPARE(log.size(), 3);
+        QCOMPARE(log.at(0).type, HistoryMutation::Search);
+        QCOMPARE(log.at(0).cityName, QString("Lyon"));
+        QCOMPARE(log.at(1).type, HistoryMutation::Favorite);
+        QVERIFY(log.at(1).favorite);
+        QCOMPARE(log.at(2).type, HistoryMutation::Remove);
+        QCOMPARE(log.at(2).time, QDateTime(QDate(2024, 1, 1), QTime(12, 0)));
+    }
+
+    void testJournalTruncatedRecordEndsReplay() {
+        // ARRANGE : arrêt brutal au milieu du dernier enregistrement
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString logPath = dir.filePath("history.log");
+        {
+            HistoryJournal journal(dir.filePath("history.snapshot"), logPath);
+            journal.append({mutation(HistoryMutation::Search, "Paris"),
+                            mutation(HistoryMutation::Search, "Lyon"),
+                            mutation(HistoryMutation::Search, "Nice")});
+        }
+        QFile log(logPath);
+        QVERIFY(log.resize(log.size() - 3));
+        const qint64 damagedSize = log.size();
+
+        // ACT
+        qint64 validSize = 0;
+        const QList<HistoryMutation> mutations = HistoryJournal::readLog(logPath, 0, &validSize);
+        const bool truncated = HistoryJournal::truncateLog(logPath, validSize);
+
+        // ASSERT : enregistrements complets conservés, le reste ignoré puis coupé
+        QCOMPARE(mutations.size(), 2);
+        QCOMPARE(mutations.at(1).cityName, QString("Lyon"));
+        QVERIFY(validSize > 0);
+        QVERIFY(validSize < damagedSize);
+        QVERIFY(truncated);
+        QCOMPARE(QFileInfo(logPath).size(), validSize);
+        QCOMPARE(HistoryJournal::readLog(logPath, 0).size(), 2);
+    }
+
+    void testSearchesAfterCorruptLogTailSurviveReload() {
+        // ARRANGE : octets illisibles en fin de journal (écriture interrompue)
+        m_history->addSearch("Paris");
+        delete m_history;
+        m_history = nullptr;
+        QFile log(historyPath(".log"));
+        QVERIFY(log.open(QIODevice::Append));
+        log.write(QByteArray("\x01\xff\xff", 3));
+        log.close();
+
+        // ACT : redémarrage, nouvelle recherche, redémarrage
+        m_history = new SearchHistory();
+        m_history->addSearch("Lyon");
+        reloadHistory();
+
+        // ASSERT : la recherche écrite après la queue abîmée est relue
+        QCOMPARE(m_history->getSearchCount("Paris"), 1);
+        QCOMPARE(m_history->getSearchCount("Lyon"), 1);
+    }
+
+    void testLogWithInvalidHeaderReplacedOnLoad() {
+        // ARRANGE : journal d'un autre format
+        delete m_history;
+        m_history = nullptr;
+        QFile log(historyPath(".log"));
+        QVERIFY(log.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        log.write("not a history log");
+        log.close();
+
+        // ACT
+        m_history = new SearchHistory();
+        m_history->addSearch("Nice");
+        reloadHistory();
+
+        // ASSERT : journal recommencé avec un en-tête valide
+        QCOMPARE(m_history->getSearchCount("Nice"), 1);
+    }
+
+    void testLogOfOlderGenerationNotReplayed() {
+        // ARRANGE : arrêt entre l'écriture du snapshot et la remise à zéro du journal,
+        // simulé par un compactage qui vide un autre journal
+        delete m_history;
+        m_history = nullptr;
+        QFile::remove(historyPath(".snapshot"));
+        QFile::remove(historyPath(".log"));
+        {
+            HistoryJournal journal(historyPath(".snapshot"), historyPath(".log"));
+            journal.append({mutation(HistoryMutation::Search, "Paris")});
+        }
+        {
+            HistoryJournal journal(historyPath(".snapshot"), historyPath(".other.log"));
+            QVERIFY(journal.compact({historyEntry("Paris", 1)}));
+        }
+        QFile::remove(historyPath(".other.log"));
+
+        // ACT
+        m_history = new SearchHistory();
+
+        // ASSERT : la recherche du journal, déjà dans le snapshot, n'est pas comptée deux fois
+        QCOMPARE(m_history->getSearchCount("Paris"), 1);
+    }
+
+    void testBatchKeptWhenCompactionFails() {
+        // ARRANGE : snapshot impossible à écrire (un dossier occupe son chemin)
+        delete m_history;
+        m_history = nullptr;
+        QFile::remove(historyPath(".snapshot"));
+        QFile::remove(historyPath(".log"));
+        QVERIFY(QDir().mkpath(historyPath(".snapshot")));
+        m_history = new SearchHistory();
+
+        // ACT : assez de recherches pour déclencher un compactage
+        for (int i = 0; i < 1001; ++i) {
+            m_history->addSearch("Paris");
+        }
+        reloadHistory();
+        const int count = m_history->getSearchCount("Paris");
+        delete m_history;
+        m_history = nullptr;
+        QDir(historyPath(".snapshot")).removeRecursively();
+        m_history = new SearchHistory();
+
+        // ASSERT : le lot est passé au journal au lieu d'être perdu
+        QCOMPARE(count, 1001);
+    }
+
+    void testHistoryRestoredFromJournal() {
+        // ARRANGE
+        m_history->addSearch("Paris");
+        m_history->addSearch("paris");
+        m_history->addSearch("Lyon");
+        m_history->addSearch("Nice");
+        m_history->addToFavorites("Nice");
+        m_history->removeSearch("Lyon");
+
+        // ACT
+        reloadHistory();
+
+        // ASSERT : même état que les opérations en direct
+        QCOMPARE(m_history->getSearchCount("Paris"), 2);
+        QCOMPARE(m_history->getSearchCount("Lyon"), 0);
+        QVERIFY(m_history->isFavorite("Nice"));
+        QCOMPARE(m_history->getFavorites(), QStringList({"Nice"}));
+        QCOMPARE(m_history->getSuggestions("pa", 5), QStringList({"Paris"}));
+    }
+
+    void testHistoryCompactsPastThreshold() {
+        // ARRANGE : plus de max(1000, 4 x entrées) enregistrements en attente
+        for (int i = 0; i < 1001; ++i) {
+            m_history->addSearch("Paris");
+        }
+
+        // ACT
+        reloadHistory();
+
+        // ASSERT : snapshot réécrit, journal repart à vide
+        QList<SearchHistoryEntry> entries;
+        quint64 generation = 0;
+        QVERIFY(HistoryJournal::readSnapshot(historyPath(".snapshot"), entries, &generation));
+        QCOMPARE(entries.size(), 1);
+        QCOMPARE(entries.first().searchCount, 1001);
+        QVERIFY(HistoryJournal::readLog(historyPath(".log"), generation).isEmpty());
+        QCOMPARE(m_history->getSearchCount("Paris"), 1001);
+    }
+
+    void testLegacyJsonMigratedToSnapshot() {
+        // ARRANGE : seul l'ancien fichier JSON existe
+        delete m_history;
+        m_history = nullptr;
+        QFile::remove(historyPath(".snapshot"));
+        QFile::remove(historyPath(".log"));
+
+        QJsonArray hours;
+        for (int h = 0; h < 24; ++h) hours.append(h == 8 ? 3 : 0);
+        QJsonObject lyon{{"city", "Lyon"}, {"count", 3}, {"favorite", false}, {"hours", hours},
+                         {"searchTime", "2024-01-01T08:00:00"}, {"lastAccess", "2024-01-02T08:00:00"}};
+        QJsonObject nice{{"city", "Nice"}, {"count", 1}, {"favorite", true},
+                         {"searchTime", "2024-01-01T09:00:00"}, {"lastAccess", "2024-01-01T09:00:00"}};
+        QFile legacy(historyPath(".json"));
+        QVERIFY(legacy.open(QIODevice::WriteOnly));
+        legacy.write(QJsonDocument(QJsonObject{{"entries", QJsonArray{lyon, nice}}}).toJson());
+        legacy.close();
+
+        // ACT : lecture du JSON, puis premier enregistrement
+        m_history = new SearchHistory();
+        const int lyonCount = m_history->getSearchCount("Lyon");
+        const QStringList atEight = m_history->getSearchesForHour(8);
+        reloadHistory();
+        QFile::remove(historyPath(".json"));
+
+        // ASSERT : entrées reprises, snapshot binaire écrit
+        QCOMPARE(lyonCount, 3);
+        QCOMPARE(atEight, QStringList({"Lyon"}));
+        QList<SearchHistoryEntry> entries;
+        QVERIFY(HistoryJournal::readSnapshot(historyPath(".snapshot"), entries));
+        QCOMPARE(entries.size(), 2);
+        QVERIFY(m_history->isFavorite("Nice"));
+        QCOMPARE(m_history->getLastSearchTime("Lyon"), QDateTime(QDate(2024, 1, 2), QTime(8, 0)));
+    }
+
+    // ========================================
+    // TESTS DU TRIE DE SUGGESTIONS
+    // ========================================
+
+    void testTrieUpsertKeepsTopK() {
+        // ARRANGE : deux meilleurs éléments par nœud
+        CityTrie trie(2);
+        trie.upsert("paris", historyEntry("Paris", 1));
+        trie.upsert("pau", historyEntry("Pau", 2));
+        trie.upsert("pamiers", historyEntry("Pamiers", 3));
+        QCOMPARE(trie.suggestions("pa", 5), QStringList({"Pamiers", "Pau"}));
+
+        // ACT : Paris progresse
+        trie.upsert("paris", historyEntry("Paris", 5));
+
+        // ASSERT
+        QCOMPARE(trie.suggestions("pa", 5), QStringList({"Paris", "Pamiers"}));
+        QCOMPARE(trie.suggestions("", 5), QStringList({"Paris", "Pamiers"}));
+        QCOMPARE(trie.suggestions("pau", 5), QStringList({"Pau"}));
+        QCOMPARE(trie.size(), 3);
+    }
+
+    void testTrieDemotionRecomputesFromChildren() {
+        // ARRANGE : Pamiers hors du top-2 de "pa", gardé par sa feuille
+        CityTrie trie(2);
+        trie.upsert("paris", historyEntry("Paris", 1, true));
+        trie.upsert("pau", historyEntry("Pau", 3));
+        trie.upsert("pamiers", historyEntry("Pamiers", 2));
+        QCOMPARE(trie.suggestions("pa", 5), QStringList({"Paris", "Pau"}));
+
+        // ACT : Paris retiré des favoris (removeFromFavorites)
+        trie.upsert("paris", historyEntry("Paris", 1, false));
+
+        // ASSERT : Pamiers remonte, Paris redescend
+        QCOMPARE(trie.suggestions("pa", 5), QStringList({"Pau", "Pamiers"}));
+        QCOMPARE(trie.suggestions("par", 5), QStringList({"Paris"}));
+    }
+
+    void testTrieRemoveRefillsTopK() {
+        // ARRANGE
+        CityTrie trie(2);
+        trie.upsert("paris", historyEntry("Paris", 3));
+        trie.upsert("pau", historyEntry("Pau", 2));
+        trie.upsert("pamiers", historyEntry("Pamiers", 1));
+
+        // ACT
+        trie.remove("paris");
+
+        // ASSERT : l'élément suivant comble la place, plus rien sous "par"
+        QCOMPARE(trie.suggestions("pa", 5), QStringList({"Pau", "Pamiers"}));
+        QVERIFY(trie.suggestions("par", 5).isEmpty());
+        QCOMPARE(trie.size(), 2);
+    }
+
+    void testTrieRemoveKeepsDictionaryName() {
+        // ARRANGE : Pau à la fois recherchée et connue du dictionnaire
+        CityTrie trie;
+        trie.addDictionaryName("pau", "Pau", 77000);
+        trie.upsert("pau", historyEntry("Pau", 4));
+        trie.upsert("pamiers", historyEntry("Pamiers", 1));
+        QCOMPARE(trie.suggestions("pa", 5), QStringList({"Pau", "Pamiers"}));
+
+        // ACT
+        trie.remove("pau");
+
+        // ASSERT : toujours suggérée, mais après l'historique
+        QCOMPARE(trie.suggestions("pa", 5), QStringList({"Pamiers", "Pau"}));
+        QCOMPARE(trie.size(), 2);
+    }
+
+    void testTrieEdgeSplits() {
+        // ARRANGE : "paris" seul, puis des clés qui coupent son arête
+        CityTrie trie;
+        trie.upsert("paris", historyEntry("Paris", 2));
+
+        // ACT : "par" + "is"/"me", puis "pa" + "r"/"u", puis une clé sur le nœud de découpe
+        trie.upsert("parme", historyEntry("Parme", 1));
+        trie.upsert("pau", historyEntry("Pau", 3));
+        trie.upsert("par", historyEntry("Par", 1));
+
+        // ASSERT : chaque préfixe voit tout son sous-arbre, dans l'ordre
+        QCOMPARE(trie.suggestions("p", 5), QStringList({"Pau", "Paris", "Par", "Parme"}));
+        QCOMPARE(trie.suggestions("par", 5), QStringList({"Paris", "Par", "Parme"}));
+        QCOMPARE(trie.suggestions("pari", 5), QStringList({"Paris"}));
+        QCOMPARE(trie.suggestions("parm", 5), QStringList({"Parme"}));
+        QVERIFY(trie.suggestions("pax", 5).isEmpty());
+        QVERIFY(trie.suggestions("parisx", 5).isEmpty());
+    }
+
+    void testTrieDictionaryRanksAfterHistory() {
+        // ARRANGE : noms du gazetteer classés par population
+        CityTrie trie;
+        trie.addDictionaryName("pamiers", "Pamiers", 15000);
+        trie.addDictionaryName("paris", "Paris", 2100000);
+        trie.addDictionaryName("pau", "Pau", 77000);
+
+        // ACT : une seule ville recherchée
+        trie.upsert("pamiers", historyEntry("Pamiers", 1));
+
+        // ASSERT : historique d'abord, puis dictionnaire par poids décroissant
+        QCOMPARE(trie.suggestions("pa", 5), QStringList({"Pamiers", "Paris", "Pau"}));
+        QCOMPARE(trie.suggestions("pa", 2), QStringList({"Pamiers", "Paris"}));
+    }
+
+    // ========================================
+    // TESTS DU TABLEAU DE BORD
+    // ========================================
+
+    void testDashboardLoadsCachedCities() {
+        // ARRANGE
+        weathercachemanager cache;
+        cache.storeCachedWeather(CityKey("Paris"), weather("Paris", 21.0));
+        cache.storeCachedWeather(CityKey("Lyon"), weather("Lyon", 18.5));
+
+        // ACT
+        DashboardModel model(&cache);
+        const int lyon = model.rowOf(CityKey("lyon"));
+
+        // ASSERT : valeurs lues dans le cache
+        QCOMPARE(model.rowCount(), 2);
+        QCOMPARE(model.columnCount(), int(DashboardModel::ColumnCount));
+        QVERIFY(lyon >= 0);
+        QCOMPARE(model.index(lyon, DashboardModel::TemperatureColumn).data().toString(), QString("18.5°C"));
+        QCOMPARE(model.index(lyon, DashboardModel::TemperatureColumn).data(DashboardModel::SortRole).toDouble(), 18.5);
+        QCOMPARE(model.index(lyon, DashboardModel::CityColumn).data().toString(), QString("Lyon, FR"));
+    }
+
+    void testDashboardCoalescesUpdates() {
+        // ARRANGE
+        weathercachemanager cache;
+        for (int i = 0; i < 10; ++i) {
+            cache.storeCachedWeather(CityKey(QString("Ville %1").arg(i)), weather(QString("Ville %1").arg(i), i));
+        }
+        DashboardModel model(&cache);
+        QSignalSpy changed(&model, &QAbstractItemModel::dataChanged);
+        QSignalSpy inserted(&model, &QAbstractItemModel::rowsInserted);
+
+        // ACT : rafale de notifications (lignes 2 à 5, deux fois chacune) + 3 nouvelles villes
+        for (int pass = 0; pass < 2; ++pass) {
+            for (int row = 2; row <= 5; ++row) {
+                model.cityUpdated(model.keyAt(row), model.cityAt(row));
+            }
+        }
+        for (int i = 10; i < 13; ++i) {
+            const QString name = QString("Ville %1").arg(i);
+            cache.storeCachedWeather(CityKey(name), weather(name, i));
+            model.cityUpdated(CityKey(name), name);
+        }
+        const int changesBeforeFlush = changed.count();
+        QTRY_COMPARE(model.pendingCount(), 0);
+
+        // ASSERT : rien avant le flush, puis une plage contiguë et une insertion
+        QCOMPARE(changesBeforeFlush, 0);
+        QCOMPARE(changed.count(), 1);
+        QCOMPARE(changed.first().at(0).toModelIndex().row(), 2);
+        QCOMPARE(changed.first().at(1).toModelIndex().row(), 5);
+        QCOMPARE(inserted.count(), 1);
+        QCOMPARE(model.rowCount(), 13);
+    }
+
+    void testDashboardRemovesEvictedCities() {
+        // ARRANGE
+        weathercachemanager cache;
+        cache.storeCachedWeather(CityKey("Paris"), weather("Paris", 20.0));
+        cache.storeCachedWeather(CityKey("Lyon"), weather("Lyon", 18.0));
+        DashboardModel model(&cache);
+
+        // ACT : entrée retirée du cache puis notifiée
+        cache.clear();
+        cache.storeCachedWeather(CityKey("Lyon"), weather("Lyon", 19.0));
+        model.cityUpdated(CityKey("Paris"), "Paris");
+        model.flush();
+
+        // ASSERT
+        QCOMPARE(model.rowCount(), 1);
+        QCOMPARE(model.rowOf(CityKey("paris")), -1);
+        QCOMPARE(model.rowOf(CityKey("lyon")), 0);
+    }
+
+    void testDashboardProxySortsAndFilters() {
+        // ARRANGE
+        weathercachemanager cache;
+        cache.storeCachedWeather(CityKey("Paris"), weather("Paris", 9.5));
+        cache.storeCachedWeather(CityKey("Lyon"), weather("Lyon", 12.0));
+        cache.storeCachedWeather(CityKey("Lille"), weather("Lille", 10.0));
+        DashboardWidget dashboard(&cache);
+        QSortFilterProxyModel* proxy = dashboard.proxy();
+
+        // ACT : tri numérique sur la température, puis filtre
+        proxy->sort(DashboardModel::TemperatureColumn, Qt::DescendingOrder);
+        const QString warmest = proxy->index(0, DashboardModel::CityColumn).data().toString();
+        const QString coldest = proxy->index(2, DashboardModel::CityColumn).data().toString();
+        proxy->setFilterFixedString("l");
+
+        // ASSERT : 12 > 10 > 9.5 (et non l'ordre du texte), filtre sans toucher au modèle
+        QCOMPARE(warmest, QString("Lyon, FR"));
+        QCOMPARE(coldest, QString("Paris, FR"));
+        QCOMPARE(proxy->rowCount(), 2);
+        QCOMPARE(dashboard.model()->rowCount(), 3);
+    }
+
+    void testDashboardPublishesVisibleCities() {
+        // ARRANGE : plus de villes que de lignes à l'écran
+        weathercachemanager cache;
+        for (int i = 0; i < 200; ++i) {
+            const QString name = QString("Ville %1").arg(i, 3, 10, QLatin1Char('0'));
+            cache.storeCachedWeather(CityKey(name), weather(name, i));
+        }
+        DashboardWidget dashboard(&cache);
+        dashboard.resize(600, 300);
+        QSignalSpy visible(&dashboard, &DashboardWidget::visibleCitiesChanged);
+
+        // ACT
+        dashboard.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&dashboard));
+        QTRY_VERIFY(visible.count() > 0);
+        const QStringList first = visible.last().at(0).toStringList();
+        dashboard.view()->scrollToBottom();
+        QTRY_VERIFY(visible.last().at(0).toStringList() != first);
+        const QStringList last = visible.last().at(0).toStringList();
+
+        // ASSERT : seules les lignes à l'écran, dans l'ordre affiché
+        QVERIFY(!first.isEmpty());
+        QVERIFY(first.size() < 200);
+        QCOMPARE(CityKey(first.first()), CityKey("Ville 000"));
+        QCOMPARE(CityKey(last.last()), CityKey("Ville 199"));
+    }
+
+    void testDashboardComparesSelectedCities() {
+        // ARRANGE : tri par nom (Lille, Lyon, Paris)
+        weathercachemanager cache;
+        cache.storeCachedWeather(CityKey("Paris"), weather("Paris", 9.5));
+        cache.storeCachedWeather(CityKey("Lyon"), weather("Lyon", 12.0));
+        cache.storeCachedWeather(CityKey("Lille"), weather("Lille", 10.0));
+        DashboardWidget dashboard(&cache);
+        QPushButton* compare = dashboard.findChild<QPushButton*>();
+        QVERIFY(compare);
+        QSignalSpy requested(&dashboard, &DashboardWidget::comparisonRequested);
+        QItemSelectionModel* selection = dashboard.view()->selectionModel();
+
+        // ACT : une ville, puis deux (sélection dans le désordre)
+        selection->select(dashboard.proxy()->index(2, 0), QItemSelectionModel::Select | QItemSelectionModel::Rows);
+        const bool enabledWithOne = compare->isEnabled();
+        selection->select(dashboard.proxy()->index(0, 0), QItemSelectionModel::Select | QItemSelectionModel::Rows);
+        QTest::mouseClick(compare, Qt::LeftButton);
+
+        // ASSERT : bouton actif à partir de deux villes, ordre affiché
+        QVERIFY(!enabledWithOne);
+        QVERIFY(compare->isEnabled());
+        QCOMPARE(requested.count(), 1);
+        const QStringList cities = requested.first().at(0).toStringList();
+        QCOMPARE(cities.size(), 2);
+        QCOMPARE(CityKey(cities.at(0)), CityKey("Lille"));
+        QCOMPARE(CityKey(cities.at(1)), CityKey("Paris"));
+    }
+
+    // ========================================
+    // TESTS DE LA CARTE
+    // ========================================
+
+    void testTileCacheLoadsBundledCoastlines() {
+        // ARRANGE
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        MapTileCache tiles(dir.path());
+
+        // ACT
+        const bool loaded = tiles.loadCoastlines();
+
+        // ASSERT : ressource embarquée, répertoire propre au jeu de données
+        QVERIFY(loaded);
+        QVERIFY(tiles.polygonCount() > 20);
+        QVERIFY(tiles.cacheDir().startsWith(dir.path() + "/"));
+    }
+
+    void testTileCacheServesMemoryThenDisk() {
+        // ARRANGE
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        MapTileCache first(dir.path());
+        QVERIFY(first.loadCoastlines());
+
+        // ACT : rendu, relecture mémoire, x hors limites ramené sur la même tuile
+        const QImage rendered = first.tile(1, 1, 0);
+        const QImage again = first.tile(1, 1, 0);
+        const QImage wrapped = first.tile(1, 1 - MapTileCache::tilesX(1), 0);
+        MapTileCache second(dir.path());
+        QVERIFY(second.loadCoastlines());
+        const QImage fromDisk = second.tile(1, 1, 0);
+
+        // ASSERT : rendu une seule fois, puis lu sur disque par une autre instance
+        QCOMPARE(rendered.size(), QSize(MapTileCache::TILE_SIZE, MapTileCache::TILE_SIZE));
+        QCOMPARE(first.renderedCount(), qint64(1));
+        QCOMPARE(first.memoryHits(), qint64(2));
+        QCOMPARE(again, rendered);
+        QCOMPARE(wrapped, rendered);
+        QCOMPARE(second.renderedCount(), qint64(0));
+        QCOMPARE(second.diskHits(), qint64(1));
+        QCOMPARE(fromDisk.convertToFormat(rendered.format()), rendered);
+        QVERIFY(first.tile(1, 0, MapTileCache::tilesY(1)).isNull());
+    }
+
+    void testTileCachePregeneratesOffThread() {
+        // ARRANGE
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        MapTileCache tiles(dir.path());
+        QVERIFY(tiles.loadCoastlines());
+        const std::atomic<bool> cancelled(true);
+        const int tileCount = MapTileCache::tilesX(0) * MapTileCache::tilesY(0)
+                              + MapTileCache::tilesX(1) * MapTileCache::tilesY(1);
+
+        // ACT : arrêt demandé d'emblée, puis génération sur un thread pendant que la vue lit une tuile
+        const int whenCancelled = tiles.pregenerate(1, &cancelled);
+        QFuture<int> generation = QtConcurrent::run([&tiles]() { return tiles.pregenerate(1); });
+        const QImage shown = tiles.tile(1, 3, 1);
+        const int generated = generation.result();
+        MapTileCache reader(dir.path());
+        QVERIFY(reader.loadCoastlines());
+        for (int zoom = 0; zoom <= 1; ++zoom) {
+            for (int y = 0; y < MapTileCache::tilesY(zoom); ++y) {
+                for (int x = 0; x < MapTileCache::tilesX(zoom); ++x) {
+                    QVERIFY(!reader.tile(zoom, x, y).isNull());
+                }
+            }
+        }
+
+        // ASSERT : chaque tuile écrite une fois entière, relue sans rendu
+        QCOMPARE(whenCancelled, 0);
+        QVERIFY(!shown.isNull());
+        QVERIFY(generated >= tileCount - 1);
+        QCOMPARE(reader.renderedCount(), qint64(0));
+        QCOMPARE(reader.diskHits(), qint64(tileCount));
+    }
+
+    void testTileProjectionRoundTrip() {
+        // ARRANGE
+        const double latitude = 48.8566;
+        const double longitude = 2.3522;
+
+        // ACT
+        const QPointF world = MapTileCache::project(latitude, longitude, 3);
+        const QPointF back = MapTileCache::unproject(world, 3);
+
+        // ASSERT : (lon, lat) retrouvés, origine au coin nord-ouest
+        QVERIFY(qAbs(back.x() - longitude) < 1e-9);
+        QVERIFY(qAbs(back.y() - latitude) < 1e-9);
+        QCOMPARE(MapTileCache::project(90.0, -180.0, 3), QPointF(0.0, 0.0));
+    }
+
+    void testCanvasPanRedrawsOnlyExposedTiles() {
+        // ARRANGE
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        MapTileCache tiles(dir.path());
+        QVERIFY(tiles.loadCoastlines());
+        MapCanvas canvas(&tiles);
+        canvas.resize(600, 400);
+        canvas.setZoom(2);
+        canvas.centerOn(20.0, 0.0);
+        canvas.grab();
+        const int fullCompose = canvas.lastTilesDrawn();
+
+        // ACT : petit déplacement horizontal
+        canvas.panBy(QPoint(-12, 0));
+        canvas.grab();
+        const int afterPan = canvas.lastTilesDrawn();
+
+        // ASSERT : seule la bande découverte est recomposée
+        QVERIFY(fullCompose >= 6);
+        QVERIFY(afterPan > 0);
+        QVERIFY(afterPan < fullCompose);
+    }
+
+    void testMapShowsOnlyOnScreenCachedCities() {
+        // ARRANGE
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        weathercachemanager cache;
+        CurrentWeatherData paris = weather("Paris", 21.0);
+        paris.latitude = 48.8566;
+        paris.longitude = 2.3522;
+        CurrentWeatherData sydney = weather("Sydney", 14.0);
+        sydney.latitude = -33.8688;
+        sydney.longitude = 151.2093;
+        cache.storeCachedWeather(CityKey("Paris"), paris);
+        cache.storeCachedWeather(CityKey("Sydney"), sydney);
+        SimpleMapWidget map(nullptr, dir.path());
+        MapCanvas* canvas = map.canvas();
+        canvas->resize(400, 300);
+        canvas->setZoom(3);
+        canvas->centerOn(paris.latitude, paris.longitude);
+        QSignalSpy clicked(&map, &SimpleMapWidget::cityClicked);
+
+        // ACT : marqueurs lus dans l'index spatial pour la vue courante
+        map.setCacheManager(&cache);
+        QTRY_COMPARE(canvas->markers().size(), 1);
+        canvas->grab();
+        QTest::mouseClick(canvas, Qt::LeftButton, Qt::NoModifier,
+                          canvas->toWidget(paris.latitude, paris.longitude).toPoint());
+        const QString beforeMove = canvas->markers().first().name;
+        canvas->centerOn(sydney.latitude, sydney.longitude);
+
+        // ASSERT : Sydney hors de la vue n'est pas chargée, clic → ville, déplacement → relecture
+        QCOMPARE(beforeMove, QString("Paris"));
+        QCOMPARE(canvas->lastMarkersDrawn(), 1);
+        QCOMPARE(clicked.count(), 1);
+        QCOMPARE(clicked.first().at(0).toString(), QString("Paris"));
+        QCOMPARE(canvas->markers().size(), 1);
+        QCOMPARE(canvas->markers().first().name, QString("Sydney"));
+    }
+
+    // ========================================
+    // TESTS DE LA CARTE DE CHALEUR
+    // ========================================
+
+    void testHeatmapInterpolatesBetweenCities() {
+        // ARRANGE : deux villes sur l'équateur, 10° d'écart
+        HeatmapGrid grid(2.0, 1500.0);
+        grid.setSample(CityKey("Ouest"), 0.0, 0.0, 10.0);
+        grid.setSample(CityKey("Est"), 0.0, 10.0, 20.0);
+
+        // ACT
+        const int computed = grid.update();
+
+        // ASSERT : valeur de la ville la plus proche, moyenne à mi-chemin, rien hors rayon
+        QVERIFY(computed > 0);
+        QVERIFY(!grid.isDirty());
+        QVERIFY(grid.valueAt(0.0, 0.0) < 11.0);
+        QVERIFY(qAbs(grid.valueAt(0.0, 5.0) - 15.0) < 0.01);
+        QVERIFY(std::isnan(grid.valueAt(-45.0, -120.0)));
+        QCOMPARE(grid.image().size(), QSize(grid.columns(), grid.rows()));
+        QVERIFY(qAlpha(grid.image().pixel(92, 45)) > 0);
+        QCOMPARE(qAlpha(grid.image().pixel(30, 67)), 0);
+    }
+
+    void testHeatmapRecomputesOnlyCellsNearUpdatedCity() {
+        // ARRANGE : villes réparties sur le globe
+        HeatmapGrid grid(2.0, 1500.0);
+        for (int i = 0; i < 60; ++i) {
+            grid.setSample(CityKey(QString("Ville %1").arg(i)), -60.0 + (i % 6) * 24.0, -170.0 + (i / 6) * 34.0, i);
+        }
+        const int fullGrid = grid.update();
+        const double before = grid.valueAt(-60.0, -170.0);
+
+        // ACT : mêmes valeurs (aucun effet), puis une seule ville modifiée
+        grid.setSample(CityKey("Ville 1"), -36.0, -170.0, 1.0);
+        const bool dirtyAfterSameValue = grid.isDirty();
+        grid.setSample(CityKey("Ville 0"), -60.0, -170.0, 100.0);
+        const int incremental = grid.update();
+
+        // ASSERT : seules les cases du rayon de la ville sont recalculées
+        QVERIFY(!dirtyAfterSameValue);
+        QVERIFY(incremental > 0);
+        QVERIFY(incremental * 10 < fullGrid);
+        QVERIFY(grid.valueAt(-60.0, -170.0) > before + 50.0);
+    }
+
+    void testMapHeatmapLayerFollowsCache() {
+        // ARRANGE
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        weathercachemanager cache;
+        CurrentWeatherData paris = weather("Paris", 21.0);
+        paris.latitude = 48.8566;
+        paris.longitude = 2.3522;
+        CurrentWeatherData madrid = weather("Madrid", 30.0);
+        madrid.latitude = 40.4168;
+        madrid.longitude = -3.7038;
+        cache.storeCachedWeather(CityKey("Paris"), paris);
+        SimpleMapWidget map(nullptr, dir.path());
+        map.setCacheManager(&cache);
+
+        // ACT : calque activé, puis nouvelle ville notifiée
+        map.setHeatmapLayer(HeatmapLayer::Temperature);
+        const bool overlayShown = !map.canvas()->overlay().isNull();
+        cache.storeCachedWeather(CityKey("Madrid"), madrid);
+        map.onCacheUpdated("Madrid", "weather");
+        QTRY_COMPARE(map.heatmap().sampleCount(), 2);
+        const double madridValue = map.heatmap().valueAt(madrid.latitude, madrid.longitude);
+        map.setHeatmapLayer(HeatmapLayer::None);
+
+        // ASSERT
+        QVERIFY(overlayShown);
+        QVERIFY(madridValue > 25.0);
+        QVERIFY(map.canvas()->overlay().isNull());
+    }
+
+    void benchmarkHeatmapFullGrid() {
+        // ARRANGE : 500 villes
+        HeatmapGrid grid;
+        QList<QPointF> positions;
+        for (int i = 0; i < 500; ++i) {
+            positions.append(QPointF(-170.0 + (i * 37) % 340, -60.0 + (i * 17) % 130));
+        }
+
+        // ACT : grille complète (lignes en parallèle)
+        QBENCHMARK {
+            grid.clear();
+            for (int i = 0; i < positions.size(); ++i) {
+                grid.setSample(CityKey(QString::number(i + 1)), positions[i].y(), positions[i].x(), i % 40);
+            }
+            grid.update();
+        }
+
+        QCOMPARE(grid.sampleCount(), 500);
+    }
+
+    void benchmarkDashboardUpdateBurst() {
+        // ARRANGE : 500 villes affichées
+        weathercachemanager cache;
+        for (int i = 0; i < 500; ++i) {
+            const QString name = QString("Ville %1").arg(i);
+            cache.storeCachedWeather(CityKey(name), weather(name, i % 40));
+        }
+        DashboardWidget dashboard(&cache);
+        dashboard.resize(800, 600);
+        dashboard.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&dashboard));
+        DashboardModel* model = dashboard.model();
+
+        // ACT : chaque ville mise à jour, une seule passe de notifications
+        QBENCHMARK {
+            for (int row = 0; row < model->rowCount(); ++row) {
+                model->cityUpdated(model->keyAt(row), model->cityAt(row));
+            }
+            model->flush();
+        }
+
+        QCOMPARE(model->pendingCount(), 0);
+    }
+
+    void benchmarkRepeatedSearchLargeHistory() {
+        // ARRANGE : 20 000 villes déjà dans l'historique
+        m_history->setMaxHistorySize(50000);
+        for (int i = 0; i < 20000; ++i) {
+            m_history->addSearch(QString("Ville %1").arg(i));
+        }
+        SearchHistoryModel model(m_history, SearchHistoryModel::Mode::Recent);
+        QSignalSpy reset(&model, &QAbstractItemModel::modelReset);
+
+        // ACT : recherches répétées de villes récentes (cas courant)
+        int next = 0;
+        QBENCHMARK {
+            m_history->addSearch(QString("Ville %1").arg(19999 - next++ % 20));
+        }
+
+        // ASSERT : jamais de rechargement complet
+        QCOMPARE(model.rowCount(), 20000);
+        QCOMPARE(reset.count(), 0);
+    }
+
+    void benchmarkHistoryLoad() {
+        // ARRANGE : snapshot de 5 000 villes + 900 enregistrements de journal
+        delete m_history;
+        m_history = nullptr;
+        QList<SearchHistoryEntry> entries;
+        for (int i = 0; i < 5000; ++i) {
+            entries.append(historyEntry(QString("Ville %1").arg(i), 1 + i % 7));
+        }
+        QList<HistoryMutation> log;
+        for (int i = 0; i < 900; ++i) {
+            log.append(mutation(HistoryMutation::Search, QString("Ville %1").arg(i % 50)));
+        }
+        {
+            HistoryJournal journal(historyPath(".snapshot"), historyPath(".log"));
+            journal.compact(entries);
+            journal.append(log);
+        }
+        const QDateTime snapshotWritten = QFileInfo(historyPath(".snapshot")).lastModified();
+
+        // ACT : démarrage = lecture du snapshot + relecture du journal, sans réécriture
+        int loaded = 0;
+        QBENCHMARK {
+            SearchHistory history;
+            loaded = history.getTotalSearches();
+        }
+
+        // ASSERT
+        int expected = 900;
+        for (const SearchHistoryEntry& entry : std::as_const(entries)) expected += entry.searchCount;
+        QCOMPARE(loaded, expected);
+        QCOMPARE(QFileInfo(historyPath(".snapshot")).lastModified(), snapshotWritten);
+        QList<SearchHistoryEntry> snapshot;
+        quint64 generation = 0;
+        QVERIFY(HistoryJournal::readSnapshot(historyPath(".snapshot"), snapshot, &generation));
+        QCOMPARE(HistoryJournal::readLog(historyPath(".log"), generation).size(), 900);
+        m_history = new SearchHistory();
+    }
+
+    void benchmarkLogBurst() {
+        // ARRANGE
+        LogPanel log;
+        log.resize(600, 120);
+
+        // ACT : 10 000 lignes par image, document déjà plein
+        QBENCHMARK {
+            for (int i = 0; i < 10000; ++i) {
+                log.append(QStringLiteral("💾 Cache mis à jour: Paris (forecast)"));
+            }
+            log.flush();
+        }
+
+        QCOMPARE(log.document()->blockCount(), LogPanel::DEFAULT_CAPACITY);
+    }
+};
+
+QTEST_MAIN(TestUiComponents)
+#include "tst_uicomponents.moc"
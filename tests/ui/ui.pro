@@ -0,0 +1,60 @@
+# tests/ui/ui.pro
+QT += testlib core gui widgets concurrent
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+CONFIG += c++17
+
+TEMPLATE = app
+TARGET = tst_uicomponents
+
+# Chemin vers le code source
+INCLUDEPATH += ../../src
+
+# Composants d'interface testés sans MainWindow ; sans affichage : QT_QPA_PLATFORM=offscreen
+SOURCES += \
+    tst_uicomponents.cpp
+
+# Code source à tester
+SOURCES += \
+    ../../src/logpanel.cpp \
+    ../../src/searchhistorymodel.cpp \
+    ../../src/searchhistory.cpp \
+    ../../src/citytrie.cpp \
+    ../../src/historyjournal.cpp \
+    ../../src/dashboardmodel.cpp \
+    ../../src/dashboardwidget.cpp \
+    ../../src/cityspatialindex.cpp \
+    ../../src/weathercachemanager.cpp \
+    ../../src/derivedmetrics.cpp \
+    ../../src/heatmapgrid.cpp \
+    ../../src/maptilecache.cpp \
+    ../../src/mapcanvas.cpp \
+    ../../src/simplemapwidget.cpp
+
+HEADERS += \
+    ../../src/logpanel.h \
+    ../../src/searchhistorymodel.h \
+    ../../src/SearchHistory.h \
+    ../../src/citytrie.h \
+    ../../src/historyjournal.h \
+    ../../src/dashboardmodel.h \
+    ../../src/dashboardwidget.h \
+    ../../src/cityspatialindex.h \
+    ../../src/weathercachemanager.h \
+    ../../src/ICacheManager.h \
+    ../../src/WeatherData.h \
+    ../../src/derivedmetrics.h \
+    ../../src/heatmapgrid.h \
+    ../../src/maptilecache.h \
+    ../../src/mapcanvas.h \
+    ../../src/simplemapwidget.h
+
+# Traits de côte de la carte
+RESOURCES += ../../src/resources.qrc
+
+# Définir les mêmes deprecated warnings
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
+
+# Sortie dans un dossier séparé
+DESTDIR = $$OUT_PWD/bin
@@ -0,0 +1,739 @@
+#include <QtTest>
+#include <QSignalSpy>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <cstring>
+#include <limits>
+#include "../../src/WeatherService.h"
+#include "../../src/refreshscheduler.h"
+#include "../../src/weatherprefetcher.h"
+#include "../../src/SearchHistory.h"
+#include "../../src/weathercachemanager.h"
+#include "../../src/weatherjsonparser.h"
+#include "../../src/citygazetteer.h"
+
+/**
+ * Réponse réseau simulée : renvoie un corps JSON fixe (ou une erreur) au prochain tour de boucle
+ */
+class FakeReply : public QNetworkReply
+{
+    Q_OBJECT
+
+public:
+    FakeReply(QNetworkAccessManager::Operation operation, const QNetworkRequest& request,
+              const QByteArray& body, QObject* parent,
+              QNetworkReply::NetworkError failure = QNetworkReply::NoError)
+        : QNetworkReply(parent)
+        , m_body(body)
+        , m_offset(0)
+    {
+        setRequest(request);
+        setUrl(request.url());
+        setOperation(operation);
+        setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 200);
+        open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+        QTimer::singleShot(0, this, [this, failure]() {
+            if (failure != QNetworkReply::NoError) {
+                setError(failure, QStringLiteral("simulated failure"));
+                emit errorOccurred(failure);
+            } else {
+                emit readyRead();
+            }
+            setFinished(true);
+            emit finished();
+        });
+    }
+
+    void abort() override {}
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override {
+        return m_body.size() - m_offset + QIODevice::bytesAvailable();
+    }
+
+protected:
+    qint64 readData(char* data, qint64 maxSize) override {
+        qint64 count = qMin(maxSize, qint64(m_body.size()) - m_offset);
+        if (count <= 0) return -1;
+        std::memcpy(data, m_body.constData() + m_offset, size_t(count));
+        m_offset += count;
+        return count;
+    }
+
+private:
+    QByteArray m_body;
+    qint64 m_offset;
+};
+
+/**
+ * Gestionnaire réseau qui compte les requêtes au lieu de les envoyer
+ */
+class CountingNetworkManager : public QNetworkAccessManager
+{
+    Q_OBJECT
+
+public:
+    using QNetworkAccessManager::QNetworkAccessManager;
+
+    int requestCount = 0;
+    QList<QUrl> requestedUrls;
+    bool failRequests = false;      // Réponses en erreur réseau
+    bool invalidBodies = false;     // Réponses reçues mais illisibles (JSON invalide)
+
+    static QByteArray weatherJson() {
+        return R"({"cod": 200, "id": 2988507, "name": "Paris", "dt": 1700000000,
+                   "sys": {"country": "FR"}, "coord": {"lat": 48.85, "lon": 2.35},
+                   "main": {"temp": 21.5, "feels_like": 20.9, "temp_min": 19.0, "temp_max": 23.0,
+                            "humidity": 55, "pressure": 1015},
+                   "weather": [{"id": 800, "main": "Clear", "description": "ciel dégagé", "icon": "01d"}],
+                   "wind": {"speed": 3.1, "deg": 200}, "clouds": {"all": 0}, "visibility": 10000})";
+    }
+
+    static QByteArray forecastJson() {
+        QByteArray list;
+        for (int i = 0; i < 40; ++i) {
+            if (i > 0) list += ",";
+            list += QString(R"({"dt": %1, "dt_txt": "%2",
+                               "main": {"temp": %3, "feels_like": 15.0, "humidity": 60, "pressure": 1012},
+                               "weather": [{"id": 500, "main": "Rain", "description": "pluie", "icon": "10d"}],
+                               "wind": {"speed": 4.0, "deg": 180}, "clouds": {"all": 75}, "pop": 0.4})")
+                        .arg(1700000000 + i * 10800)
+                        .arg(QDateTime::fromSecsSinceEpoch(1700000000 + i * 10800).toUTC()
+                                 .toString("yyyy-MM-dd hh:mm:ss"))
+                        .arg(15.0 + i % 8)
+                        .toUtf8();
+        }
+        return R"({"cod": "200", "city": {"id": 2988507, "name": "Paris", "country": "FR",
+                   "coord": {"lat": 48.85, "lon": 2.35}, "timezone": 3600}, "list": [)" + list + "]}";
+    }
+
+protected:
+    QNetworkReply* createRequest(Operation operation, const QNetworkRequest& request,
+                                 QIODevice* outgoingData) override {
+        Q_UNUSED(outgoingData);
+        ++requestCount;
+        requestedUrls.append(request.url());
+        const bool isForecast = request.url().path().endsWith("/forecast");
+        const QByteArray body = invalidBodies ? QByteArray("<html>502 Bad Gateway</html>")
+                                              : isForecast ? forecastJson() : weatherJson();
+        return new FakeReply(operation, request, body, this,
+                             failRequests ? QNetworkReply::HostNotFoundError : QNetworkReply::NoError);
+    }
+};
+
+class TestWeatherService : public QObject
+{
+    Q_OBJECT
+
+private:
+    WeatherService* m_service;
+    CountingNetworkManager* m_network;
+
+    // Gazetteer généré depuis une liste réduite au format city.list.json
+    static QString buildGazetteer(const QTemporaryDir& dir) {
+        QFile list(dir.filePath("city.list.json"));
+        if (!list.open(QIODevice::WriteOnly)) return QString();
+        list.write(R"([
+            {"id": 2988507, "name": "Paris", "country": "FR", "coord": {"lon": 2.3488, "lat": 48.85341}},
+            {"id": 4717560, "name": "Paris", "country": "US", "coord": {"lon": -95.55551, "lat": 33.66094}},
+            {"id": 2980291, "name": "Saint-Étienne", "country": "FR", "coord": {"lon": 4.39, "lat": 45.43389}},
+            {"id": 2996944, "name": "Lyon", "country": "FR", "coord": {"lon": 4.84671, "lat": 45.74846}},
+            {"id": 0, "name": "Sans identifiant", "country": "FR", "coord": {"lon": 0, "lat": 0}}
+        ])");
+        list.close();
+
+        const QString path = dir.filePath("cities.gaz");
+        return CityGazetteer::build(list.fileName(), path) ? path : QString();
+    }
+
+private slots:
+    void initTestCase() {
+        // Historique des tests du préchargement hors du profil utilisateur
+        QStandardPaths::setTestModeEnabled(true);
+    }
+
+    void init() {
+        m_network = new CountingNetworkManager();
+        m_service = new WeatherService(std::make_unique<weathercachemanager>());
+        m_service->setApiKey("0123456789abcdef0123456789abcdef");
+        m_service->setNetworkAccessManager(m_network);
+    }
+
+    void cleanup() {
+        delete m_service;
+        m_service = nullptr;
+        delete m_network;
+        m_network = nullptr;
+    }
+
+    // ========================================
+    // TESTS DU CHEMIN CACHE
+    // ========================================
+
+    void testWeatherHitAvoidsNetwork() {
+        // ARRANGE
+        QSignalSpy ready(m_service, &WeatherService::currentWeatherReady);
+        m_service->requestCurrentWeather("Paris");
+        QVERIFY(ready.wait());
+        QCOMPARE(m_network->requestCount, 1);
+
+        // ACT
+        QSignalSpy hits(m_service, &WeatherService::cacheHit);
+        m_service->requestCurrentWeather("Paris");
+
+        // ASSERT : servi immédiatement par le cache, avec les vraies données
+        QCOMPARE(m_network->requestCount, 1);
+        QCOMPARE(hits.count(), 1);
+        QCOMPARE(ready.count(), 2);
+        CurrentWeatherPtr fromNetwork = ready.at(0).at(1).value<CurrentWeatherPtr>();
+        CurrentWeatherPtr fromCache = ready.at(1).at(1).value<CurrentWeatherPtr>();
+        QVERIFY(fromCache);
+        QCOMPARE(fromCache->cityId, qint64(2988507));
+        QCOMPARE(fromCache->temperature, 21.5);
+        QCOMPARE(fromCache.get(), fromNetwork.get()); // même instance que celle émise à la réception
+    }
+
+    void testForecastHitAvoidsNetwork() {
+        // ARRANGE
+        QSignalSpy ready(m_service, &WeatherService::forecastReady);
+        m_service->requestForecast("Paris");
+        QVERIFY(ready.wait());
+        QCOMPARE(m_network->requestCount, 1);
+
+        // ACT
+        m_service->requestForecast("Paris");
+
+        // ASSERT
+        QCOMPARE(m_network->requestCount, 1);
+        QCOMPARE(ready.count(), 2);
+        ForecastPtr fromCache = ready.at(1).at(1).value<ForecastPtr>();
+        QVERIFY(fromCache);
+        QCOMPARE(fromCache->cityName, QString("Paris"));
+        QCOMPARE(fromCache->entries.size(), 40);
+    }
+
+    void testNameVariantsShareOneRequest() {
+        // ARRANGE
+        QSignalSpy ready(m_service, &WeatherService::currentWeatherReady);
+        m_service->requestCurrentWeather("Paris");
+        QVERIFY(ready.wait());
+
+        // ACT
+        m_service->requestCurrentWeather("  paris ");
+        m_service->requestCurrentWeather("PARIS");
+
+        // ASSERT
+        QCOMPARE(m_network->requestCount, 1);
+        QCOMPARE(ready.count(), 3);
+    }
+
+    void testDuplicateRequestWhilePending() {
+        // ACT : deux demandes avant la réponse
+        QSignalSpy ready(m_service, &WeatherService::currentWeatherReady);
+        m_service->requestCurrentWeather("Paris");
+        m_service->requestCurrentWeather("Paris");
+        QVERIFY(ready.wait());
+
+        // ASSERT
+        QCOMPARE(m_network->requestCount, 1);
+    }
+
+    void testRefreshBypassesCache() {
+        // ARRANGE
+        QSignalSpy ready(m_service, &WeatherService::currentWeatherReady);
+        m_service->requestCurrentWeather("Paris");
+        QVERIFY(ready.wait());
+
+        // ACT
+        m_service->refreshWeatherData("Paris");
+        QTRY_COMPARE(ready.count(), 2);
+
+        // ASSERT : météo + prévisions redemandées
+        QCOMPARE(m_network->requestCount, 3);
+    }
+
+    // ========================================
+    // TESTS DU GAZETTEER
+    // ========================================
+
+    void testGazetteerBuildAndLookup() {
+        // ARRANGE
+        QTemporaryDir dir;
+        const QString path = buildGazetteer(dir);
+        QVERIFY(!path.isEmpty());
+
+        // ACT
+        CityGazetteer gazetteer;
+        QVERIFY(gazetteer.open(path));
+
+        // ASSERT : entrée sans identifiant écartée ; accents et casse ignorés
+        QCOMPARE(gazetteer.size(), 4);
+        const QList<GazetteerCity> saintEtienne = gazetteer.lookup("  SAINT-ETIENNE ");
+        QCOMPARE(saintEtienne.size(), 1);
+        QCOMPARE(saintEtienne.first().cityId, qint64(2980291));
+        QCOMPARE(saintEtienne.first().name, QString("Saint-Étienne"));
+        QCOMPARE(gazetteer.lookup("paris").size(), 2);
+        QCOMPARE(gazetteer.lookup("paris", "us").first().cityId, qint64(4717560));
+        QVERIFY(gazetteer.lookup("Marseille").isEmpty());
+        QCOMPARE(gazetteer.names().size(), 4);
+        QVERIFY(gazetteer.names().contains("Saint-Étienne"));
+    }
+
+    void testGazetteerResolveHomonyms() {
+        // ARRANGE
+        QTemporaryDir dir;
+        CityGazetteer gazetteer;
+        QVERIFY(gazetteer.open(buildGazetteer(dir)));
+
+        // ACT & ASSERT : le pays saisi l'emporte sur le pays préféré
+        gazetteer.setPreferredCountry("us");
+        QCOMPARE(gazetteer.resolve("Paris").cityId, qint64(4717560));
+        QCOMPARE(gazetteer.resolve("Paris, fr").cityId, qint64(2988507));
+        QCOMPARE(gazetteer.resolve("Paris,FR").countryCode, QString("FR"));
+
+        gazetteer.setPreferredCountry("FR");
+        QCOMPARE(gazetteer.resolve("paris").cityId, qint64(2988507));
+        QVERIFY(!gazetteer.resolve("Paris,DE").isValid());
+    }
+
+    void testGazetteerRejectsInvalidFiles() {
+        // ARRANGE
+        QTemporaryDir dir;
+        QFile garbage(dir.filePath("garbage.gaz"));
+        QVERIFY(garbage.open(QIODevice::WriteOnly));
+        garbage.write(QByteArray(64, 'x'));
+        garbage.close();
+
+        QFile notAList(dir.filePath("city.list.json"));
+        QVERIFY(notAList.open(QIODevice::WriteOnly));
+        notAList.write(R"({"id": 2988507})");
+        notAList.close();
+
+        // ACT & ASSERT
+        CityGazetteer gazetteer;
+        QVERIFY(!gazetteer.open(garbage.fileName()));
+        QVERIFY(!gazetteer.isOpen());
+        QVERIFY(!gazetteer.open(dir.filePath("missing.gaz")));
+
+        QString error;
+        QVERIFY(!CityGazetteer::build(notAList.fileName(), dir.filePath("out.gaz"), &error));
+        QVERIFY(!error.isEmpty());
+        QVERIFY(!QFile::exists(dir.filePath("out.gaz")));
+    }
+
+    void testGazetteerRejectsRecordOutsideStrings() {
+        // ARRANGE : premier enregistrement pointant au-delà de la zone de chaînes
+        QTemporaryDir dir;
+        const QString path = buildGazetteer(dir);
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::ReadWrite));
+        QByteArray content = file.readAll();
+        const quint32 badOffset = quint32(content.size());
+        std::memcpy(content.data() + 16 + 8, &badOffset, sizeof(badOffset)); // Record::nameOffset
+        file.seek(0);
+        file.write(content);
+        file.close();
+
+        // ACT
+        CityGazetteer gazetteer;
+        const bool opened = gazetteer.open(path);
+
+        // ASSERT : fichier refusé plutôt que lu hors de la projection
+        QVERIFY(!opened);
+        QVERIFY(!gazetteer.isOpen());
+    }
+
+    void testKnownCityRequestedById() {
+        // ARRANGE
+        QTemporaryDir dir;
+        QVERIFY(m_service->loadGazetteer(buildGazetteer(dir)));
+
+        // ACT
+        m_service->requestCurrentWeather("paris, fr");
+
+        // ASSERT : identifiant résolu localement, aucun géocodage par nom
+        const QUrlQuery query(m_network->requestedUrls.last());
+        QCOMPARE(query.queryItemValue("id"), QString("2988507"));
+        QVERIFY(!query.hasQueryItem("q"));
+    }
+
+    void testUnknownCityRequestedByTrimmedInput() {
+        // ACT : pas de gazetteer, la saisie part telle quelle (sans espaces autour)
+        m_service->requestCurrentWeather("  Saint-Étienne ");
+
+        // ASSERT : accents et casse conservés, pas la clé normalisée
+        const QUrlQuery query(m_network->requestedUrls.last());
+        QCOMPARE(query.queryItemValue("q"), QString("Saint-Étienne"));
+        QVERIFY(!query.hasQueryItem("id"));
+    }
+
+    // ========================================
+    // TESTS DE PRIORITÉ DES VILLES VISIBLES
+    // ========================================
+
+    void testVisibleCityRefreshedFirstWhenBudgetTight() {
+        // ARRANGE : budget de 8/min, 4 déjà consommés (moitié atteinte, réserve de 2)
+        m_service->setMaxRequestsPerMinute(8);
+        for (const QString& city : {"Paris", "Lyon", "Lille", "Nantes"}) {
+            m_service->requestCurrentWeather(city);
+        }
+        m_service->setVisibleCities("dashboard", {"Nice"});
+        const int sentBefore = m_network->requestCount;
+
+        // ACT : deux échéances du planificateur, hors écran puis à l'écran
+        emit m_service->refreshScheduler()->refreshDue(CityKey("bordeaux"), WeatherDataType::Weather);
+        emit m_service->refreshScheduler()->refreshDue(CityKey("nice"), WeatherDataType::Weather);
+
+        // ASSERT : seule la ville visible part, l'autre attend du budget
+        QCOMPARE(m_network->requestCount, sentBefore + 1);
+        QCOMPARE(QUrlQuery(m_network->requestedUrls.last()).queryItemValue("q"), QString("Nice"));
+        QCOMPARE(m_service->queuedRequestCount(), 1);
+    }
+
+    void testOffscreenRefreshSentWithBudgetToSpare() {
+        // ARRANGE : budget intact
+        m_service->setVisibleCities("dashboard", {"Nice"});
+
+        // ACT
+        emit m_service->refreshScheduler()->refreshDue(CityKey("bordeaux"), WeatherDataType::Weather);
+
+        // ASSERT : aucune attente quand le budget le permet
+        QCOMPARE(m_network->requestCount, 1);
+        QCOMPARE(m_service->queuedRequestCount(), 0);
+    }
+
+    void testVisibleSetIsUnionOfViews() {
+        // ACT
+        m_service->setVisibleCities("dashboard", {"Nice", "Lyon"});
+        m_service->setVisibleCities("history", {"nice"});
+        m_service->setVisibleCities("dashboard", {});
+
+        // ASSERT : "Nice" reste visible par l'historique, "Lyon" ne l'est plus
+        QVERIFY(m_service->isCityVisible("NICE"));
+        QVERIFY(!m_service->isCityVisible("Lyon"));
+    }
+
+    // ========================================
+    // TESTS DU PLANIFICATEUR DE RAFRAÎCHISSEMENT
+    // ========================================
+
+    void testSchedulerDeadlineWithinJitterWindow() {
+        // ARRANGE : ville consultée, entrée valable 15 min
+        RefreshScheduler scheduler;
+        scheduler.setLeadTime(60);
+        scheduler.setJitter(45);
+        const CityKey key("Paris");
+        scheduler.markViewed(key);
+
+        CacheInfo info;
+        info.cachedAt = QDateTime::currentDateTime();
+        info.validityMinutes = 15;
+        const qint64 expiry = info.cachedAt.toMSecsSinceEpoch() + 15 * 60 * 1000;
+
+        // ACT & ASSERT : avance de 60s, plus 0 à 45s de gigue
+        qint64 earliest = std::numeric_limits<qint64>::max();
+        qint64 latest = 0;
+        for (int i = 0; i < 100; ++i) {
+            scheduler.scheduleRefresh(key, WeatherDataType::Weather, info);
+            const qint64 deadline = scheduler.nextRefresh(key, WeatherDataType::Weather);
+            QVERIFY(deadline >= expiry - (60 + 45) * 1000);
+            QVERIFY(deadline <= expiry - 60 * 1000);
+            earliest = qMin(earliest, deadline);
+            latest = qMax(latest, deadline);
+        }
+        QVERIFY(latest > earliest);              // échéances étalées
+        QCOMPARE(scheduler.pendingCount(), 1);   // reprogrammer remplace l'échéance
+    }
+
+    void testSchedulerIdleCityBacksOffThenUnwatched() {
+        // ARRANGE : ville jamais consultée, sans gigue
+        RefreshScheduler scheduler;
+        scheduler.setJitter(0);
+        scheduler.setMaxBackoffLevel(2);
+        const CityKey key("Lyon");
+        scheduler.watchCity(key);
+
+        CacheInfo info;
+        info.cachedAt = QDateTime::currentDateTime();
+        info.validityMinutes = 15;
+        const qint64 validityMs = 15 * 60 * 1000;
+        const qint64 expiry = info.cachedAt.toMSecsSinceEpoch() + validityMs;
+
+        // ACT & ASSERT : échéances espacées de 1 puis 3 validités après l'expiration
+        scheduler.scheduleRefresh(key, WeatherDataType::Forecast, info);
+        QCOMPARE(scheduler.nextRefresh(key, WeatherDataType::Forecast), expiry + validityMs);
+
+        scheduler.scheduleRefresh(key, WeatherDataType::Forecast, info);
+        QCOMPARE(scheduler.nextRefresh(key, WeatherDataType::Forecast), expiry + 3 * validityMs);
+
+        // Niveau maximal atteint : la ville n'est plus suivie
+        scheduler.scheduleRefresh(key, WeatherDataType::Forecast, info);
+        QVERIFY(!scheduler.isWatched(key));
+        QCOMPARE(scheduler.pendingCount(), 0);
+    }
+
+    void testSchedulerBackoffCountedPerDataType() {
+        // ARRANGE : ville délaissée, météo et prévisions mises en cache à chaque cycle
+        RefreshScheduler scheduler;
+        scheduler.setJitter(0);
+        scheduler.setMaxBackoffLevel(2);
+        const CityKey key("Lyon");
+        scheduler.watchCity(key);
+
+        CacheInfo info;
+        info.cachedAt = QDateTime::currentDateTime();
+        info.validityMinutes = 15;
+        const qint64 validityMs = 15 * 60 * 1000;
+        const qint64 expiry = info.cachedAt.toMSecsSinceEpoch() + validityMs;
+
+        // ACT : deux cycles complets (un rafraîchissement de chaque type par cycle)
+        for (int cycle = 0; cycle < 2; ++cycle) {
+            scheduler.scheduleRefresh(key, WeatherDataType::Weather, info);
+            scheduler.scheduleRefresh(key, WeatherDataType::Forecast, info);
+        }
+        const bool watchedAfterTwoCycles = scheduler.isWatched(key);
+        const qint64 forecastDeadline = scheduler.nextRefresh(key, WeatherDataType::Forecast);
+        scheduler.scheduleRefresh(key, WeatherDataType::Weather, info);
+
+        // ASSERT : chaque type au niveau 2 (3 validités), arrêt au cycle suivant seulement
+        QVERIFY(watchedAfterTwoCycles);
+        QCOMPARE(forecastDeadline, expiry + 3 * validityMs);
+        QVERIFY(!scheduler.isWatched(key));
+    }
+
+    void testSchedulerViewResetsBackoff() {
+        // ARRANGE : ville délaissée, une fois reculée
+        RefreshScheduler scheduler;
+        scheduler.setJitter(0);
+        const CityKey key("Lille");
+        scheduler.watchCity(key);
+
+        CacheInfo info;
+        info.cachedAt = QDateTime::currentDateTime();
+        info.validityMinutes = 15;
+        const qint64 expiry = info.cachedAt.toMSecsSinceEpoch() + 15 * 60 * 1000;
+        scheduler.scheduleRefresh(key, WeatherDataType::Weather, info);
+
+        // ACT
+        scheduler.markViewed(key);
+        scheduler.scheduleRefresh(key, WeatherDataType::Weather, info);
+
+        // ASSERT : de nouveau juste avant l'expiration
+        QCOMPARE(scheduler.nextRefresh(key, WeatherDataType::Weather), expiry - 60 * 1000);
+    }
+
+    void testRefreshPostponedWhenBudgetExhausted() {
+        // ARRANGE : budget de 8/min, 4 consommés → plus rien pour les villes hors écran
+        m_service->setMaxRequestsPerMinute(8);
+        m_service->setBackgroundMaxWait(1);
+        for (const QString& city : {"Paris", "Lyon", "Lille", "Nantes"}) {
+            m_service->requestCurrentWeather(city);
+        }
+        const int sentBefore = m_network->requestCount;
+        const CityKey paris = m_service->cityKey("Paris");
+        RefreshScheduler* scheduler = m_service->refreshScheduler();
+
+        // ACT : échéance des prévisions, mise en attente puis abandonnée
+        emit scheduler->refreshDue(paris, WeatherDataType::Forecast);
+        QCOMPARE(m_service->queuedRequestCount(), 1);
+        QTest::qWait(1100);     // Au-delà de l'attente maximale de 1 s
+        emit scheduler->refreshDue(paris, WeatherDataType::Forecast);
+
+        // ASSERT : aucun envoi, échéance reportée dans le planificateur
+        QCOMPARE(m_network->requestCount, sentBefore);
+        QCOMPARE(m_service->queuedRequestCount(), 0);
+        QVERIFY(scheduler->nextRefresh(paris, WeatherDataType::Forecast) > 0);
+    }
+
+    void testBackgroundParseFailureNotShownToUser() {
+        // ARRANGE : réponses reçues mais illisibles
+        m_network->invalidBodies = true;
+        QSignalSpy errors(m_service, &WeatherService::errorOccurred);
+        QSignalSpy failed(m_service, &WeatherService::backgroundRefreshFailed);
+        RefreshScheduler* scheduler = m_service->refreshScheduler();
+        const CityKey paris = m_service->cityKey("Paris");
+        scheduler->watchCity(paris);
+
+        // ACT : rafraîchissement planifié, puis recherche de l'utilisateur
+        emit scheduler->refreshDue(paris, WeatherDataType::Weather);
+        QTRY_COMPARE(failed.count(), 1);
+        const int errorsWhileIdle = errors.count();
+        m_service->requestCurrentWeather("Lyon");
+        QTRY_COMPARE(errors.count(), 1);
+
+        // ASSERT : silencieux et reporté en arrière-plan, affiché pour l'utilisateur
+        QCOMPARE(errorsWhileIdle, 0);
+        QCOMPARE(errors.first().at(2).toString(), QString("parsing"));
+        QVERIFY(scheduler->nextRefresh(paris, WeatherDataType::Weather) > 0);
+    }
+
+    // ========================================
+    // TESTS DU PRÉCHARGEMENT
+    // ========================================
+
+    void testPrefetchCandidatesOrder() {
+        // ARRANGE : un favori, deux villes recherchées à l'heure courante
+        SearchHistory history;
+        history.clearHistory();
+        history.addSearch("Paris");
+        for (int i = 0; i < 3; ++i) history.addSearch("Lyon");
+        history.addToFavorites("Nice");
+        history.addSearch("NICE");
+        WeatherPrefetcher prefetcher(m_service, &history);
+
+        // ACT
+        const QStringList all = prefetcher.selectCandidates();
+        prefetcher.setTopN(2);
+        const QStringList limited = prefetcher.selectCandidates();
+
+        // ASSERT : favoris, puis heure courante (par fréquence), sans doublon
+        QCOMPARE(all, QStringList({"Nice", "Lyon", "Paris"}));
+        QCOMPARE(limited, QStringList({"Nice", "Lyon"}));
+        history.clearHistory();
+    }
+
+    void testPrefetchHitAccounting() {
+        // ARRANGE
+        SearchHistory history;
+        history.clearHistory();
+        history.addToFavorites("Paris");
+        WeatherPrefetcher prefetcher(m_service, &history);
+        prefetcher.setSpacingMs(0);
+
+        // ACT : préchargement (météo + prévisions), puis deux consultations
+        prefetcher.prefetchNow();
+        QTRY_COMPARE(prefetcher.stats().completed, 2);
+        QSignalSpy ready(m_service, &WeatherService::currentWeatherReady);
+        m_service->requestCurrentWeather("paris");
+        m_service->requestCurrentWeather("Paris");
+
+        // ASSERT : un seul succès attribuable par entrée préchargée
+        QCOMPARE(m_network->requestCount, 2);
+        QCOMPARE(ready.count(), 2);
+        const PrefetchStats stats = prefetcher.stats();
+        QCOMPARE(stats.issued, 1);
+        QCOMPARE(stats.attributableHits, 1);
+        QCOMPARE(stats.hitRate(), 0.5);
+        history.clearHistory();
+    }
+
+    void testFailedPrefetchNotCountedLater() {
+        // ARRANGE : préchargement en erreur réseau
+        SearchHistory history;
+        history.clearHistory();
+        history.addToFavorites("Paris");
+        WeatherPrefetcher prefetcher(m_service, &history);
+        prefetcher.setSpacingMs(0);
+        QSignalSpy failed(m_service, &WeatherService::backgroundRefreshFailed);
+        m_network->failRequests = true;
+        prefetcher.prefetchNow();
+        QTRY_COMPARE(failed.count(), 2);
+
+        // ACT : rafraîchissement planifié réussi de la même ville
+        m_network->failRequests = false;
+        QSignalSpy completed(m_service, &WeatherService::backgroundRefreshCompleted);
+        emit m_service->refreshScheduler()->refreshDue(m_service->cityKey("Paris"), WeatherDataType::Weather);
+        QTRY_COMPARE(completed.count(), 1);
+
+        // ASSERT : non attribué au préchargement échoué
+        QCOMPARE(prefetcher.stats().issued, 1);
+        QCOMPARE(prefetcher.stats().completed, 0);
+        history.clearHistory();
+    }
+
+    void testPrefetchTracksOnlyIssuedTypes() {
+        // ARRANGE : météo déjà valide en cache, seules les prévisions manquent
+        SearchHistory history;
+        history.clearHistory();
+        history.addToFavorites("Paris");
+        QSignalSpy ready(m_service, &WeatherService::currentWeatherReady);
+        m_service->requestCurrentWeather("Paris");
+        QVERIFY(ready.wait());
+        WeatherPrefetcher prefetcher(m_service, &history);
+        prefetcher.setSpacingMs(0);
+        prefetcher.prefetchNow();
+        QTRY_COMPARE(prefetcher.stats().completed, 1);
+
+        // ACT : rafraîchissement planifié de la météo, jamais préchargée
+        QSignalSpy completed(m_service, &WeatherService::backgroundRefreshCompleted);
+        emit m_service->refreshScheduler()->refreshDue(m_service->cityKey("Paris"), WeatherDataType::Weather);
+        QTRY_COMPARE(completed.count(), 1);
+
+        // ASSERT : une seule requête de préchargement (prévisions), la météo n'est pas comptée
+        QCOMPARE(m_network->requestCount, 3);
+        QCOMPARE(completed.first().at(1).toString(), QString("weather"));
+        QCOMPARE(prefetcher.stats().issued, 1);
+        QCOMPARE(prefetcher.stats().completed, 1);
+        history.clearHistory();
+    }
+
+    // ========================================
+    // TESTS DES RÉSUMÉS QUOTIDIENS
+    // ========================================
+
+    void testDailySummariesCachedWithForecast() {
+        // ARRANGE : premier créneau 2023-11-14 22:13 UTC, soit 23:13 à Paris (UTC+1)
+        QSignalSpy ready(m_service, &WeatherService::forecastReady);
+        m_service->requestForecast("Paris");
+        QVERIFY(ready.wait());
+
+        // ACT
+        ForecastPtr forecast = ready.at(0).at(1).value<ForecastPtr>();
+
+        // ASSERT : calculés au parsing, jour partiel puis jours complets
+        QVERIFY(forecast);
+        const QList<ForecastData::DailySummary>& days = forecast->dailySummaries;
+        QCOMPARE(days.size(), 6);
+        QCOMPARE(days.first().date, QDate(2023, 11, 14));
+        QCOMPARE(days.first().count, 1);
+        QCOMPARE(days.at(1).date, QDate(2023, 11, 15));
+        QCOMPARE(days.at(1).firstIndex, 1);
+        QCOMPARE(days.at(1).count, 8);
+        QCOMPARE(days.at(1).minTemp, 15.0);
+        QCOMPARE(days.at(1).maxTemp, 22.0);
+        QCOMPARE(days.at(1).meanTemp, 18.5);
+        QCOMPARE(days.at(1).maxPrecipitationProbability, 40.0);
+        QCOMPARE(days.at(1).dominantCondition, QString("Rain"));
+
+        int total = 0;
+        for (const ForecastData::DailySummary& day : days) total += day.count;
+        QCOMPARE(total, 40);
+    }
+
+    void testDailySummariesFollowCityTimezone() {
+        // ARRANGE : même réponse pour une ville à UTC-5
+        QJsonObject json = QJsonDocument::fromJson(CountingNetworkManager::forecastJson()).object();
+        QJsonObject city = json["city"].toObject();
+        city["timezone"] = -5 * 3600;
+        json["city"] = city;
+
+        // ACT
+        ForecastData data = WeatherJsonParser::parseForecast(json);
+
+        // ASSERT : 17:13, 20:13, 23:13 le 14 → premier jour de 3 créneaux
+        QCOMPARE(data.dailySummaries.first().date, QDate(2023, 11, 14));
+        QCOMPARE(data.dailySummaries.first().count, 3);
+        QCOMPARE(data.getEntriesForDay(1).size(), 8);
+    }
+
+    void testClearCacheForcesNetwork() {
+        // ARRANGE
+        QSignalSpy ready(m_service, &WeatherService::currentWeatherReady);
+        m_service->requestCurrentWeather("Paris");
+        QVERIFY(ready.wait());
+
+        // ACT
+        QSignalSpy cleared(m_service, &WeatherService::cacheCleanedUp);
+        m_service->clearCache();
+        m_service->requestCurrentWeather("Paris");
+        QVERIFY(ready.wait());
+
+        // ASSERT
+        QCOMPARE(cleared.count(), 1);
+        QCOMPARE(cleared.at(0).at(0).toInt(), 1);
+        QCOMPARE(m_network->requestCount, 2);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestWeatherService)
+#include "tst_weatherservice.moc"
@@ -0,0 +1,57 @@
+# tests/weatherservice/weatherservice.pro
+QT += testlib core network
+QT -= gui
+
+CONFIG += qt console warn_on depend_includepath testcase
+CONFIG -= app_bundle
+CONFIG += c++17
+
+TEMPLATE = app
+TARGET = tst_weatherservice
+
+# Chemin vers le code source
+INCLUDEPATH += ../../src
+
+# Fichier de test principal
+SOURCES += \
+    tst_weatherservice.cpp
+
+# Code source à tester (service, préchargement + dépendances directes, sans interface graphique)
+SOURCES += \
+    ../../src/weatherservice.cpp \
+    ../../src/cityspatialindex.cpp \
+    ../../src/weathercachemanager.cpp \
+    ../../src/refreshscheduler.cpp \
+    ../../src/weatherprefetcher.cpp \
+    ../../src/searchhistory.cpp \
+    ../../src/citytrie.cpp \
+    ../../src/historyjournal.cpp \
+    ../../src/citygazetteer.cpp \
+    ../../src/weatherjsonparser.cpp \
+    ../../src/parsearena.cpp \
+    ../../src/derivedmetrics.cpp
+
+HEADERS += \
+    ../../src/WeatherService.h \
+    ../../src/cityspatialindex.h \
+    ../../src/weathercachemanager.h \
+    ../../src/refreshscheduler.h \
+    ../../src/weatherprefetcher.h \
+    ../../src/SearchHistory.h \
+    ../../src/citytrie.h \
+    ../../src/historyjournal.h \
+    ../../src/citygazetteer.h \
+    ../../src/citykey.h \
+    ../../src/derivedmetrics.h \
+    ../../src/inlinelist.h \
+    ../../src/parsearena.h \
+    ../../src/weatherjsonparser.h \
+    ../../src/ICacheManager.h \
+    ../../src/WeatherData.h \
+    ../../src/weathererrors.h
+
+# Définir les mêmes deprecated warnings
+DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000
+
+# Sortie dans un dossier séparé
+DESTDIR = $$OUT_PWD/bin